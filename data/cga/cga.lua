@@ -114,78 +114,10 @@ end
 
 
 
--- WALL
-local draw_wall
-local wall_left_coord
-local wall_right_coord
-local draw_wall_base
-local draw_wall_left
-local draw_wall_right
-local draw_wall_top
-local wall_top_coord
-
-function wall_base_coord (p)
-   return coord (PLACE_WIDTH * p.place, PLACE_HEIGHT * (p.floor + 1))
-end
-
-function wall_left_coord (p)
-   return coord (PLACE_WIDTH * p.place, PLACE_HEIGHT * p.floor + 3)
-end
-
-function wall_right_coord (p)
-   return coord (PLACE_WIDTH * (p.place + 1),
-                 PLACE_HEIGHT * p.floor + 3)
-end
-
-function wall_top_coord (p)
-   return coord (PLACE_WIDTH * (p.place + 1),
-                 PLACE_HEIGHT * p.floor - 10)
-end
-
-function draw_wall (part, p, w)
-   local t
-      = {BASE = draw_wall_base,
-         LEFT = draw_wall_left,
-         RIGHT = draw_wall_right,
-         TOP = draw_wall_top}
-   t[part] (p, w)
-end
-
-function draw_wall_base (p)
-   local em = M.video.env_mode
-   draw (asset[em].wall_base, wall_base_coord, p)
-end
-
-function draw_wall_left (p)
-   local em = M.video.env_mode
-   draw (asset[em].wall_left, wall_left_coord, p)
-end
-
-function draw_wall_right (p, w)
-   local em = M.video.env_mode
-   local wc = p.wall_correlation
-   if wc == "SWS" or wc == "WWS" then
-      draw (asset[em].wall_right, wall_right_coord, p, 0, 0, w)
-   end
-end
-
-function draw_wall_top (p, w)
-   local em = M.video.env_mode
-   local wc = p.wall_correlation
-   if wc == "SWS" or wc == "WWS" then
-      draw (asset[em].wall_top, wall_top_coord, p, 0, 0, w)
-   end
-end
-
-
-
-
 -- CGA video mode interface
 function M.video.CGA (...)
    if arg[1] == "DRAW" then
-      if arg[2] == "TORCH" then draw_torch (arg[3])
-      elseif arg[2] == "WALL" then draw_wall (arg[3], arg[4], arg[5])
-      end
+      if arg[2] == "TORCH" then draw_torch (arg[3]) end
    end
 end
 
@@ -216,6 +148,29 @@ function load ()
    asset.PALACE.wall_right = load_bitmap ("wall/palace/right.png")
    asset.PALACE.wall_top = load_bitmap ("wall/palace/top.png")
 
+   -- walls are drawn natively from these tables
+   local function wall_table (em)
+      local a = asset[em]
+      return {base = a.wall_base,
+              left = a.wall_left,
+              right = a.wall_right,
+              top = a.wall_top,
+              top_offset = -10}
+   end
+
+   M.video.register_draw_table (
+      "CGA", "WALL",
+      {selection = cga_selection_palette,
+       DUNGEON = wall_table ("DUNGEON"),
+       PALACE = wall_table ("PALACE")})
+
+   M.video.register_draw_table (
+      "HGC", "WALL",
+      {palette = hgc_palette,
+       selection = hgc_selection,
+       DUNGEON = wall_table ("DUNGEON"),
+       PALACE = wall_table ("PALACE")})
+
    return P
 end
 
@@ -24,15 +24,11 @@ local P = {package_type = "VIDEO MODE", package_name = "EGA",
 
 -- imports
 local M = mininim
-local mod = M.math.mod
-local rshift = M.math.rshift
-local uint32 = M.math.uint32
 local color = M.video.color
 local coord = M.video.coordinate
 local common = require "script/common"
 local to_color_range = common.to_color_range
 local _debug = _debug
-local os = os
 
 
 
@@ -45,7 +41,6 @@ setfenv (1, P)
 
 local PLACE_WIDTH = 32
 local PLACE_HEIGHT = 63
-local PLACES = 10
 
 local asset = {}
 
@@ -77,35 +72,6 @@ end
 
 
 
--- RNG
-local random_seed = 0
-local random_seedb = 0
-local prandom
-local seedp
-local unseedp
-
-function prandom (max)
-   if random_seed == 0 then random_seed = os.time () end
-   random_seed = uint32 (random_seed * 214013 + 2531011);
-   if random_seed == 0 then random_seed = 1 end
-   local r = mod (rshift (random_seed, 16), max + 1)
-   return r
-end
-
-function seedp (p)
-   np = p.normal
-   random_seedb = random_seed
-   random_seed = mod (np.room + np.floor * PLACES + np.place, 2 ^ 32)
-   if random_seed == 0 then random_seed = 1 end
-end
-
-function unseedp ()
-   random_seed = random_seedb
-end
-
-
-
-
 -- TORCH
 local draw_torch
 local torch_coord
@@ -121,232 +87,10 @@ end
 
 
 
--- WALL
-local draw_wall, wall_left_coord, wall_right_coord
-
-local draw_wall_base
-local draw_wall_left
-local draw_wall_right
-local draw_wall_top
-local wall_top_coord
-local draw_wall_base_randomization
-local draw_wall_left_randomization
-local draw_left_mark
-local draw_right_mark
-local draw_random_block
-local wall_divider_00_coord
-local draw_divider_00
-local wall_divider_01_coord
-local draw_divider_01
-local wall_divider_00, wall_divider_01
-local r0, r1, r2, r3
-
-function wall_left_coord (p)
-   return coord (PLACE_WIDTH * p.place, PLACE_HEIGHT * p.floor + 3)
-end
-
-function wall_base_coord (p)
-   return coord (PLACE_WIDTH * p.place, PLACE_HEIGHT * (p.floor + 1))
-end
-
-function wall_right_coord (p)
-   return coord (PLACE_WIDTH * (p.place + 1),
-                 PLACE_HEIGHT * p.floor + 3)
-end
-
-function draw_wall (part, p, w)
-   local t
-      = {BASE = draw_wall_base,
-         LEFT = draw_wall_left,
-         RIGHT = draw_wall_right,
-         TOP = draw_wall_top}
-   t[part] (p, w)
-end
-
-function draw_wall_right (p, w)
-   local em = M.video.env_mode
-   local wc = p.wall_correlation
-   if wc == "SWS" or wc == "WWS" then
-      draw (asset[em].wall_right, wall_right_coord, p, 0, 0, w)
-   end
-end
-
-function wall_top_coord (p)
-   return coord (PLACE_WIDTH * (p.place + 1),
-                 PLACE_HEIGHT * p.floor - 10)
-end
-
-function draw_wall_top (p, w)
-   local em = M.video.env_mode
-   local wc = p.wall_correlation
-   if wc == "SWS" or wc == "WWS" then
-      draw (asset[em].wall_top, wall_top_coord, p, 0, 0, w)
-   end
-end
-
-function draw_wall_base (p)
-   local em = M.video.env_mode
-   local t = {SWS = asset[em].wall_base_sws,
-              SWW = asset[em].wall_base_sww,
-              WWS = asset[em].wall_base_wws,
-              WWW = asset[em].wall_base_www}
-   local b = t[p.wall_correlation]
-   draw (b, wall_base_coord, p)
-   draw_wall_base_randomization (p)
-end
-
-function draw_wall_left (p)
-   local em = M.video.env_mode
-   local t = {SWS = asset[em].wall_left_sws,
-              SWW = asset[em].wall_left_sww,
-              WWS = asset[em].wall_left_wws,
-              WWW = asset[em].wall_left_www}
-   local b = t[p.wall_correlation]
-   draw (b, wall_left_coord, p)
-   draw_wall_left_randomization (p)
-end
-
-function draw_random_block (p)
-   local em = M.video.env_mode
-   draw (asset[em].wall_random_block, wall_left_coord, p)
-end
-
-function wall_divider_00_coord (p)
-   return coord (PLACE_WIDTH * p.place + r3,
-                 PLACE_HEIGHT * p.floor + 45)
-end
-
-function draw_divider_00 (p)
-   draw (wall_divider_00, wall_divider_00_coord, p)
-end
-
-function wall_divider_01_coord (p)
-   return coord (PLACE_WIDTH * p.place + 8 + r1,
-                 PLACE_HEIGHT * p.floor + 24)
-end
-
-function draw_divider_01 (p)
-   draw (wall_divider_01, wall_divider_01_coord, p)
-end
-
-function draw_left_mark (p, r)
-   local wall_mark = asset.DUNGEON.wall_mark_top_left
-   local floor_offset = {58, 41, 37, 20, 16}
-   local place_offset = 0
-
-   if mod (r, 2) ~= 0 then
-      wall_mark = asset.DUNGEON.wall_mark_bottom_left end
-   if r > 3 then place_offset = r3 - r2 + 6
-   elseif r > 1 then place_offset = r1 - r0 + 6 end
-
-   local function wall_mark_left_coord (p)
-      return coord (PLACE_WIDTH * p.place + place_offset
-                       + 8 * (((r == 2) or (r == 3)) and 1 or 0),
-                    PLACE_HEIGHT * p.floor + 61 - floor_offset[r + 1])
-   end
-
-   draw (wall_mark, wall_mark_left_coord, p)
-end
-
-function draw_right_mark (p, r)
-   local floor_offset, wall_mark = {52, 42, 31, 21}
-
-   if mod (r, 2) == 0 then wall_mark = asset.DUNGEON.wall_mark_top_right
-   else wall_mark = asset.DUNGEON.wall_mark_bottom_right end
-
-   local function wall_mark_right_coord (p)
-      return coord (PLACE_WIDTH * p.place + 8 * ((r > 1) and 1 or 0)
-                       + ((r < 2) and 24 or r1 - 3),
-                    PLACE_HEIGHT * p.floor + 56 - floor_offset[r + 1])
-   end
-
-   draw (wall_mark, wall_mark_right_coord, p)
-end
-
-function draw_wall_base_randomization (p)
-   local em = M.video.env_mode
-   local wall_narrow_divider = asset[em].wall_narrow_divider
-   local wall_wide_divider = asset[em].wall_wide_divider
-
-   seedp (p)
-   prandom (1)
-   r0 = prandom (1)
-   r1 = prandom (4)
-   r2 = prandom (1)
-   r3 = prandom (4)
-
-   if r2 == 0 then wall_divider_00 = wall_wide_divider
-   else wall_divider_00 = wall_narrow_divider end
-
-   if r0 == 0 then wall_divider_01 = wall_wide_divider
-   else wall_divider_01 = wall_narrow_divider end
-
-   local wc = p.wall_correlation
-   if wc == "WWW" then draw_divider_00 (p)
-   elseif wc == "WWS" then draw_divider_00 (p) end
-
-   unseedp ()
-end
-
-function draw_wall_left_randomization (p)
-   local em = M.video.env_mode
-   local wall_narrow_divider = asset[em].wall_narrow_divider
-   local wall_wide_divider = asset[em].wall_wide_divider
-
-   seedp (p)
-   prandom (1)
-   r0 = prandom (1)
-   r1 = prandom (4)
-   r2 = prandom (1)
-   r3 = prandom (4)
-
-   if r2 == 0 then wall_divider_00 = wall_wide_divider
-   else wall_divider_00 = wall_narrow_divider end
-
-   if r0 == 0 then wall_divider_01 = wall_wide_divider
-   else wall_divider_01 = wall_narrow_divider end
-
-   local wc = p.wall_correlation
-   if wc == "WWW" then
-      if prandom (4) == 0 then draw_random_block (p) end
-      draw_divider_01 (p)
-      draw_divider_00 (p)
-      if em == "DUNGEON" then
-         if prandom (4) == 0 then draw_right_mark (p, prandom (3)) end
-         if prandom (4) == 0 then draw_left_mark (p, prandom (4)) end
-      end
-   elseif wc == "SWS" then
-      if em == "DUNGEON" and prandom (6) == 0 then
-         draw_left_mark (p, prandom (1)) end
-   elseif wc == "SWW" then
-      if prandom (4) == 0 then draw_random_block (p) end
-      draw_divider_01 (p)
-      if em == "DUNGEON" then
-         if prandom (4) == 0 then draw_right_mark (p, prandom (3)) end
-         if prandom (4) == 0 then draw_left_mark (p, prandom (3)) end
-      end
-   elseif wc == "WWS" then
-      draw_divider_01 (p)
-      draw_divider_00 (p)
-      if em == "DUNGEON" then
-         if prandom (4) == 0 then draw_right_mark (p, prandom (1) + 2) end
-         if prandom (4) == 0 then draw_left_mark (p, prandom (4)) end
-      end
-   end
-
-   unseedp ()
-end
-
-
-
-
-
 -- EGA video mode interface
 function M.video.EGA (...)
    if arg[1] == "DRAW" then
-      if arg[2] == "TORCH" then draw_torch (arg[3])
-      elseif arg[2] == "WALL" then draw_wall (arg[3], arg[4], arg[5])
-      end
+      if arg[2] == "TORCH" then draw_torch (arg[3]) end
    end
 end
 
@@ -418,6 +162,31 @@ function load ()
    asset.PALACE.wall_top =
       load_bitmap ("wall/palace/top.png")
 
+   -- walls are drawn natively from this table
+   local function wall_table (em)
+      local a = asset[em]
+      return {base = {SWS = a.wall_base_sws, SWW = a.wall_base_sww,
+                      WWS = a.wall_base_wws, WWW = a.wall_base_www},
+              left = {SWS = a.wall_left_sws, SWW = a.wall_left_sww,
+                      WWS = a.wall_left_wws, WWW = a.wall_left_www},
+              right = a.wall_right,
+              top = a.wall_top,
+              top_offset = -10,
+              narrow_divider = a.wall_narrow_divider,
+              wide_divider = a.wall_wide_divider,
+              random_block = a.wall_random_block,
+              mark_top_left = a.wall_mark_top_left,
+              mark_bottom_left = a.wall_mark_bottom_left,
+              mark_top_right = a.wall_mark_top_right,
+              mark_bottom_right = a.wall_mark_bottom_right}
+   end
+
+   M.video.register_draw_table (
+      "EGA", "WALL",
+      {selection = selection_palette,
+       DUNGEON = wall_table ("DUNGEON"),
+       PALACE = wall_table ("PALACE")})
+
    return P
 end
 
@@ -25,24 +25,44 @@ enum quit_anim quit_anim;
 bool pause_anim;
 bool cutscene;
 bool next_frame_inv;
-uint64_t anim_cycle;
 ALLEGRO_TIMER *timer;
 int anim_freq = DEFAULT_HZ;
 int anim_freq_real;
+bool headless;
 
 ALLEGRO_EVENT_QUEUE *event_queue;
 
-struct anim *anima;
-size_t anima_nmemb;
+/* indexes into ANIMA of the actors visible from each room R, in
+   drawing order, are ROOM_ANIM[ROOM_ANIM_INDEX[R]] up to (but not
+   including) ROOM_ANIM[ROOM_ANIM_INDEX[R + 1]], as of the last call
+   to 'bucket_anims' */
+static struct room_anim {
+  int room;
+  size_t i;
+} *room_anim_pair;
+static size_t *room_anim;
+static size_t room_anim_capacity;
+static size_t room_anim_index[ROOMS + 1];
+
+static void detect_incomplete_replay (void);
+static void finish_replay_anim (void);
+static void record_replay_playback (double seconds);
+static void play_anim_headless (void (*compute_callback) (void),
+                                void (*cleanup_callback) (void));
 
 void
 play_anim (void (*draw_callback) (void),
            void (*compute_callback) (void),
            void (*cleanup_callback) (void))
 {
-  anim_cycle = 0;
+  engine->anim_cycle = 0;
   quit_anim = NO_QUIT;
 
+  if (is_headless ()) {
+    play_anim_headless (compute_callback, cleanup_callback);
+    return;
+  }
+
   al_acknowledge_resize (display);
 
   ALLEGRO_EVENT event;
@@ -54,17 +74,22 @@ play_anim (void (*draw_callback) (void),
   al_start_timer (timer);
 
   double prev_time = al_get_time ();
+  double wait_time = 0;
 
   reset_haptic ();
 
   key.keycode = 0;
   joystick_button = -1;
 
+  double start_time = al_get_time ();
+
   while (! quit_anim) {
     L_gc (main_L);
+    double wait_start_time = al_get_time ();
     unlock_thread ();
     al_wait_for_event (event_queue, &event);
     lock_thread ();
+    wait_time += al_get_time () - wait_start_time;
 
     switch (event.type) {
     case ALLEGRO_EVENT_TIMER:
@@ -80,25 +105,15 @@ play_anim (void (*draw_callback) (void),
 
         /* check for replay favorite cycle */
         if (replay_favorite_cycle > 0
-            && anim_cycle == replay_favorite_cycle) {
+            && engine->anim_cycle == replay_favorite_cycle) {
           replay_favorite_cycle = 0;
           change_anim_freq (DEFAULT_HZ);
           pause_game (true);
           ui_msg (2, "REPLAY FAVORITE REACHED");
         }
 
-        struct replay *replay = get_replay ();
-
         /* detect incomplete replays */
-        struct anim *k;
-        if (! title_demo
-            && replay_mode == PLAY_REPLAY
-            && (anim_cycle >= replay->packed_gamepad_state_nmemb
-                + REPLAY_STUCK_THRESHOLD
-                || ((k = get_anim_by_id (current_kid_id))
-                    && k->current_lives <= 0
-                    && death_timer >= SEC2CYC (8))))
-          quit_anim = REPLAY_INCOMPLETE;
+        detect_incomplete_replay ();
 
         /* /\* ---- *\/ */
         /* while (anim_cycle == 1039) { */
@@ -108,8 +123,12 @@ play_anim (void (*draw_callback) (void),
         /* /\* ---- *\/ */
 
         /* compute actual time frequency */
-        anim_freq_real = 1.0 / (al_get_time () - prev_time);
-        prev_time = al_get_time ();
+        double now = al_get_time ();
+        anim_freq_real = 1.0 / (now - prev_time);
+        record_telemetry (FRAME_TELEMETRY, now - prev_time);
+        record_telemetry (WAIT_TELEMETRY, wait_time);
+        prev_time = now;
+        wait_time = 0;
 
         /* replay handler */
         start_recording_replay (2);
@@ -137,21 +156,33 @@ play_anim (void (*draw_callback) (void),
 
         kid_debug ();
 
-        if (anim_cycle > 0 && ! is_video_effect_started ()
+        if (engine->anim_cycle > 0 && ! is_video_effect_started ()
             && (rendering == BOTH_RENDERING
                 || rendering == VIDEO_RENDERING
-                || update_replay_progress (NULL)))
+                || update_replay_progress (NULL))) {
+          double flip_start_time = al_get_time ();
           show ();
+          record_telemetry (FLIP_TELEMETRY, al_get_time () - flip_start_time);
+        }
 
         if (! pause_anim) {
-          if (compute_callback) compute_callback ();
+          record_replay_keyframe ();
+          double compute_start_time = al_get_time ();
+          if (compute_callback) {
+            compute_callback ();
+            update_state_hash ();
+          }
+          double draw_start_time = al_get_time ();
+          record_telemetry (COMPUTE_TELEMETRY,
+                            draw_start_time - compute_start_time);
           clear_bitmap (uscreen, TRANSPARENT_COLOR);
           uint32_t random_seed_before_draw;
           if (replay_mode != NO_REPLAY)
-            random_seed_before_draw = random_seed;
+            random_seed_before_draw = engine->random_seed;
           draw_callback ();
           if (replay_mode != NO_REPLAY)
-            random_seed = random_seed_before_draw;
+            engine->random_seed = random_seed_before_draw;
+          record_telemetry (DRAW_TELEMETRY, al_get_time () - draw_start_time);
           play_audio_instances ();
           if (! title_demo && replay_mode != PLAY_REPLAY)
             execute_haptic ();
@@ -159,7 +190,7 @@ play_anim (void (*draw_callback) (void),
           if (cleanup_callback) cleanup_callback ();
 
           if (! is_game_paused ())
-            anim_cycle++;
+            engine->anim_cycle++;
 
           if (! title_demo
               && replay_mode == PLAY_REPLAY
@@ -174,6 +205,7 @@ play_anim (void (*draw_callback) (void),
           if (! cutscene) editor ();
           if (bottom_text_timer) bottom_text_timer++;
           draw_bottom_text (uscreen, NULL, 0);
+          draw_telemetry_overlay (uscreen);
         }
         drop_all_events_from_source
           (event_queue, al_get_timer_event_source (timer));
@@ -240,7 +272,7 @@ play_anim (void (*draw_callback) (void),
       case 1: ui_editor (); break;
       case 3:
         if (edit != EDIT_NONE)
-          ui_place_kid (get_anim_by_id (current_kid_id), &mouse_pos);
+          ui_place_kid (get_anim_by_id (engine->current_kid_id), &mouse_pos);
         break;
       default: break;
       }
@@ -310,6 +342,8 @@ play_anim (void (*draw_callback) (void),
     }
   }
 
+  record_replay_playback (al_get_time () - start_time);
+
   if (replay_mode == NO_REPLAY && recording_replay_countdown >= 0) {
     main_menu_enabled = false;
     main_menu ();
@@ -332,24 +366,99 @@ play_anim (void (*draw_callback) (void),
     handle_save_replay_thread (1);
   }
 
-  if (! title_demo
-      && replay_mode == PLAY_REPLAY) {
-    switch (quit_anim) {
-    case OUT_OF_TIME: quit_anim = REPLAY_OUT_OF_TIME; break;
-    case NEXT_LEVEL: quit_anim = REPLAY_COMPLETE; break;
-    case REPLAY_INCOMPLETE: break;
-    case REPLAY_NEXT: break;
-    case REPLAY_RESTART_LEVEL: break;
-    default:
-      print_replay_chain_aborted ();
-      stop_replaying (1);
-      if (command_line_replay) exit (-1);
-      break;
+  finish_replay_anim ();
+
+  al_stop_timer (timer);
+  engine->anim_cycle = 0;
+}
+
+static void
+play_anim_headless (void (*compute_callback) (void),
+                    void (*cleanup_callback) (void))
+{
+  double start_time = al_get_time ();
+
+  while (! quit_anim) {
+    L_gc (main_L);
+
+    detect_incomplete_replay ();
+
+    if (compute_callback) {
+      compute_callback ();
+      update_state_hash ();
     }
+
+    /* Drawing is skipped altogether, thus there is no random number
+       consumption to undo.  However, the multi-room origin update and
+       the actor reordering done by 'draw_multi_rooms' (one sort per
+       non-empty cell) influence the next cycle's computation, so they
+       are reproduced here. */
+    mr_set_origin (mr.room, mr.x, mr.y);
+    sort_anims (mr_count_rooms ());
+    clear_changed_pos_and_room ();
+
+    if (cleanup_callback) cleanup_callback ();
+
+    if (! is_game_paused ()) engine->anim_cycle++;
   }
 
-  al_stop_timer (timer);
-  anim_cycle = 0;
+  record_replay_playback (al_get_time () - start_time);
+  finish_replay_anim ();
+
+  engine->anim_cycle = 0;
+}
+
+static void
+detect_incomplete_replay (void)
+{
+  if (title_demo || replay_mode != PLAY_REPLAY) return;
+
+  struct replay *replay = get_replay ();
+  struct anim *k;
+
+  if (engine->anim_cycle >= replay->packed_gamepad_state_nmemb
+      + REPLAY_STUCK_THRESHOLD
+      || ((k = get_anim_by_id (engine->current_kid_id))
+          && k->current_lives <= 0
+          && engine->death_timer >= SEC2CYC (8)))
+    quit_anim = REPLAY_INCOMPLETE;
+}
+
+/* Keep how many cycles the replay being played took, and for how
+   long the animation loop ran, leaving out everything done before and
+   after it, like loading assets */
+static void
+record_replay_playback (double seconds)
+{
+  if (title_demo || replay_mode != PLAY_REPLAY) return;
+  struct replay *replay = get_replay ();
+  replay->playback_cycles = engine->anim_cycle;
+  replay->playback_seconds = seconds;
+}
+
+static void
+finish_replay_anim (void)
+{
+  if (title_demo || replay_mode != PLAY_REPLAY) return;
+
+  switch (quit_anim) {
+  case OUT_OF_TIME: quit_anim = REPLAY_OUT_OF_TIME; break;
+  case NEXT_LEVEL: quit_anim = REPLAY_COMPLETE; break;
+  case REPLAY_INCOMPLETE: break;
+  case REPLAY_NEXT: break;
+  case REPLAY_RESTART_LEVEL: break;
+  default:
+    print_replay_chain_aborted ();
+    stop_replaying (1);
+    if (command_line_replay) exit (-1);
+    break;
+  }
+}
+
+bool
+is_headless (void)
+{
+  return headless && ! title_demo && replay_mode == PLAY_REPLAY;
 }
 
 void
@@ -380,7 +489,7 @@ int
 create_anim (struct anim *a0, enum anim_type t, struct pos *p, enum dir dir)
 {
   struct anim a;
-  int i = anima_nmemb;
+  int i = engine->anima_nmemb;
   memset (&a, 0, sizeof (a));
 
   if (a0) a = *a0;
@@ -409,7 +518,8 @@ create_anim (struct anim *a0, enum anim_type t, struct pos *p, enum dir dir)
   case MOUSE: create_mouse (a0, &a, p, dir); break;
   }
 
-  anima = add_to_array (&a, 1, anima, &anima_nmemb, i, sizeof (a));
+  engine->anima = add_to_array (&a, 1, engine->anima, &engine->anima_nmemb, i, sizeof (a));
+  engine->anim_index_valid = false;
   return i;
 }
 
@@ -420,23 +530,24 @@ destroy_anim (struct anim *a)
 
   if (a->type == KID) destroy_kid (a);
 
-  size_t i =  a - anima;
-  anima = remove_from_array (anima, &anima_nmemb, i, 1, sizeof (*a));
+  size_t i =  a - engine->anima;
+  engine->anima = remove_from_array (engine->anima, &engine->anima_nmemb, i, 1, sizeof (*a));
+  engine->anim_index_valid = false;
 }
 
 void
 destroy_anims (void)
 {
-  while (anima_nmemb) destroy_anim (&anima[0]);
-  anima = NULL;
-  anima_nmemb = 0;
+  while (engine->anima_nmemb) destroy_anim (&engine->anima[0]);
+  engine->anima = NULL;
+  engine->anima_nmemb = 0;
 }
 
 struct anim *
 get_next_controllable (struct anim *k)
 {
   do {
-    k = &anima[(k - anima + 1) % anima_nmemb];
+    k = &engine->anima[(k - engine->anima + 1) % engine->anima_nmemb];
   } while (k->type != KID || ! k->controllable);
   return k;
 }
@@ -444,28 +555,64 @@ get_next_controllable (struct anim *k)
 void
 select_controllable_by_id (int id)
 {
-  struct anim *old_k = get_anim_by_id (current_kid_id);
+  struct anim *old_k = get_anim_by_id (engine->current_kid_id);
   struct anim *k = get_anim_by_id (id);
-  current_kid_id = id;
+  engine->current_kid_id = id;
   if (id) {
     k->death_timer = 0;
-    last_fellow_shadow_id = id;
+    engine->last_fellow_shadow_id = id;
   }
   if (! is_frame_visible (&k->f))
     mr_restore_origin (&k->mr_origin);
   if (k->f.c.room != old_k->f.c.room)
     mr_focus_room (k->f.c.room);
-  k->selection_cycle = anim_cycle;
+  k->selection_cycle = engine->anim_cycle;
+}
+
+void
+index_anims (struct engine *e)
+{
+  size_t i;
+  int max_id = -1;
+  for (i = 0; i < e->anima_nmemb; i++)
+    if (e->anima[i].id > max_id) max_id = e->anima[i].id;
+
+  if (max_id + 1 > e->anim_index_nmemb) {
+    e->anim_index = xrealloc (e->anim_index,
+                              (max_id + 1) * sizeof (*e->anim_index));
+    e->anim_index_nmemb = max_id + 1;
+  }
+
+  for (i = 0; i < e->anim_index_nmemb; i++) e->anim_index[i] = -1;
+
+  /* ids may repeat, in which case the first actor wins as it always
+     did */
+  for (i = 0; i < e->anima_nmemb; i++) {
+    int id = e->anima[i].id;
+    if (id >= 0 && e->anim_index[id] < 0) e->anim_index[id] = i;
+  }
+
+  e->anim_index_valid = true;
 }
 
 struct anim *
 get_anim_by_id (int id)
 {
-  int i;
   if (id < 0) return NULL;
-  for (i = 0; i < anima_nmemb; i++)
-    if (anima[i].id == id) return &anima[i];
-  return NULL;
+  if (! engine->anim_index_valid) index_anims (engine);
+  if (id >= engine->anim_index_nmemb) return NULL;
+
+  int i = engine->anim_index[id];
+  if (i < 0) return NULL;
+
+  /* actors changed behind our back */
+  if (i >= engine->anima_nmemb || engine->anima[i].id != id) {
+    index_anims (engine);
+    i = engine->anim_index[id];
+    if (i < 0) return NULL;
+  }
+
+  return &engine->anima[i];
 }
 
 struct anim *
@@ -490,10 +637,10 @@ struct anim *
 get_anim_dead_at_pos (struct pos *p)
 {
   int i;
-  for (i = 0; i < anima_nmemb; i++)
-    if (anima[i].current_lives <= 0
-        && peq (&anima[i].p, p))
-      return &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++)
+    if (engine->anima[i].current_lives <= 0
+        && peq (&engine->anima[i].p, p))
+      return &engine->anima[i];
   return NULL;
 }
 
@@ -502,9 +649,9 @@ get_guard_anim_by_level_id (int id)
 {
   int i;
   if (id < 0) return NULL;
-  for (i = 0; i < anima_nmemb; i++)
-    if (is_guard (&anima[i]) && anima[i].level_id == id)
-      return &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++)
+    if (is_guard (&engine->anima[i]) && engine->anima[i].level_id == id)
+      return &engine->anima[i];
   return NULL;
 }
 
@@ -524,6 +671,62 @@ draw_anim_frame (ALLEGRO_BITMAP *bitmap, struct anim *a, enum vm vm)
   }
 }
 
+bool
+is_anim_visible_at_room (struct anim *a, int room)
+{
+  if (a->f.c.room == room) return true;
+  if (! a->f.b) return false;
+
+  struct frame f;
+  return is_frame_visible_at_room (&a->f, room)
+    || (a->xf.b
+        && is_frame_visible_at_room (xframe_frame (&a->f, &a->xf, &f),
+                                     room))
+    || (a->splash
+        && is_frame_visible_at_room (splash_frame (&a->f, &f), room));
+}
+
+void
+bucket_anims (void)
+{
+  sort_anims (mr_count_rooms ());
+
+  int nrooms = mr_count_uniq_rooms ();
+  size_t capacity = engine->anima_nmemb * (nrooms ? nrooms : 1);
+  if (capacity > room_anim_capacity) {
+    room_anim_pair = xrealloc (room_anim_pair,
+                               capacity * sizeof (*room_anim_pair));
+    room_anim = xrealloc (room_anim, capacity * sizeof (*room_anim));
+    room_anim_capacity = capacity;
+  }
+
+  /* each actor is tested only against the rooms on display */
+  memset (room_anim_index, 0, sizeof (room_anim_index));
+  size_t i, n = 0;
+  int room;
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *a = &engine->anima[i];
+    if (a->invisible) continue;
+    for (room = 1; room < ROOMS; room++) {
+      struct mr_cell_coord *c;
+      if (! mr_room_cells (room, &c)
+          || ! is_anim_visible_at_room (a, room)) continue;
+      room_anim_pair[n].room = room;
+      room_anim_pair[n++].i = i;
+      room_anim_index[room + 1]++;
+    }
+  }
+
+  /* stable counting sort by room keeps the drawing order */
+  for (room = 0; room < ROOMS; room++)
+    room_anim_index[room + 1] += room_anim_index[room];
+
+  size_t next[ROOMS];
+  memcpy (next, room_anim_index, sizeof (next));
+  for (i = 0; i < n; i++)
+    room_anim[next[room_anim_pair[i].room]++] = room_anim_pair[i].i;
+}
+
 void
 draw_anims (ALLEGRO_BITMAP *bitmap, enum em em, enum vm vm)
 {
@@ -531,11 +734,13 @@ draw_anims (ALLEGRO_BITMAP *bitmap, enum em em, enum vm vm)
 
   /* coord_wa = true; */
 
-  qsort (anima, anima_nmemb, sizeof (*a), compare_anims);
+  if (room_view <= 0 || room_view >= ROOMS) return;
 
   size_t i;
-  for (i = 0; i < anima_nmemb; i++) {
-    a = &anima[i];
+  for (i = room_anim_index[room_view];
+       i < room_anim_index[room_view + 1]; i++) {
+    if (room_anim[i] >= engine->anima_nmemb) continue;
+    a = &engine->anima[room_anim[i]];
     if (a->invisible) continue;
     draw_anim_frame (bitmap, a, vm);
     draw_room_anim_fg (bitmap, em, vm, a);
@@ -544,36 +749,46 @@ draw_anims (ALLEGRO_BITMAP *bitmap, enum em em, enum vm vm)
   /* coord_wa = false; */
 }
 
-int
-compare_anims (const void *_a0, const void *_a1)
+static struct anim_sort_key *
+anim_sort_key (struct anim *a, struct anim_sort_key *k)
 {
-  struct coord tr0, tr1;
-
-  struct anim *a0 = (struct anim *) _a0;
-  struct anim *a1 = (struct anim *) _a1;
+  struct coord c;
+  struct pos p;
+  k->stairs = is_kid_stairs (&a->f);
+  _tr (&a->f, &k->tr);
+  survey (_m, pos, &a->f, &c, &p, NULL);
+  _m (&a->f, &k->m);
+  k->floor = p.floor;
+  k->id = a->id;
+  return k;
+}
 
-  if (is_kid_stairs (&a0->f) && ! is_kid_stairs (&a1->f))
-    return -1;
-  if (! is_kid_stairs (&a0->f) && is_kid_stairs (&a1->f))
-    return 1;
+static int
+compare_anim_sort_keys (struct anim_sort_key *k0, struct anim_sort_key *k1)
+{
+  struct coord tr1, m1;
 
-  _tr (&a0->f, &tr0);
-  _tr (&a1->f, &tr1);
+  if (k0->stairs && ! k1->stairs) return -1;
+  if (! k0->stairs && k1->stairs) return 1;
 
-  coord2room (&tr1, tr0.room, &tr1);
+  coord2room (&k1->tr, k0->tr.room, &tr1);
 
-  if (tr0.room < tr1.room) return -1;
-  if (tr0.room > tr1.room) return 1;
+  if (k0->tr.room < tr1.room) return -1;
+  if (k0->tr.room > tr1.room) return 1;
 
-  if (is_near (a0, a1)) {
-    if (tr0.x < tr1.x) return -1;
-    if (tr0.x > tr1.x) return 1;
-    if (a0->id < a1->id) return -1;
-    if (a0->id > a1->id) return 1;
+  /* same as 'is_near' */
+  coord2room (&k1->m, k0->m.room, &m1);
+  if (m1.room == k0->m.room && k1->floor == k0->floor
+      && abs (m1.x - k0->m.x) < PLACE_WIDTH
+      && abs (m1.y - k0->m.y) < PLACE_HEIGHT) {
+    if (k0->tr.x < tr1.x) return -1;
+    if (k0->tr.x > tr1.x) return 1;
+    if (k0->id < k1->id) return -1;
+    if (k0->id > k1->id) return 1;
   } else {
-    struct coord o = {tr0.l, tr0.room, 0, ORIGINAL_HEIGHT};
+    struct coord o = {k0->tr.l, k0->tr.room, 0, ORIGINAL_HEIGHT};
 
-    double d0 = dist_coord (&o, &tr0);
+    double d0 = dist_coord (&o, &k0->tr);
     double d1 = dist_coord (&o, &tr1);
 
     if (d0 < d1) return -1;
@@ -583,6 +798,100 @@ compare_anims (const void *_a0, const void *_a1)
   return 0;
 }
 
+/* Top-down merge sort of actor indexes by their sort keys.  The
+   comparison isn't a total order, so the result depends on the exact
+   algorithm.  This one does the splitting and merging of glibc's
+   'qsort' (its merge sort path), which used to sort the actors, so on
+   glibc their relative order (and thus replays) is unchanged.  Other C
+   libraries' 'qsort' (musl, the BSDs, MinGW) may have ordered some
+   actors differently; there the order now follows glibc's. */
+static void
+merge_sort_anim_order (size_t *b, size_t n, size_t *tmp,
+                       struct anim_sort_key *key)
+{
+  if (n <= 1) return;
+
+  size_t n1 = n / 2;
+  size_t n2 = n - n1;
+  size_t *b1 = b;
+  size_t *b2 = b + n1;
+
+  merge_sort_anim_order (b1, n1, tmp, key);
+  merge_sort_anim_order (b2, n2, tmp, key);
+
+  size_t *t = tmp;
+  while (n1 > 0 && n2 > 0)
+    if (compare_anim_sort_keys (&key[*b1], &key[*b2]) <= 0) {
+      *t++ = *b1++;
+      n1--;
+    } else {
+      *t++ = *b2++;
+      n2--;
+    }
+
+  if (n1 > 0) memcpy (t, b1, n1 * sizeof (*b));
+  memcpy (b, tmp, (n - n2) * sizeof (*b));
+}
+
+/* Sort the actors into drawing order TIMES in a row.  The comparison
+   isn't a strict weak order, hence sorting an already sorted array may
+   still move actors around.  Each non-empty multi-room cell used to
+   sort them once before drawing itself, so callers pass the number of
+   such cells to keep the actors' order (part of the simulation state)
+   exactly as it was. */
+void
+sort_anims (int times)
+{
+  static struct anim_sort_key *key;
+  static size_t *order, *prev, *tmp;
+  static struct anim *sorted;
+  static size_t capacity;
+
+  size_t i, n = engine->anima_nmemb;
+  if (n > capacity) {
+    key = xrealloc (key, n * sizeof (*key));
+    order = xrealloc (order, n * sizeof (*order));
+    prev = xrealloc (prev, n * sizeof (*prev));
+    tmp = xrealloc (tmp, n * sizeof (*tmp));
+    sorted = xrealloc (sorted, n * sizeof (*sorted));
+    capacity = n;
+  }
+
+  /* the keys are computed once per actor, not once per comparison */
+  for (i = 0; i < n; i++) {
+    anim_sort_key (&engine->anima[i], &key[i]);
+    order[i] = i;
+  }
+
+  /* the keys don't change between sorts, only the order they are
+     found in does, and a sort that changes nothing won't ever do */
+  bool changed = false;
+  for (; times > 0; times--) {
+    memcpy (prev, order, n * sizeof (*order));
+    merge_sort_anim_order (order, n, tmp, key);
+    for (i = 0; i < n && order[i] == prev[i]; i++);
+    if (i == n) break;
+    changed = true;
+  }
+
+  if (! changed) return;
+
+  /* the actors' order is part of the simulation state, so they are
+     actually moved into drawing order, but only when it changed */
+  for (i = 0; i < n; i++) sorted[i] = engine->anima[order[i]];
+  memcpy (engine->anima, sorted, n * sizeof (*engine->anima));
+  engine->anim_index_valid = false;
+}
+
+int
+compare_anims (const void *_a0, const void *_a1)
+{
+  struct anim_sort_key k0, k1;
+  return compare_anim_sort_keys
+    (anim_sort_key ((struct anim *) _a0, &k0),
+     anim_sort_key ((struct anim *) _a1, &k1));
+}
+
 void
 draw_anim_if_at_pos (ALLEGRO_BITMAP *bitmap, struct anim *a, struct pos *p,
                      enum vm vm)
@@ -616,8 +925,8 @@ void
 clear_anims_keyboard_state (void)
 {
   int i;
-  for (i = 0; i < anima_nmemb; i++)
-    memset (&anima[i].key, 0, sizeof (anima[i].key));
+  for (i = 0; i < engine->anima_nmemb; i++)
+    memset (&engine->anima[i].key, 0, sizeof (engine->anima[i].key));
 }
 
 bool
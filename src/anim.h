@@ -28,6 +28,7 @@ void play_anim (void (*draw_callback) (void),
 void pause_animation (bool val);
 void cutscene_mode (bool val);
 void change_anim_freq (int f);
+bool is_headless (void);
 
 
 
@@ -39,11 +40,15 @@ void destroy_anims (void);
 struct anim *get_next_controllable (struct anim *k);
 void select_controllable_by_id (int id);
 struct anim *get_reciprocal_enemy (struct anim *k);
+void index_anims (struct engine *e);
 struct anim *get_anim_by_id (int id);
 struct anim *get_anim_dead_at_pos (struct pos *p);
 struct anim *get_guard_anim_by_level_id (int id);
 void draw_anim_frame (ALLEGRO_BITMAP *bitmap, struct anim *a, enum vm vm);
+bool is_anim_visible_at_room (struct anim *a, int room);
+void bucket_anims (void);
 void draw_anims (ALLEGRO_BITMAP *bitmap, enum em em, enum vm vm);
+void sort_anims (int times);
 int compare_anims (const void *a0, const void *a1);
 void draw_anim_if_at_pos (ALLEGRO_BITMAP *bitmap, struct anim *a,
                           struct pos *p, enum vm vm);
@@ -94,15 +99,13 @@ bool uncollide_back_fight (struct anim *a);
 
 /* variables */
 extern bool pause_anim;
-extern struct anim *anima;
-extern size_t anima_nmemb;
 extern enum quit_anim quit_anim; /* set to true to quit animation */
 extern bool next_frame_inv; /* invert draw_anim offset interpretation  */
 extern bool cutscene; /* don't apply physics if set */
-extern uint64_t anim_cycle;
 extern ALLEGRO_EVENT_QUEUE *event_queue;
 extern ALLEGRO_TIMER *timer;
 extern int anim_freq;
 extern int anim_freq_real;
+extern bool headless;
 
 #endif	/* MININIM_ANIM_H */
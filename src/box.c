@@ -72,7 +72,7 @@ draw_box (ALLEGRO_BITMAP* bitmap, struct pos *p, enum vm vm)
   struct coord c;
   if (! peq (&mouse_pos, p)) return;
 
-  ALLEGRO_BITMAP *box = get_box_frame (anim_cycle % 3, vm);
+  ALLEGRO_BITMAP *box = get_box_frame (engine->anim_cycle % 3, vm);
   draw_bitmapc (box, bitmap, box_coord (p, &c), 0);
 }
 
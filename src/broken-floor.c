@@ -191,8 +191,8 @@ draw_broken_floor_fg (ALLEGRO_BITMAP *bitmap, struct pos *p,
 {
   struct coord c;
   int i;
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *a = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *a = &engine->anima[i];
     struct pos pmt;
     survey (_mt, pos, &a->f, NULL, &pmt, NULL);
     if (peq (&pmt, p) && is_anim_dead (&a->f)) return;
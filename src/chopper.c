@@ -48,9 +48,6 @@ ALLEGRO_BITMAP *pv_chopper_00, *pv_chopper_01,
 ALLEGRO_BITMAP *chopper_blood_00, *chopper_blood_01,
   *chopper_blood_02, *chopper_blood_03, *chopper_blood_04;
 
-struct chopper *chopper = NULL;
-size_t chopper_nmemb = 0;
-
 static void
 draw_left_01 (ALLEGRO_BITMAP *bitmap, struct pos *p,
               struct chopper *ch, int w, enum em em, enum vm vm);
@@ -210,10 +207,10 @@ register_chopper (struct pos *p)
 
   init_chopper (p, &c);
 
-  chopper =
-    add_to_array (&c, 1, chopper, &chopper_nmemb, chopper_nmemb, sizeof (c));
+  engine->chopper =
+    add_to_array (&c, 1, engine->chopper, &engine->chopper_nmemb, engine->chopper_nmemb, sizeof (c));
 
-  qsort (chopper, chopper_nmemb, sizeof (c), compare_choppers);
+  qsort (engine->chopper, engine->chopper_nmemb, sizeof (c), compare_choppers);
 }
 
 int
@@ -240,7 +237,7 @@ chopper_at_pos (struct pos *p)
   struct chopper *cc;
 
  search:
-  cc = bsearch (&c, chopper, chopper_nmemb, sizeof (c),
+  cc = bsearch (&c, engine->chopper, engine->chopper_nmemb, sizeof (c),
                 compare_choppers);
 
   if (cc && fg (p) != CHOPPER) {
@@ -257,9 +254,9 @@ chopper_at_pos (struct pos *p)
 void
 remove_chopper (struct chopper *c)
 {
-  size_t i =  c - chopper;
-  chopper =
-    remove_from_array (chopper, &chopper_nmemb, i, 1, sizeof (*c));
+  size_t i =  c - engine->chopper;
+  engine->chopper =
+    remove_from_array (engine->chopper, &engine->chopper_nmemb, i, 1, sizeof (*c));
 }
 
 bool
@@ -267,8 +264,8 @@ should_chomp (struct pos *p)
 {
   int i;
 
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *a = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *a = &engine->anima[i];
     if (a->type != KID
         || (is_anim_dead (&a->f) && a->id != 0)) continue;
     if (is_pos_seeing (p, a, LEFT) || is_pos_seeing (p, a, RIGHT))
@@ -283,16 +280,16 @@ compute_choppers (void)
 {
   size_t i, j;
 
-  for (i = 0; i < chopper_nmemb;) {
-    struct chopper *c = &chopper[i];
+  for (i = 0; i < engine->chopper_nmemb;) {
+    struct chopper *c = &engine->chopper[i];
     if (fg (&c->p) == CHOPPER) {
       i++; continue;
     }
     remove_chopper (c);
   }
 
-  for (i = 0; i < chopper_nmemb; i++) {
-    struct chopper *c = &chopper[i];
+  for (i = 0; i < engine->chopper_nmemb; i++) {
+    struct chopper *c = &engine->chopper[i];
 
     if (c->inactive) continue;
 
@@ -300,7 +297,7 @@ compute_choppers (void)
     case 0:
       if (! c->alert) c->alert = ! should_chomp (&c->p);
       if ((c->wait-- <= 0 && should_chomp (&c->p)
-           && (anim_cycle % CHOPPER_WAIT) ==
+           && (engine->anim_cycle % CHOPPER_WAIT) ==
            prandom_pos (&c->p, CHOPPER_WAIT - 1))
           || c->activate) {
         c->i++;
@@ -334,8 +331,8 @@ compute_choppers (void)
     if (c->i != 1 && c->i != 2 ) continue;
 
     /* chomp kid */
-    for (j = 0; j < anima_nmemb; j++) {
-      struct anim *a = &anima[j];
+    for (j = 0; j < engine->anima_nmemb; j++) {
+      struct anim *a = &engine->anima[j];
       struct pos pl; prel (&c->p, &pl, +0, -1);
       if (a->type == MOUSE
           || is_anim_fall (&a->f)
@@ -70,10 +70,6 @@
 #define CHOPPER_BLOOD_03 "data/chopper/blood-03.png"
 #define CHOPPER_BLOOD_04 "data/chopper/blood-04.png"
 
-/* variables */
-extern struct chopper *chopper;
-extern size_t chopper_nmemb;
-
 /* functions */
 void load_chopper (void);
 void unload_chopper (void);
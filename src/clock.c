@@ -188,7 +188,7 @@ draw_clock (ALLEGRO_BITMAP *bitmap, int i, enum vm vm)
   case 6: clock = clock_06; break;
   }
 
-  switch (anim_cycle % 3) {
+  switch (engine->anim_cycle % 3) {
   case 0: clock_sand = clock_sand_00; break;
   case 1: clock_sand = clock_sand_01; break;
   case 2: clock_sand = clock_sand_02; break;
@@ -208,7 +208,7 @@ draw_clock (ALLEGRO_BITMAP *bitmap, int i, enum vm vm)
 int
 get_clock_by_time_left (void)
 {
-  float f = ((float) play_time) / time_limit;
+  float f = ((float) engine->play_time) / time_limit;
   f = f < 0 ? 0 : f;
   f = f > 1 ? 1 : f;
   return f * 6;
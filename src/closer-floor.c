@@ -44,9 +44,6 @@ ALLEGRO_BITMAP *dv_unpressed_closer_floor_base, *dv_pressed_closer_floor_base,
 ALLEGRO_BITMAP *pv_unpressed_closer_floor_base, *pv_pressed_closer_floor_base,
   *pv_pressed_closer_floor_right;
 
-struct closer_floor *closer_floor = NULL;
-size_t closer_floor_nmemb = 0;
-
 void
 load_closer_floor (void)
 {
@@ -140,11 +137,11 @@ register_closer_floor (struct pos *p)
 
   init_closer_floor (p, &c);
 
-  closer_floor =
-    add_to_array (&c, 1, closer_floor, &closer_floor_nmemb,
-                  closer_floor_nmemb, sizeof (c));
+  engine->closer_floor =
+    add_to_array (&c, 1, engine->closer_floor, &engine->closer_floor_nmemb,
+                  engine->closer_floor_nmemb, sizeof (c));
 
-  qsort (closer_floor, closer_floor_nmemb, sizeof (c),
+  qsort (engine->closer_floor, engine->closer_floor_nmemb, sizeof (c),
          compare_closer_floors);
 }
 
@@ -173,7 +170,7 @@ closer_floor_at_pos (struct pos *p)
   struct closer_floor *cc;
 
  search:
-  cc = bsearch (&c, closer_floor, closer_floor_nmemb, sizeof (c),
+  cc = bsearch (&c, engine->closer_floor, engine->closer_floor_nmemb, sizeof (c),
                 compare_closer_floors);
 
   if (cc && fg (p) != CLOSER_FLOOR) {
@@ -192,23 +189,23 @@ closer_floor_by_event (struct pos *p, int event, int dir)
 {
   struct closer_floor *c;
   if (p) c = closer_floor_at_pos (p);
-  else c = &closer_floor[0];
+  else c = &engine->closer_floor[0];
 
   if (! c) {
-    c = &closer_floor[0];
+    c = &engine->closer_floor[0];
     p = NULL;
   }
 
   int i;
 
   if (dir < 0)
-    for (i = c - closer_floor - (p ? 1 : 0); i >= 0; i--) {
-      if (closer_floor[i].event == event) return &closer_floor[i];
+    for (i = c - engine->closer_floor - (p ? 1 : 0); i >= 0; i--) {
+      if (engine->closer_floor[i].event == event) return &engine->closer_floor[i];
     }
   else
-    for (i = c - closer_floor + (p ? 1 : 0);
-         i < closer_floor_nmemb; i++) {
-      if (closer_floor[i].event == event) return &closer_floor[i];
+    for (i = c - engine->closer_floor + (p ? 1 : 0);
+         i < engine->closer_floor_nmemb; i++) {
+      if (engine->closer_floor[i].event == event) return &engine->closer_floor[i];
     }
 
   return NULL;
@@ -217,9 +214,9 @@ closer_floor_by_event (struct pos *p, int event, int dir)
 void
 remove_closer_floor (struct closer_floor *c)
 {
-  size_t i =  c - closer_floor;
-  closer_floor =
-    remove_from_array (closer_floor, &closer_floor_nmemb, i, 1, sizeof (*c));
+  size_t i =  c - engine->closer_floor;
+  engine->closer_floor =
+    remove_from_array (engine->closer_floor, &engine->closer_floor_nmemb, i, 1, sizeof (*c));
 }
 
 void
@@ -234,7 +231,7 @@ press_closer_floor (struct pos *p, struct anim *a)
     kid_haptic (a, KID_HAPTIC_COLLISION);
     register_changed_pos (&c->p);
     c->prev_pressed = true;
-    c->priority = anim_cycle;
+    c->priority = engine->anim_cycle;
   }
 }
 
@@ -243,7 +240,7 @@ break_closer_floor (struct pos *p)
 {
   struct closer_floor *c = closer_floor_at_pos (p);
   if (! c) return;
-  close_door (c->p.l, c->event, anim_cycle);
+  close_door (c->p.l, c->event, engine->anim_cycle);
   register_con_undo
     (&undo, p,
      MIGNORE, MIGNORE, c->event + EVENTS, MIGNORE,
@@ -255,11 +252,11 @@ void
 unpress_closer_floors (void)
 {
   size_t i;
-  for (i = 0; i < closer_floor_nmemb; i++) {
-    closer_floor[i].prev_pressed =
-      closer_floor[i].pressed;
-    closer_floor[i].pressed = false;
-    closer_floor[i].unresponsive = false;
+  for (i = 0; i < engine->closer_floor_nmemb; i++) {
+    engine->closer_floor[i].prev_pressed =
+      engine->closer_floor[i].pressed;
+    engine->closer_floor[i].pressed = false;
+    engine->closer_floor[i].unresponsive = false;
   }
 }
 
@@ -267,8 +264,8 @@ void
 register_changed_closer_floors (void)
 {
   size_t i;
-  for (i = 0; i < closer_floor_nmemb; i++) {
-    struct closer_floor *c = &closer_floor[i];
+  for (i = 0; i < engine->closer_floor_nmemb; i++) {
+    struct closer_floor *c = &engine->closer_floor[i];
     if (c->prev_pressed != c->pressed)
       register_changed_pos (&c->p);
   }
@@ -279,16 +276,16 @@ compute_closer_floors (void)
 {
   size_t i;
 
-  for (i = 0; i < closer_floor_nmemb;) {
-    struct closer_floor *c = &closer_floor[i];
+  for (i = 0; i < engine->closer_floor_nmemb;) {
+    struct closer_floor *c = &engine->closer_floor[i];
     if (fg (&c->p) == CLOSER_FLOOR) {
       i++; continue;
     }
     remove_closer_floor (c);
   }
 
-  for (i = 0; i < closer_floor_nmemb; i++) {
-    struct closer_floor *c = &closer_floor[i];
+  for (i = 0; i < engine->closer_floor_nmemb; i++) {
+    struct closer_floor *c = &engine->closer_floor[i];
     if (c->pressed && ! c->broken && ! c->unresponsive) {
       if (! c->noise) {
         alert_guards (&c->p);
@@ -51,10 +51,6 @@
 #define PV_PRESSED_CLOSER_FLOOR_BASE "data/closer-floor/pv-pressed-base.png"
 #define PV_PRESSED_CLOSER_FLOOR_RIGHT "data/closer-floor/pv-pressed-right.png"
 
-/* variables */
-extern struct closer_floor *closer_floor;
-extern size_t closer_floor_nmemb;
-
 /* functions */
 void load_closer_floor (void);
 void unload_closer_floor (void);
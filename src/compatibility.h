@@ -59,4 +59,18 @@
 #define HAPTIC_FEATURE false
 #endif
 
+/* Thread-local storage */
+#if defined _MSC_VER
+#define THREAD_LOCAL __declspec (thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+/* Parallel replay chain validation */
+#if ! WINDOWS_PORT
+#define PARALLEL_REPLAY_FEATURE true
+#else
+#define PARALLEL_REPLAY_FEATURE false
+#endif
+
 #endif	/* MININIM_COMPATIBILITY_H */
@@ -52,6 +52,18 @@
 #define CLIPPING_RECTANGLE_STACK_NMEMB_MAX 10
 #define DRAWN_RECTANGLE_STACK_NMEMB_MAX 10
 
+#define BITMAP_ATLAS_PAGE_SIZE 1024
+#define BITMAP_ATLAS_PADDING 1
+
+#define PROFILER_RING_SIZE (1 << 16)
+#define PROFILER_DEPTH_MAX 32
+
+#define TELEMETRY_SUB_BUCKET_BITS 4
+#define TELEMETRY_SUB_BUCKETS (1 << TELEMETRY_SUB_BUCKET_BITS)
+#define TELEMETRY_BUCKETS 512
+#define TELEMETRY_WINDOW 256
+#define TELEMETRY_DROPPED_FRAME_FACTOR 1.5
+
 #define MIGNORE (INT_MIN)
 
 #define ROOMS 25
@@ -124,6 +136,8 @@
 #define EFFECT_HZ 30
 #define UNLIMITED_HZ 10000
 #define REPLAY_STUCK_THRESHOLD 204
+#define REPLAY_KEYFRAME_PERIOD 60
+#define REPLAY_KEYFRAME_MEMORY_MAX (64 * 1024 * 1024)
 
 #define SELECT_CYCLES (SEC2CYC (3))
 
@@ -186,8 +200,20 @@
 #define EDITOR_CYCLES_2 18
 #define EDITOR_CYCLES_3 24
 
+#define LEGACY_LEVELS 14
+
 #define REPLAY_FILE_SIGNATURE "MININIM REPLAY"
-#define REPLAY_FILE_FORMAT_VERSION 1
+#define REPLAY_FILE_FORMAT_VERSION 2
+#define REPLAY_RAW_FILE_FORMAT_VERSION 1
+#define REPLAY_INITIAL_CAPACITY 1024
+#define REPLAY_JOURNAL_PERIOD DEFAULT_HZ
+#define REPLAY_JOURNAL_FILENAME "recording.mrp"
+#define REPLAY_ARCHIVE_SIGNATURE "MININIM REPLAY ARCHIVE"
+#define REPLAY_ARCHIVE_VERSION 2
+#define REPLAY_ARCHIVE_FILENAME "replays.idx"
+
+#define STATE_TRACE_SIGNATURE "MININIM STATE TRACE"
+#define STATE_TRACE_VERSION 1
 
 #define PACKED_GAMEPAD_STATE_UP_BIT (1 << 0)
 #define PACKED_GAMEPAD_STATE_DOWN_BIT (1 << 1)
@@ -489,7 +489,7 @@ cutscene_11_little_time_left_anim (void)
 void
 cutscene_11_anim (void)
 {
-  if (play_time >= (92 * time_limit) / 100)
+  if (engine->play_time >= (92 * time_limit) / 100)
     cutscene_11_little_time_left_anim ();
   else cutscene_01_05_11_anim ();
 }
@@ -855,7 +855,7 @@ cutscene_out_of_time_anim (void)
   }
 
   if ((was_any_key_pressed ())
-      && anim_cycle > SEC2CYC (3)) {
+      && engine->anim_cycle > SEC2CYC (3)) {
     quit_anim = RESTART_GAME;
     return;
   }
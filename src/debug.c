@@ -58,7 +58,7 @@ debug_pos (struct pos *p)
 void
 debug_random_seed (void)
 {
-  fprintf (stderr, "%ju 0x%X\n", anim_cycle, random_seed);
+  fprintf (stderr, "%ju 0x%X\n", engine->anim_cycle, engine->random_seed);
 }
 
 void
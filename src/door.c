@@ -50,9 +50,6 @@ ALLEGRO_BITMAP *pv_door_left, *pv_door_right, *pv_door_pole, *pv_door_pole_base,
   *pv_door_top, *pv_door_grid, *pv_door_grid_tip;
 ALLEGRO_BITMAP *pv_door_grid_cache[DOOR_STEPS];
 
-struct door *door = NULL;
-size_t door_nmemb = 0;
-
 void
 load_door (void)
 {
@@ -268,10 +265,10 @@ register_door (struct pos *p)
 
   init_door (p, &d);
 
-  door =
-    add_to_array (&d, 1, door, &door_nmemb, door_nmemb, sizeof (d));
+  engine->door =
+    add_to_array (&d, 1, engine->door, &engine->door_nmemb, engine->door_nmemb, sizeof (d));
 
-  qsort (door, door_nmemb, sizeof (d), compare_doors);
+  qsort (engine->door, engine->door_nmemb, sizeof (d), compare_doors);
 }
 
 int
@@ -298,7 +295,7 @@ door_at_pos (struct pos *p)
   struct door *dd;
 
  search:
-  dd = bsearch (&d, door, door_nmemb, sizeof (d), compare_doors);
+  dd = bsearch (&d, engine->door, engine->door_nmemb, sizeof (d), compare_doors);
 
   if (dd && fg (p) != DOOR) {
     remove_door (dd);
@@ -314,9 +311,9 @@ door_at_pos (struct pos *p)
 void
 remove_door (struct door *d)
 {
-  size_t i =  d - door;
-  door =
-    remove_from_array (door, &door_nmemb, i, 1, sizeof (*d));
+  size_t i =  d - engine->door;
+  engine->door =
+    remove_from_array (engine->door, &engine->door_nmemb, i, 1, sizeof (*d));
 }
 
 void
@@ -324,16 +321,16 @@ compute_doors (void)
 {
   size_t i;
 
-  for (i = 0; i < door_nmemb;) {
-    struct door *d = &door[i];
+  for (i = 0; i < engine->door_nmemb;) {
+    struct door *d = &engine->door[i];
     if (fg (&d->p) == DOOR) {
       i++; continue;
     }
     remove_door (d);
   }
 
-  for (i = 0; i < door_nmemb; i++) {
-    struct door *d = &door[i];
+  for (i = 0; i < engine->door_nmemb; i++) {
+    struct door *d = &engine->door[i];
     switch (d->action) {
     case OPEN_DOOR:
     case STAY_OPEN_DOOR:
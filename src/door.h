@@ -75,10 +75,6 @@
 #define PV_DOOR_GRID "data/door/pv-grid.png"
 #define PV_DOOR_GRID_TIP "data/door/pv-grid-tip.png"
 
-/* variables */
-extern struct door *door;
-extern size_t door_nmemb;
-
 /* functions */
 void load_door (void);
 void unload_door (void);
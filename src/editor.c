@@ -425,7 +425,7 @@ editor (void)
       register_mirror_pos_undo (&undo, &p, &p0, true, "MIRROR CON H+V.");
       break;
     case 'R':
-      random_pos (&global_level, &p0);
+      random_pos (&engine->level, &p0);
       p0.room = p.room;
       register_mirror_pos_undo (&undo, &p, &p0, false, "MIRROR CON R.");
       break;
@@ -957,7 +957,7 @@ editor (void)
 
     npos (&p, &p0);
     ui_msg (0, "[%i,%i,%i,%i](%i,%i,%i,%i)",
-            global_level.n, p0.room, p0.floor, p0.place,
+            engine->level.n, p0.room, p0.floor, p0.place,
             fg (&p), bg (&p), ext (&p), is_fake (&p) ? fake (&p) : -1);
     break;
   case EDIT_EVENT:
@@ -983,19 +983,19 @@ editor (void)
     case 'S':
       edit = EDIT_EVENT_SET;
       s = last_event;
-      bb = event (&global_level, last_event)->next;
+      bb = event (&engine->level, last_event)->next;
       break;
     }
     break;
   case EDIT_EVENT2CON:
-    if (! is_valid_pos (&event (&global_level, s)->p)) {
+    if (! is_valid_pos (&event (&engine->level, s)->p)) {
       al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_UNAVAILABLE);
       al_set_mouse_xy (display, 0, 0);
     } else {
       al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_LINK);
-      set_mouse_pos (&event (&global_level, s)->p);
+      set_mouse_pos (&event (&engine->level, s)->p);
     }
-    bb = event (&global_level, s)->next;
+    bb = event (&engine->level, s)->next;
     switch (bmenu_int (&s, &bb, 0, EVENTS - 1, "ED>EVENT", "N")) {
     case -1: set_mouse_coord (&last_mouse_coord); edit = EDIT_EVENT; break;
     case 0: break;
@@ -1093,27 +1093,27 @@ editor (void)
       get_mouse_coord (&last_mouse_coord);
       edit = EDIT_ROOM_EXCHANGE; break;
     case 'A':
-      apply_to_room (&global_level, mr.room, clear_con,
+      apply_to_room (&engine->level, mr.room, clear_con,
                      "CLEAR ROOM");
       break;
     case 'R':
-      apply_to_room (&global_level, mr.room, random_con,
+      apply_to_room (&engine->level, mr.room, random_con,
                      "RANDOMIZE ROOM");
       break;
     case 'D':
-      apply_to_room (&global_level, mr.room, decorate_con,
+      apply_to_room (&engine->level, mr.room, decorate_con,
                      "DECORATE ROOM");
       break;
     case 'M': edit = EDIT_ROOM_MIRROR; break;
     case 'C':
-      copy_room (&room_copy, &global_level, mr.room);
+      copy_room (&room_copy, &engine->level, mr.room);
       editor_msg ("COPY ROOM", EDITOR_CYCLES_3);
       break;
     case 'P':
-      paste_room (&global_level, mr.room, &room_copy, "PASTE ROOM");
+      paste_room (&engine->level, mr.room, &room_copy, "PASTE ROOM");
       break;
     case '!':
-      apply_to_room (&global_level, mr.room, fix_con, "FIX ROOM");
+      apply_to_room (&engine->level, mr.room, fix_con, "FIX ROOM");
       break;
     }
     break;
@@ -1161,23 +1161,23 @@ editor (void)
     switch (bmenu_enum (mirror_dir_menu, "RML>")) {
     case -1: case 1: edit = EDIT_ROOM_MIRROR; break;
     case 'H':
-      memcpy (&l, &global_level.link, sizeof (l));
+      memcpy (&l, &engine->level.link, sizeof (l));
       editor_mirror_link (mr.room, LEFT, RIGHT);
       register_link_undo (&undo, l, "ROOM MIRROR LINKS H.");
       break;
     case 'V':
-      memcpy (&l, &global_level.link, sizeof (l));
+      memcpy (&l, &engine->level.link, sizeof (l));
       editor_mirror_link (mr.room, ABOVE, BELOW);
       register_link_undo (&undo, l, "ROOM MIRROR LINKS V.");
       break;
     case 'B':
-      memcpy (&l, &global_level.link, sizeof (l));
+      memcpy (&l, &engine->level.link, sizeof (l));
       editor_mirror_link (mr.room, LEFT, RIGHT);
       editor_mirror_link (mr.room, ABOVE, BELOW);
       register_link_undo (&undo, l, "ROOM MIRROR LINKS H+V.");
       break;
     case 'R':
-      memcpy (&l, &global_level.link, sizeof (l));
+      memcpy (&l, &engine->level.link, sizeof (l));
       editor_mirror_link (mr.room, random_dir (), random_dir ());
       register_link_undo (&undo, l, "ROOM MIRROR LINKS R.");
       break;
@@ -1191,14 +1191,14 @@ editor (void)
     case -1: case 1: edit = EDIT_ROOM_MIRROR; break;
     case 'H':
       register_h_room_mirror_con_undo (&undo, mr.room, NULL);
-      memcpy (&l, &global_level.link, sizeof (l));
+      memcpy (&l, &engine->level.link, sizeof (l));
       editor_mirror_link (mr.room, LEFT, RIGHT);
       register_link_undo (&undo, l, "ROOM MIRROR CONS+LINKS H.");
       break;
     case 'V':
       register_v_room_mirror_con_undo
         (&undo, mr.room, NULL);
-      memcpy (&l, &global_level.link, sizeof (l));
+      memcpy (&l, &engine->level.link, sizeof (l));
       editor_mirror_link (mr.room, ABOVE, BELOW);
       register_link_undo (&undo, l, "ROOM MIRROR CONS+LINKS V.");
       break;
@@ -1207,7 +1207,7 @@ editor (void)
         (&undo, mr.room, NULL);
       register_v_room_mirror_con_undo
         (&undo, mr.room, NULL);
-      memcpy (&l, &global_level.link, sizeof (l));
+      memcpy (&l, &engine->level.link, sizeof (l));
       editor_mirror_link (mr.room, LEFT, RIGHT);
       editor_mirror_link (mr.room, ABOVE, BELOW);
       register_link_undo (&undo, l, "ROOM MIRROR CONS+LINKS H+V.");
@@ -1215,7 +1215,7 @@ editor (void)
     case 'R':
       register_random_room_mirror_con_undo
         (&undo, mr.room, false, NULL);
-      memcpy (&l, &global_level.link, sizeof (l));
+      memcpy (&l, &engine->level.link, sizeof (l));
       editor_mirror_link (mr.room, random_dir (), random_dir ());
       register_link_undo (&undo, l, "ROOM MIRROR CONS+LINKS R.");
       break;
@@ -1232,19 +1232,19 @@ editor (void)
     case -1: case 1: edit = EDIT_ROOM; break;
     case 'L':
       get_mouse_coord (&last_mouse_coord);
-      set_mouse_room (roomd (&global_level, mr.room, LEFT));
+      set_mouse_room (roomd (&engine->level, mr.room, LEFT));
       edit = EDIT_LINK_LEFT; break;
     case 'R':
       get_mouse_coord (&last_mouse_coord);
-      set_mouse_room (roomd (&global_level, mr.room, RIGHT));
+      set_mouse_room (roomd (&engine->level, mr.room, RIGHT));
       edit = EDIT_LINK_RIGHT; break;
     case 'A':
       get_mouse_coord (&last_mouse_coord);
-      set_mouse_room (roomd (&global_level, mr.room, ABOVE));
+      set_mouse_room (roomd (&engine->level, mr.room, ABOVE));
       edit = EDIT_LINK_ABOVE; break;
     case 'B':
       get_mouse_coord (&last_mouse_coord);
-      set_mouse_room (roomd (&global_level, mr.room, BELOW));
+      set_mouse_room (roomd (&engine->level, mr.room, BELOW));
       edit = EDIT_LINK_BELOW; break;
     }
     break;
@@ -1266,12 +1266,12 @@ editor (void)
     mr.room_select = last_mouse_coord.c.room;
 
     if (r == 1) {
-      memcpy (&l, &global_level.link, sizeof (l));
+      memcpy (&l, &engine->level.link, sizeof (l));
 
       int room0 = last_mouse_coord.c.room;
       int room1 = mr.room;
 
-      exchange_rooms (&global_level, room0, room1);
+      exchange_rooms (&engine->level, room0, room1);
 
       register_link_undo (&undo, l, "ROOM EXCHANGE");
       last_mouse_coord.c.room = room1;
@@ -1301,10 +1301,10 @@ editor (void)
     switch (bmenu_enum (kid_menu, "K>")) {
     case -1: case 1: edit = EDIT_MAIN; break;
     case 'P':
-      ui_place_kid (get_anim_by_id (current_kid_id), &p);
+      ui_place_kid (get_anim_by_id (engine->current_kid_id), &p);
       break;
     case 'J':
-      set_mouse_pos (&global_level.start_pos);
+      set_mouse_pos (&engine->level.start_pos);
       break;
     case 'S':
       if (! is_valid_pos (&p)) {
@@ -1314,14 +1314,14 @@ editor (void)
       register_start_pos_undo (&undo, &p, "START POSITION");
       break;
     case 'D':
-      if (! is_pos_visible (&global_level.start_pos)) {
+      if (! is_pos_visible (&engine->level.start_pos)) {
         editor_msg ("START POS NOT VISIBLE", EDITOR_CYCLES_1);
         break;
       }
       register_toggle_start_dir_undo (&undo, "START DIRECTION");
       break;
     case 'W':
-      if (! is_pos_visible (&global_level.start_pos)) {
+      if (! is_pos_visible (&engine->level.start_pos)) {
         editor_msg ("START POS NOT VISIBLE", EDITOR_CYCLES_1);
         break;
       }
@@ -1331,7 +1331,7 @@ editor (void)
     break;
   case EDIT_LEVEL:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_DEFAULT);
-    str = xasprintf ("L%i>", global_level.n);
+    str = xasprintf ("L%i>", engine->level.n);
     switch (bmenu_enum (level_menu, str)) {
     case -1: case 1: edit = EDIT_MAIN; break;
     case 'X':
@@ -1339,56 +1339,56 @@ editor (void)
         editor_msg ("NATIVE LEVEL MODULE ONLY", EDITOR_CYCLES_2);
       else {
         edit = EDIT_LEVEL_EXCHANGE;
-        next_level_number = global_level.n;
+        next_level_number = engine->level.n;
       }
       break;
     case 'J': edit = EDIT_LEVEL_JUMP;
-      next_level_number = global_level.n;
+      next_level_number = engine->level.n;
       break;
     case 'A':
       for (i = 1; i < ROOMS; i++)
-        apply_to_room (&global_level, i, clear_con, NULL);
+        apply_to_room (&engine->level, i, clear_con, NULL);
       end_undo_set (&undo, "CLEAR LEVEL");
       break;
     case 'R':
       for (i = 1; i < ROOMS; i++)
-        apply_to_room (&global_level, i, random_con, NULL);
+        apply_to_room (&engine->level, i, random_con, NULL);
       end_undo_set (&undo, "RANDOMIZE LEVEL");
       break;
     case 'D':
       for (i = 1; i < ROOMS; i++)
-        apply_to_room (&global_level, i, decorate_con, NULL);
+        apply_to_room (&engine->level, i, decorate_con, NULL);
       end_undo_set (&undo, "DECORATE LEVEL");
       break;
     case 'M': edit = EDIT_LEVEL_MIRROR; break;
     case 'C':
-      copy_level (&level_copy, &global_level);
+      copy_level (&level_copy, &engine->level);
       editor_msg ("COPY LEVEL", EDITOR_CYCLES_3);
       break;
     case 'P':
       register_level_undo (&undo, &level_copy, "PASTE LEVEL");
       break;
     case 'N': edit = EDIT_NOMINAL_NUMBER;
-      s = global_level.nominal_n;
+      s = engine->level.nominal_n;
       break;
     case 'E': edit = EDIT_ENVIRONMENT;
       bb = em;
-      b0 = (global_level.em == DUNGEON) ? true : false;
-      b1 = (global_level.em == PALACE) ? true : false;
+      b0 = (engine->level.em == DUNGEON) ? true : false;
+      b1 = (engine->level.em == PALACE) ? true : false;
       break;
     case 'H': edit = EDIT_HUE;
       bb = hue;
-      b0 = (global_level.hue == HUE_NONE) ? true : false;
-      b1 = (global_level.hue == HUE_GREEN) ? true : false;
-      b2 = (global_level.hue == HUE_GRAY) ? true : false;
-      b3 = (global_level.hue == HUE_YELLOW) ? true : false;
-      b4 = (global_level.hue == HUE_BLUE) ? true : false;
+      b0 = (engine->level.hue == HUE_NONE) ? true : false;
+      b1 = (engine->level.hue == HUE_GREEN) ? true : false;
+      b2 = (engine->level.hue == HUE_GRAY) ? true : false;
+      b3 = (engine->level.hue == HUE_YELLOW) ? true : false;
+      b4 = (engine->level.hue == HUE_BLUE) ? true : false;
       break;
     case 'S':
       if (level_module != NATIVE_LEVEL_MODULE)
         editor_msg ("NATIVE LEVEL MODULE ONLY", EDITOR_CYCLES_2);
-      else if (save_level (&global_level)) {
-        copy_level (&vanilla_level, &global_level);
+      else if (save_level (&engine->level)) {
+        copy_level (&vanilla_level, &engine->level);
         editor_msg ("LEVEL SAVED", EDITOR_CYCLES_2);
       } else editor_msg ("LEVEL SAVING FAILED", EDITOR_CYCLES_2);
       break;
@@ -1398,32 +1398,32 @@ editor (void)
       break;
     case '!':
       for (i = 1; i < ROOMS; i++)
-        apply_to_room (&global_level, i, fix_con, NULL);
+        apply_to_room (&engine->level, i, fix_con, NULL);
       end_undo_set (&undo, "FIX LEVEL");
       break;
     }
     al_free (str);
    break;
   case EDIT_LEVEL_JUMP:
-    str = xasprintf ("L%iJ>LEVEL", global_level.n);
+    str = xasprintf ("L%iJ>LEVEL", engine->level.n);
     if (bmenu_select_level (EDIT_LEVEL, str) == 1
-        && next_level_number != global_level.n) {
+        && next_level_number != engine->level.n) {
       ignore_level_cutscene = true;
       quit_anim = NEXT_LEVEL;
     }
     al_free (str);
     break;
   case EDIT_LEVEL_EXCHANGE:
-    str = xasprintf ("L%iX>LEVEL", global_level.n);
+    str = xasprintf ("L%iX>LEVEL", engine->level.n);
     if (bmenu_select_level (EDIT_LEVEL, str) == 1
-        && next_level_number != global_level.n)
+        && next_level_number != engine->level.n)
       register_level_exchange_undo (&undo, next_level_number,
                                     "LEVEL EXCHANGE");
     al_free (str);
     break;
   case EDIT_LEVEL_MIRROR:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_DEFAULT);
-    str = xasprintf ("L%iM>", global_level.n);
+    str = xasprintf ("L%iM>", engine->level.n);
     switch (bmenu_enum (mirror_menu, str)) {
     case -1: case 1: edit = EDIT_LEVEL; break;
     case 'C': edit = EDIT_LEVEL_MIRROR_CONS; break;
@@ -1434,7 +1434,7 @@ editor (void)
     break;
   case EDIT_LEVEL_MIRROR_CONS:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_DEFAULT);
-    str = xasprintf ("L%iMC>", global_level.n);
+    str = xasprintf ("L%iMC>", engine->level.n);
     switch (bmenu_enum (mirror_dir_menu, str)) {
     case -1: case 1: edit = EDIT_LEVEL_MIRROR; break;
     case 'H':
@@ -1465,38 +1465,38 @@ editor (void)
     break;
   case EDIT_LEVEL_MIRROR_LINKS:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_DEFAULT);
-    str = xasprintf ("L%iML>", global_level.n);
+    str = xasprintf ("L%iML>", engine->level.n);
     switch (bmenu_enum (mirror_dir_menu, str)) {
     case -1: case 1: edit = EDIT_LEVEL_MIRROR; break;
     case 'H':
       for (i = 1; i < ROOMS; i++) {
-        memcpy (&l, &global_level.link, sizeof (l));
-        mirror_link (&global_level, i, LEFT, RIGHT);
+        memcpy (&l, &engine->level.link, sizeof (l));
+        mirror_link (&engine->level, i, LEFT, RIGHT);
         register_link_undo (&undo, l, NULL);
       }
       end_undo_set (&undo, "LEVEL MIRROR LINKS H.");
       break;
     case 'V':
       for (i = 1; i < ROOMS; i++) {
-        memcpy (&l, &global_level.link, sizeof (l));
-        mirror_link (&global_level, i, ABOVE, BELOW);
+        memcpy (&l, &engine->level.link, sizeof (l));
+        mirror_link (&engine->level, i, ABOVE, BELOW);
         register_link_undo (&undo, l, NULL);
       }
       end_undo_set (&undo, "LEVEL MIRROR LINKS V.");
       break;
     case 'B':
       for (i = 1; i < ROOMS; i++) {
-        memcpy (&l, &global_level.link, sizeof (l));
-        mirror_link (&global_level, i, LEFT, RIGHT);
-        mirror_link (&global_level, i, ABOVE, BELOW);
+        memcpy (&l, &engine->level.link, sizeof (l));
+        mirror_link (&engine->level, i, LEFT, RIGHT);
+        mirror_link (&engine->level, i, ABOVE, BELOW);
         register_link_undo (&undo, l, NULL);
       }
       end_undo_set (&undo, "LEVEL MIRROR LINKS H+V.");
       break;
     case 'R':
       for (i = 1; i < ROOMS; i++) {
-        memcpy (&l, &global_level.link, sizeof (l));
-        mirror_link (&global_level, i, random_dir (), random_dir ());
+        memcpy (&l, &engine->level.link, sizeof (l));
+        mirror_link (&engine->level, i, random_dir (), random_dir ());
         register_link_undo (&undo, l, NULL);
       }
       end_undo_set (&undo, "LEVEL MIRROR LINKS R.");
@@ -1506,14 +1506,14 @@ editor (void)
     break;
   case EDIT_LEVEL_MIRROR_BOTH:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_DEFAULT);
-    str = xasprintf ("L%iMB>", global_level.n);
+    str = xasprintf ("L%iMB>", engine->level.n);
     switch (bmenu_enum (mirror_dir_menu, str)) {
     case -1: case 1: edit = EDIT_LEVEL_MIRROR; break;
     case 'H':
       for (i = 1; i < ROOMS; i++) {
         register_h_room_mirror_con_undo (&undo, i, NULL);
-        memcpy (&l, &global_level.link, sizeof (l));
-        mirror_link (&global_level, i, LEFT, RIGHT);
+        memcpy (&l, &engine->level.link, sizeof (l));
+        mirror_link (&engine->level, i, LEFT, RIGHT);
         register_link_undo (&undo, l, NULL);
       }
       end_undo_set (&undo, "LEVEL MIRROR CONS+LINKS H.");
@@ -1521,8 +1521,8 @@ editor (void)
     case 'V':
       for (i = 1; i < ROOMS; i++) {
         register_v_room_mirror_con_undo (&undo, i, NULL);
-        memcpy (&l, &global_level.link, sizeof (l));
-        mirror_link (&global_level, i, ABOVE, BELOW);
+        memcpy (&l, &engine->level.link, sizeof (l));
+        mirror_link (&engine->level, i, ABOVE, BELOW);
         register_link_undo (&undo, l, NULL);
       }
       end_undo_set (&undo, "LEVEL MIRROR CONS+LINKS V.");
@@ -1531,9 +1531,9 @@ editor (void)
       for (i = 1; i < ROOMS; i++) {
         register_h_room_mirror_con_undo (&undo, i, NULL);
         register_v_room_mirror_con_undo (&undo, i, NULL);
-        memcpy (&l, &global_level.link, sizeof (l));
-        mirror_link (&global_level, i, LEFT, RIGHT);
-        mirror_link (&global_level, i, ABOVE, BELOW);
+        memcpy (&l, &engine->level.link, sizeof (l));
+        mirror_link (&engine->level, i, LEFT, RIGHT);
+        mirror_link (&engine->level, i, ABOVE, BELOW);
         register_link_undo (&undo, l, NULL);
       }
       end_undo_set (&undo, "LEVEL MIRROR CONS+LINKS H+V.");
@@ -1542,8 +1542,8 @@ editor (void)
       for (i = 1; i < ROOMS; i++) {
         register_random_room_mirror_con_undo
           (&undo, i, false, NULL);
-        memcpy (&l, &global_level.link, sizeof (l));
-        mirror_link (&global_level, i, random_dir (), random_dir ());
+        memcpy (&l, &engine->level.link, sizeof (l));
+        mirror_link (&engine->level, i, random_dir (), random_dir ());
         register_link_undo (&undo, l, NULL);
       }
       end_undo_set (&undo, "LEVEL MIRROR CONS+LINKS R.");
@@ -1553,13 +1553,13 @@ editor (void)
     break;
   case EDIT_NOMINAL_NUMBER:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_QUESTION);
-    str = xasprintf ("L%iN>N.NUMBER", global_level.n);
-    switch (bmenu_int (&global_level.nominal_n, NULL, 0, INT_MAX, str, NULL)) {
-    case -1: edit = EDIT_LEVEL; global_level.nominal_n = s; break;
+    str = xasprintf ("L%iN>N.NUMBER", engine->level.n);
+    switch (bmenu_int (&engine->level.nominal_n, NULL, 0, INT_MAX, str, NULL)) {
+    case -1: edit = EDIT_LEVEL; engine->level.nominal_n = s; break;
     case 0: break;
     case 1:
       edit = EDIT_LEVEL;
-      register_int_undo (&undo, &global_level.nominal_n, s, (undo_f) int_undo,
+      register_int_undo (&undo, &engine->level.nominal_n, s, (undo_f) int_undo,
                          "LEVEL NOMINAL NUMBER");
       break;
     default: break;
@@ -1568,59 +1568,59 @@ editor (void)
     break;
   case EDIT_ENVIRONMENT:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_QUESTION);
-    str = xasprintf ("L%iE>", global_level.n);
+    str = xasprintf ("L%iE>", engine->level.n);
     b0 = b1 = false;
-    if (global_level.em == DUNGEON) b0 = true;
-    if (global_level.em == PALACE) b1 = true;
-    em = global_level.em;
+    if (engine->level.em == DUNGEON) b0 = true;
+    if (engine->level.em == PALACE) b1 = true;
+    em = engine->level.em;
     switch (bmenu_bool (environment_menu, str, true, &b0, &b1)) {
-    case -1: edit = EDIT_LEVEL; global_level.em = bb; em = bb; break;
+    case -1: edit = EDIT_LEVEL; engine->level.em = bb; em = bb; break;
     case 0: break;
     case 1:
       edit = EDIT_LEVEL;
-      register_int_undo (&undo, (int *) &global_level.em, bb,
+      register_int_undo (&undo, (int *) &engine->level.em, bb,
                          (undo_f) level_environment_undo,
                          "LEVEL ENVIRONMENT");
       break;
     default:
-      if (b0) global_level.em = DUNGEON;
-      if (b1) global_level.em = PALACE;
-      em = global_level.em;
+      if (b0) engine->level.em = DUNGEON;
+      if (b1) engine->level.em = PALACE;
+      em = engine->level.em;
       break;
     }
     al_free (str);
     break;
   case EDIT_HUE:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_QUESTION);
-    str = xasprintf ("L%iH>", global_level.n);
+    str = xasprintf ("L%iH>", engine->level.n);
     b0 = b1 = b2 = b3 = b4 = 0;
-    if (global_level.hue == HUE_NONE) b0 = true;
-    if (global_level.hue == HUE_GREEN) b1 = true;
-    if (global_level.hue == HUE_GRAY) b2 = true;
-    if (global_level.hue == HUE_YELLOW) b3 = true;
-    if (global_level.hue == HUE_BLUE) b4 = true;
-    hue = global_level.hue;
+    if (engine->level.hue == HUE_NONE) b0 = true;
+    if (engine->level.hue == HUE_GREEN) b1 = true;
+    if (engine->level.hue == HUE_GRAY) b2 = true;
+    if (engine->level.hue == HUE_YELLOW) b3 = true;
+    if (engine->level.hue == HUE_BLUE) b4 = true;
+    hue = engine->level.hue;
     switch (bmenu_bool (hue_menu, str, true, &b0, &b1, &b2, &b3, &b4)) {
-    case -1: edit = EDIT_LEVEL; global_level.hue = bb; hue = bb; break;
+    case -1: edit = EDIT_LEVEL; engine->level.hue = bb; hue = bb; break;
     case 0: break;
     case 1:
       edit = EDIT_LEVEL;
-      register_int_undo (&undo, (int *) &global_level.hue, bb, (undo_f) level_hue_undo,
+      register_int_undo (&undo, (int *) &engine->level.hue, bb, (undo_f) level_hue_undo,
                          "LEVEL HUE");
       break;
     default:
-      if (b0) global_level.hue = HUE_NONE;
-      if (b1) global_level.hue = HUE_GREEN;
-      if (b2) global_level.hue = HUE_GRAY;
-      if (b3) global_level.hue = HUE_YELLOW;
-      if (b4) global_level.hue = HUE_BLUE;
-      hue = global_level.hue;
+      if (b0) engine->level.hue = HUE_NONE;
+      if (b1) engine->level.hue = HUE_GREEN;
+      if (b2) engine->level.hue = HUE_GRAY;
+      if (b3) engine->level.hue = HUE_YELLOW;
+      if (b4) engine->level.hue = HUE_BLUE;
+      hue = engine->level.hue;
       break;
     }
     al_free (str);
     break;
   case EDIT_GUARD:
-    g = guard (&global_level, guard_index);
+    g = guard (&engine->level, guard_index);
     al_set_system_mouse_cursor (display, is_guard_by_type (g->type)
                              ? ALLEGRO_SYSTEM_MOUSE_CURSOR_DEFAULT
                              : ALLEGRO_SYSTEM_MOUSE_CURSOR_UNAVAILABLE);
@@ -1707,7 +1707,7 @@ editor (void)
     break;
   case EDIT_GUARD_SKILL:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_DEFAULT);
-    g = guard (&global_level, guard_index);
+    g = guard (&engine->level, guard_index);
     str = xasprintf ("G%iK>", guard_index);
     c = bmenu_enum (skill_menu, str);
     if (! c) break;
@@ -1743,7 +1743,7 @@ editor (void)
     break;
   case EDIT_SKILL_LEGACY_TEMPLATES:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_QUESTION);
-    g = guard (&global_level, guard_index);
+    g = guard (&engine->level, guard_index);
     str = xasprintf ("G%iKL>L.SKILL", guard_index);
     c = bmenu_int (&s, NULL, 0, 11, str, NULL);
     if (! c) break;
@@ -1818,7 +1818,7 @@ editor (void)
     break;
   case EDIT_GUARD_TYPE:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_QUESTION);
-    g = guard (&global_level, guard_index);
+    g = guard (&engine->level, guard_index);
     if (! is_guard_by_type (g->type)
         && g->p.room == 0 && g->p.floor == 0 && g->p.place == 0)
       invalid_pos (&g->p);
@@ -1855,7 +1855,7 @@ editor (void)
     break;
   case EDIT_GUARD_STYLE:
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_QUESTION);
-    g = guard (&global_level, guard_index);
+    g = guard (&engine->level, guard_index);
     str = xasprintf ("G%iY>STYLE", guard_index);
     switch (bmenu_int (&g->style, NULL, 0, 7, str, NULL)) {
     case -1: edit = EDIT_GUARD; g->style = bb; break;
@@ -1972,7 +1972,7 @@ bmenu_link (enum dir dir)
 
   if (r == 1) {
     struct room_linking l[ROOMS];
-    memcpy (&l, &global_level.link, sizeof (l));
+    memcpy (&l, &engine->level.link, sizeof (l));
     editor_link (last_mouse_coord.c.room, mr.room, dir);
     register_link_undo (&undo, l, "LINK");
     set_mouse_coord (&last_mouse_coord);
@@ -1985,7 +1985,7 @@ bmenu_link (enum dir dir)
 static void
 mouse2guard (int i)
 {
-  struct guard *g = guard (&global_level, i);
+  struct guard *g = guard (&engine->level, i);
   if (is_guard_by_type (g->type)
       && is_valid_pos (&g->p)) {
     al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_LINK);
@@ -2070,27 +2070,27 @@ ui_place_guard (struct anim *g, struct pos *p)
 void
 editor_link (int room0, int room1, enum dir dir)
 {
-  *roomd_ptr (&global_level, room0, dir) = room1;
-  if (reciprocal_links) make_reciprocal_link (&global_level, room0, room1, dir);
+  *roomd_ptr (&engine->level, room0, dir) = room1;
+  if (reciprocal_links) make_reciprocal_link (&engine->level, room0, room1, dir);
 
   if (locally_unique_links) {
-    make_link_locally_unique (&global_level, room0, dir);
+    make_link_locally_unique (&engine->level, room0, dir);
     if (reciprocal_links)
-      make_link_locally_unique (&global_level, room1, opposite_dir (dir));
+      make_link_locally_unique (&engine->level, room1, opposite_dir (dir));
   }
 
   if (globally_unique_links) {
-    make_link_globally_unique (&global_level, room0, dir);
+    make_link_globally_unique (&engine->level, room0, dir);
     if (reciprocal_links)
-      make_link_globally_unique (&global_level, room1, opposite_dir (dir));
+      make_link_globally_unique (&engine->level, room1, opposite_dir (dir));
   }
 }
 
 void
 editor_mirror_link (int room, enum dir dir0, enum dir dir1)
 {
-  int r0 = roomd (&global_level, room, dir0);
-  int r1 = roomd (&global_level, room, dir1);
+  int r0 = roomd (&engine->level, room, dir0);
+  int r1 = roomd (&engine->level, room, dir1);
   editor_link (room, r0, dir1);
   editor_link (room, r1, dir0);
 }
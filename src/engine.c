@@ -0,0 +1,346 @@
+/*
+  engine.c -- engine context module;
+
+  Copyright (C) 2015, 2016, 2017 Bruno Félix Rezende Ribeiro
+  <oitofelix@gnu.org>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mininim.h"
+
+/* Most simulation state is owned by an engine context, reached
+   through the 'engine' pointer.  The pointer is per thread and
+   'set_engine' rebinds it, but that doesn't make engines independent:
+   the multi-room origin, the kid's skill and the level modules' own
+   state are still process globals, shared by every engine.  Thus only
+   the main engine is ever computed, and another engine may only be
+   bound on the main thread, between cycles, to inspect or edit it.
+   Running a second engine concurrently (say, a replay worker on a
+   thread instead of a forked process) would need that remaining state
+   moved in here first.  The state the main engine's simulation depends
+   on is registered with 'register_engine_state' for snapshots to carry
+   it. */
+struct engine main_engine;
+THREAD_LOCAL struct engine *engine = &main_engine;
+
+struct engine *
+set_engine (struct engine *e)
+{
+  struct engine *prev = engine;
+  engine = e ? e : &main_engine;
+  return prev;
+}
+
+
+
+/*********************************************************************
+ * Snapshots
+ *********************************************************************/
+
+/* A snapshot is a single contiguous buffer made of a header, a copy of
+   the engine structure and the contents of every array it owns, in
+   the same order as they appear in 'struct engine'.  Actors keep
+   pointers to action functions and bitmaps, so a snapshot is only
+   meaningful to the running process that took it (and the processes
+   forked from it afterwards), hence snapshots are kept in memory only.
+   Snapshots of the main engine also carry every registered module
+   state.  Lua state is not part of snapshots. */
+
+struct engine_snapshot_header {
+  char signature[sizeof (ENGINE_SNAPSHOT_SIGNATURE)];
+  uint32_t version;
+  uint64_t size;
+  uintptr_t level;
+  uint64_t state_size;
+};
+
+struct engine_state {
+  void *ptr;
+  size_t size;
+};
+
+/* Module state not owned by any engine yet, but which the main
+   engine's simulation depends on.  Snapshots of the main engine
+   include it. */
+static struct engine_state *engine_state;
+static size_t engine_state_nmemb;
+
+static char *snapshot_array (char *ptr, void *base, size_t nmemb,
+                             size_t size);
+static const char *restore_array (const char *ptr, void **base,
+                                  size_t *nmemb, size_t src_nmemb,
+                                  size_t size);
+static void relocate_engine (struct engine *e, struct level *from);
+static size_t get_engine_state_size (struct engine *e);
+
+void
+init_engine (void)
+{
+  register_engine_state (&mr.room, sizeof (mr.room));
+  register_engine_state (&mr.x, sizeof (mr.x));
+  register_engine_state (&mr.y, sizeof (mr.y));
+  register_legacy_level_state ();
+}
+
+void
+finalize_engine (void)
+{
+  destroy_array ((void **) &engine_state, &engine_state_nmemb);
+}
+
+void
+register_engine_state (void *ptr, size_t size)
+{
+  size_t i;
+  for (i = 0; i < engine_state_nmemb; i++)
+    if (engine_state[i].ptr == ptr) return;
+
+  struct engine_state es = {ptr, size};
+  engine_state =
+    add_to_array (&es, 1, engine_state, &engine_state_nmemb,
+                  engine_state_nmemb, sizeof (es));
+}
+
+struct engine_snapshot *
+snapshot_engine (struct engine *e, struct engine_snapshot *s)
+{
+  size_t state_size = get_engine_state_size (e);
+  size_t size = sizeof (struct engine_snapshot_header)
+    + sizeof (*e)
+    + e->anima_nmemb * sizeof (*e->anima)
+    + e->door_nmemb * sizeof (*e->door)
+    + e->loose_floor_nmemb * sizeof (*e->loose_floor)
+    + e->spikes_floor_nmemb * sizeof (*e->spikes_floor)
+    + e->chopper_nmemb * sizeof (*e->chopper)
+    + e->opener_floor_nmemb * sizeof (*e->opener_floor)
+    + e->closer_floor_nmemb * sizeof (*e->closer_floor)
+    + e->level_door_nmemb * sizeof (*e->level_door)
+    + state_size;
+
+  /* reuse the previous buffer whenever possible */
+  if (s->capacity < size) {
+    s->data = xrealloc (s->data, size);
+    s->capacity = size;
+  }
+  s->size = size;
+
+  struct engine_snapshot_header h;
+  memset (&h, 0, sizeof (h));
+  strcpy (h.signature, ENGINE_SNAPSHOT_SIGNATURE);
+  h.version = ENGINE_SNAPSHOT_VERSION;
+  h.size = size;
+  h.level = (uintptr_t) &e->level;
+  h.state_size = state_size;
+
+  char *ptr = s->data;
+  memcpy (ptr, &h, sizeof (h));
+  ptr += sizeof (h);
+  memcpy (ptr, e, sizeof (*e));
+  ptr += sizeof (*e);
+
+  ptr = snapshot_array (ptr, e->anima, e->anima_nmemb,
+                        sizeof (*e->anima));
+  ptr = snapshot_array (ptr, e->door, e->door_nmemb,
+                        sizeof (*e->door));
+  ptr = snapshot_array (ptr, e->loose_floor, e->loose_floor_nmemb,
+                        sizeof (*e->loose_floor));
+  ptr = snapshot_array (ptr, e->spikes_floor, e->spikes_floor_nmemb,
+                        sizeof (*e->spikes_floor));
+  ptr = snapshot_array (ptr, e->chopper, e->chopper_nmemb,
+                        sizeof (*e->chopper));
+  ptr = snapshot_array (ptr, e->opener_floor, e->opener_floor_nmemb,
+                        sizeof (*e->opener_floor));
+  ptr = snapshot_array (ptr, e->closer_floor, e->closer_floor_nmemb,
+                        sizeof (*e->closer_floor));
+  ptr = snapshot_array (ptr, e->level_door, e->level_door_nmemb,
+                        sizeof (*e->level_door));
+
+  size_t i;
+  if (state_size)
+    for (i = 0; i < engine_state_nmemb; i++)
+      ptr = snapshot_array (ptr, engine_state[i].ptr, 1,
+                            engine_state[i].size);
+
+  return s;
+}
+
+bool
+restore_engine (struct engine *e, struct engine_snapshot *s)
+{
+  struct engine_snapshot_header h;
+  struct engine src;
+
+  if (s->size < sizeof (h) + sizeof (src)) return false;
+
+  const char *ptr = s->data;
+  memcpy (&h, ptr, sizeof (h));
+  ptr += sizeof (h);
+
+  if (strcmp (h.signature, ENGINE_SNAPSHOT_SIGNATURE)
+      || h.version != ENGINE_SNAPSHOT_VERSION
+      || h.size != s->size
+      || h.state_size != get_engine_state_size (e))
+    return false;
+
+  memcpy (&src, ptr, sizeof (src));
+  ptr += sizeof (src);
+
+  e->level = src.level;
+  e->random_seed = src.random_seed;
+  e->random_seed_backup = src.random_seed_backup;
+  e->anim_cycle = src.anim_cycle;
+  e->play_time = src.play_time;
+  e->play_time_stopped = src.play_time_stopped;
+  e->current_kid_id = src.current_kid_id;
+  e->last_fellow_shadow_id = src.last_fellow_shadow_id;
+  e->camera_follow_kid = src.camera_follow_kid;
+  e->death_timer = src.death_timer;
+
+  ptr = restore_array (ptr, (void **) &e->anima, &e->anima_nmemb,
+                       src.anima_nmemb, sizeof (*e->anima));
+  e->anim_index_valid = false;
+  ptr = restore_array (ptr, (void **) &e->door, &e->door_nmemb,
+                       src.door_nmemb, sizeof (*e->door));
+  ptr = restore_array (ptr, (void **) &e->loose_floor,
+                       &e->loose_floor_nmemb,
+                       src.loose_floor_nmemb, sizeof (*e->loose_floor));
+  ptr = restore_array (ptr, (void **) &e->spikes_floor,
+                       &e->spikes_floor_nmemb,
+                       src.spikes_floor_nmemb, sizeof (*e->spikes_floor));
+  ptr = restore_array (ptr, (void **) &e->chopper, &e->chopper_nmemb,
+                       src.chopper_nmemb, sizeof (*e->chopper));
+  ptr = restore_array (ptr, (void **) &e->opener_floor,
+                       &e->opener_floor_nmemb,
+                       src.opener_floor_nmemb, sizeof (*e->opener_floor));
+  ptr = restore_array (ptr, (void **) &e->closer_floor,
+                       &e->closer_floor_nmemb,
+                       src.closer_floor_nmemb, sizeof (*e->closer_floor));
+  ptr = restore_array (ptr, (void **) &e->level_door,
+                       &e->level_door_nmemb,
+                       src.level_door_nmemb, sizeof (*e->level_door));
+
+  size_t i;
+  if (h.state_size)
+    for (i = 0; i < engine_state_nmemb; i++) {
+      memcpy (engine_state[i].ptr, ptr, engine_state[i].size);
+      ptr += engine_state[i].size;
+    }
+
+  if (h.level != (uintptr_t) &e->level)
+    relocate_engine (e, (struct level *) h.level);
+
+  return true;
+}
+
+void
+free_engine_snapshot (struct engine_snapshot *s)
+{
+  al_free (s->data);
+  memset (s, 0, sizeof (*s));
+}
+
+static size_t
+get_engine_state_size (struct engine *e)
+{
+  if (e != &main_engine) return 0;
+
+  size_t i, size = 0;
+  for (i = 0; i < engine_state_nmemb; i++)
+    size += engine_state[i].size;
+  return size;
+}
+
+static char *
+snapshot_array (char *ptr, void *base, size_t nmemb, size_t size)
+{
+  if (nmemb > 0) memcpy (ptr, base, nmemb * size);
+  return ptr + nmemb * size;
+}
+
+static const char *
+restore_array (const char *ptr, void **base, size_t *nmemb,
+               size_t src_nmemb, size_t size)
+{
+  if (src_nmemb == 0) destroy_array (base, nmemb);
+  else {
+    if (src_nmemb != *nmemb) *base = xrealloc (*base, src_nmemb * size);
+    memcpy (*base, ptr, src_nmemb * size);
+    *nmemb = src_nmemb;
+  }
+  return ptr + src_nmemb * size;
+}
+
+/* Positions and coordinates refer to the level they belong to.  When a
+   snapshot is restored into another engine, make those referring to
+   the source engine's level point to the destination engine's own. */
+
+static void
+relocate_pos (struct pos *p, struct level *from, struct level *to)
+{
+  if (p->l == from) p->l = to;
+}
+
+static void
+relocate_frame (struct frame *f, struct level *from, struct level *to)
+{
+  if (f->c.l == from) f->c.l = to;
+  if (f->oc.l == from) f->oc.l = to;
+}
+
+static void
+relocate_engine (struct engine *e, struct level *from)
+{
+  struct level *to = &e->level;
+  size_t i, j;
+
+  relocate_pos (&to->start_pos, from, to);
+  for (i = 0; i < EVENTS; i++) relocate_pos (&to->event[i].p, from, to);
+  for (i = 0; i < GUARDS; i++) relocate_pos (&to->guard[i].p, from, to);
+
+  for (i = 0; i < e->anima_nmemb; i++) {
+    struct anim *a = &e->anima[i];
+    relocate_frame (&a->f, from, to);
+    relocate_frame (&a->of, from, to);
+    relocate_pos (&a->ci.kid_p, from, to);
+    relocate_pos (&a->ci.con_p, from, to);
+    relocate_pos (&a->p, from, to);
+    relocate_pos (&a->item_pos, from, to);
+    relocate_pos (&a->hang_pos, from, to);
+    relocate_pos (&a->enemy_pos, from, to);
+    relocate_pos (&a->cross_mirror_p, from, to);
+    for (j = 0; j < 2; j++) {
+      relocate_pos (&a->df_pos[j], from, to);
+      relocate_pos (&a->df_posb[j], from, to);
+    }
+  }
+
+  for (i = 0; i < e->door_nmemb; i++)
+    relocate_pos (&e->door[i].p, from, to);
+  for (i = 0; i < e->loose_floor_nmemb; i++) {
+    relocate_pos (&e->loose_floor[i].p, from, to);
+    relocate_pos (&e->loose_floor[i].original_pos, from, to);
+    relocate_frame (&e->loose_floor[i].f, from, to);
+  }
+  for (i = 0; i < e->spikes_floor_nmemb; i++)
+    relocate_pos (&e->spikes_floor[i].p, from, to);
+  for (i = 0; i < e->chopper_nmemb; i++)
+    relocate_pos (&e->chopper[i].p, from, to);
+  for (i = 0; i < e->opener_floor_nmemb; i++)
+    relocate_pos (&e->opener_floor[i].p, from, to);
+  for (i = 0; i < e->closer_floor_nmemb; i++)
+    relocate_pos (&e->closer_floor[i].p, from, to);
+  for (i = 0; i < e->level_door_nmemb; i++)
+    relocate_pos (&e->level_door[i].p, from, to);
+}
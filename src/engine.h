@@ -0,0 +1,49 @@
+/*
+  engine.h -- engine context module;
+
+  Copyright (C) 2015, 2016, 2017 Bruno Félix Rezende Ribeiro
+  <oitofelix@gnu.org>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MININIM_ENGINE_H
+#define MININIM_ENGINE_H
+
+#define ENGINE_SNAPSHOT_SIGNATURE "MININIM SNAPSHOT"
+#define ENGINE_SNAPSHOT_VERSION 3
+
+struct engine_snapshot {
+  void *data;
+  size_t size;
+  size_t capacity;
+};
+
+/* functions */
+void init_engine (void);
+void finalize_engine (void);
+struct engine *set_engine (struct engine *e);
+void register_engine_state (void *ptr, size_t size);
+
+/* snapshots */
+struct engine_snapshot *snapshot_engine (struct engine *e,
+                                         struct engine_snapshot *s);
+bool restore_engine (struct engine *e, struct engine_snapshot *s);
+void free_engine_snapshot (struct engine_snapshot *s);
+
+/* variables */
+extern struct engine main_engine;
+extern THREAD_LOCAL struct engine *engine;
+
+#endif	/* MININIM_ENGINE_H */
@@ -133,8 +133,8 @@ enter_fight_logic (struct anim *k)
     return;
 
   int i;
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *a = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *a = &engine->anima[i];
 
     /* no dead character is a valid opponent */
     if (a->current_lives <= 0) continue;
@@ -227,8 +227,8 @@ fight_ai (struct anim *k)
 
   /* for all characters... */
   int i;
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *a = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *a = &engine->anima[i];
 
     /* no dead character is a valid opponent */
     if (a->current_lives <= 0) continue;
@@ -247,10 +247,10 @@ fight_ai (struct anim *k)
                  || ! is_safe_to_follow (k, ke, k->f.dir))))
         && is_hearing (k, a)
         && is_on_back (k, a)
-        && anim_cycle - k->alert_cycle > 24) {
+        && engine->anim_cycle - k->alert_cycle > 24) {
       if (is_in_fight_mode (k)) fight_turn (k);
       else k->f.dir = (k->f.dir == LEFT) ? RIGHT : LEFT;
-      k->alert_cycle = anim_cycle;
+      k->alert_cycle = engine->anim_cycle;
       return;
     }
   }
@@ -1165,8 +1165,8 @@ fight_turn_controllable (struct anim *k)
 
   /* make the kid target the nearest enemy targeting him */
   size_t i;
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *a = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *a = &engine->anima[i];
     if (a->enemy_id != k->id || ! is_fightable_anim (a))
       continue;
     int de = dist_enemy (a);
@@ -1180,8 +1180,8 @@ fight_turn_controllable (struct anim *k)
   else t = -1;
 
   if (ke && abs (dist_enemy (k) - d) > t) {
-    for (i = 0; i < anima_nmemb; i++) {
-      struct anim *a = &anima[i];
+    for (i = 0; i < engine->anima_nmemb; i++) {
+      struct anim *a = &engine->anima[i];
       if (a->id == k->id || (a->id != 0 && a->shadow_of != 0))
         continue;
       int da = dist_anims (k, a);
@@ -1264,7 +1264,7 @@ fight_hit (struct anim *k, struct anim *ke)
   if (k->current_lives <= 0 && ! is_strictly_traversable (&pb)) {
     k->current_lives = 0;
     k->death_reason = FIGHT_DEATH;
-    ke->alert_cycle = anim_cycle;
+    ke->alert_cycle = engine->anim_cycle;
     /* prevent kid from passing through a collidable */
     if (is_kid_hang (&k->f))
       k->f.c.x += k->f.dir == LEFT ? +8 : -8;
@@ -1281,7 +1281,7 @@ fight_hit (struct anim *k, struct anim *ke)
   kid_haptic (k, KID_HAPTIC_HARM);
   kid_haptic (ke, KID_HAPTIC_HARM);
 
-  if (k->id == current_kid_id) {
+  if (k->id == engine->current_kid_id) {
     mr.flicker = 2;
     mr.color = get_flicker_blood_color ();
     play_audio (&harm_audio, NULL, k->id);
@@ -1371,13 +1371,13 @@ void
 alert_guards (struct pos *p)
 {
   int i;
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *g = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *g = &engine->anima[i];
     if (is_guard (g) && is_pos_on_back (g, p)
         && g->current_lives > 0 && g->enemy_id == -1
-        && anim_cycle - g->alert_cycle > 24) {
+        && engine->anim_cycle - g->alert_cycle > 24) {
       invert_frame_dir (&g->f, &g->f);
-      g->alert_cycle = anim_cycle;
+      g->alert_cycle = engine->anim_cycle;
     }
   }
 }
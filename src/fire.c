@@ -92,7 +92,7 @@ draw_fire (ALLEGRO_BITMAP* bitmap, struct pos *p, enum vm vm)
   if (bg (p) != TORCH) return;
 
   ALLEGRO_BITMAP *fire =
-    get_fire_frame (prandom_pos_uniq (p, anim_cycle, 1, 8), vm);
+    get_fire_frame (prandom_pos_uniq (p, engine->anim_cycle, 1, 8), vm);
 
   if (peq (p, &mouse_pos))
     fire = apply_palette (fire, selection_palette);
@@ -111,7 +111,7 @@ flow (struct anim *g)
 
   if (g->oaction == guard_normal
       && g->current_lives <= 0
-      && anim_cycle > 0) {
+      && engine->anim_cycle > 0) {
     survey (_mt, pos, &g->f, NULL, &pmt, NULL);
     g->p = pmt;
     guard_die (g);
@@ -120,7 +120,7 @@ flow (struct anim *g)
 
   if (g->oaction == guard_normal
       && vigilant
-      && anim_cycle > 0) {
+      && engine->anim_cycle > 0) {
     guard_vigilant (g);
     return false;
   }
@@ -653,7 +653,7 @@ draw_start_guards (ALLEGRO_BITMAP *bitmap, enum vm vm)
 {
   int i;
   for (i = 0; i < GUARDS; i++) {
-    struct guard *g = guard (&global_level, i);
+    struct guard *g = guard (&engine->level, i);
     if (g->type == NO_ANIM) continue;
     struct frame f;
     f.c.room = g->p.room;
@@ -723,7 +723,7 @@ draw_guard_lives (ALLEGRO_BITMAP *bitmap, struct anim *g, enum vm vm)
 
   if (hgc) life = apply_palette (life, hgc_palette);
 
-  if (current_lives <= GUARD_MINIMUM_LIVES_TO_BLINK && anim_cycle % 2) {
+  if (current_lives <= GUARD_MINIMUM_LIVES_TO_BLINK && engine->anim_cycle % 2) {
       pop_clipping_rectangle ();
       return;
   }
@@ -120,14 +120,14 @@ play_audio (struct audio_source *as, struct pos *p, int anim_id)
 
   /* do nothing if the same sample has been played in a near cycle */
   struct audio_instance *sai =
-    search_audio_instance (as, anim_cycle, NULL, -1);
+    search_audio_instance (as, engine->anim_cycle, NULL, -1);
   if (sai) return sai->data;
 
   struct audio_instance ai;
 
   ai.source = as;
   ai.played = false;
-  ai.anim_cycle = anim_cycle;
+  ai.anim_cycle = engine->anim_cycle;
   ai.anim_id = anim_id;
   ai.volume = -1;
 
@@ -62,7 +62,7 @@ get_mouse_coord (struct mouse_coord *m)
   if (flags & ALLEGRO_FLIP_VERTICAL)
     y = (sh - 1) - y;
 
-  m->c.l = &global_level;
+  m->c.l = &engine->level;
 
   if (y < 3 || y >= sh - 8 || x < 0 || x > sw - 1) {
     m->x = m->y = -1;
@@ -221,7 +221,7 @@ set_mouse_room (int room)
     mr_set_origin (room, x, y);
 
   mr_save_origin (&m.mr);
-  new_coord (&m.c, &global_level, room, ORIGINAL_WIDTH / 2, ORIGINAL_HEIGHT / 2);
+  new_coord (&m.c, &engine->level, room, ORIGINAL_WIDTH / 2, ORIGINAL_HEIGHT / 2);
   set_mouse_coord (&m);
 
   if (! room) {
@@ -0,0 +1,262 @@
+/*
+  profiler.c -- engine profiler module;
+
+  Copyright (C) 2015, 2016, 2017 Bruno Félix Rezende Ribeiro
+  <oitofelix@gnu.org>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mininim.h"
+
+/* Scoped timers around the main engine stages.  Every thread that
+   enters a scope gets a ring buffer of its own, where it records the
+   scopes it leaves, so recording never takes a lock.  Only the owner
+   thread writes to a ring, and it publishes each event by advancing
+   the ring head once the event is in place.  Readers take the head,
+   copy the events behind it and drop those the owner might have
+   overwritten in the meantime.  Times come from 'al_get_time', which
+   is monotonic.
+
+   Scopes are pushed onto a per thread stack, along with their id,
+   whether the profiler is on or not, so that switching it on or off
+   inside a scope never leaves the stack unbalanced.  Only scopes
+   entered while it was on are recorded.
+
+   Resetting the statistics doesn't touch the rings either: it starts
+   a new epoch, and each owner clears its totals as soon as it notices
+   the epoch has changed. */
+
+struct profiler_event {
+  double begin, end;
+  enum profiler_scope scope;
+  int depth;
+};
+
+struct profiler_scope_stats {
+  uint64_t count;
+  double total, max;
+};
+
+struct profiler_frame {
+  double begin;
+  enum profiler_scope scope;
+  bool on;
+};
+
+struct profiler_ring {
+  struct profiler_event *event;
+  uint64_t head;
+  unsigned int epoch;
+  int tid;
+  struct profiler_scope_stats stats[PROFILER_SCOPES];
+  struct profiler_ring *next;
+};
+
+bool engine_profiling;
+char *profiler_trace_filename;
+
+static struct profiler_ring *profiler_rings;
+static int profiler_ring_nmemb;
+static unsigned int profiler_epoch;
+static double profiler_epoch_time;
+
+static THREAD_LOCAL struct profiler_ring *profiler_ring;
+static THREAD_LOCAL struct profiler_frame profiler_stack[PROFILER_DEPTH_MAX];
+static THREAD_LOCAL int profiler_depth;
+
+static const char *profiler_scope_names[PROFILER_SCOPES] = {
+  [COMPUTE_LEVEL_SCOPE] = "compute_level",
+  [DRAW_MULTI_ROOMS_SCOPE] = "draw_multi_rooms",
+  [FLIP_DISPLAY_SCOPE] = "flip_display",
+  [APPLY_PALETTE_SCOPE] = "apply_palette",
+  [UPDATE_CACHE_SCOPE] = "update_cache",
+};
+
+static struct profiler_ring *
+get_profiler_ring (void)
+{
+  if (profiler_ring) return profiler_ring;
+
+  struct profiler_ring *r = xcalloc (1, sizeof (*r));
+  r->event = xcalloc (PROFILER_RING_SIZE, sizeof (*r->event));
+  r->epoch = __atomic_load_n (&profiler_epoch, __ATOMIC_ACQUIRE);
+  r->tid = __atomic_add_fetch (&profiler_ring_nmemb, 1, __ATOMIC_RELAXED);
+
+  r->next = __atomic_load_n (&profiler_rings, __ATOMIC_ACQUIRE);
+  while (! __atomic_compare_exchange_n (&profiler_rings, &r->next, r, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+
+  return profiler_ring = r;
+}
+
+void
+begin_profiler_scope (enum profiler_scope s)
+{
+  int depth = profiler_depth++;
+  if (depth >= PROFILER_DEPTH_MAX) return;
+  struct profiler_frame *f = &profiler_stack[depth];
+  f->scope = s;
+  f->on = engine_profiling;
+  if (f->on) f->begin = al_get_time ();
+}
+
+/* Scopes entered while the profiler was off are left without any
+   record, and so is any scope that doesn't match the innermost one
+   entered, which would only come from unbalanced calls. */
+void
+end_profiler_scope (enum profiler_scope s)
+{
+  if (! profiler_depth) return;
+  int depth = --profiler_depth;
+  if (depth >= PROFILER_DEPTH_MAX) return;
+  struct profiler_frame *f = &profiler_stack[depth];
+  if (! f->on || f->scope != s) return;
+
+  double end = al_get_time ();
+  double begin = f->begin;
+  struct profiler_ring *r = get_profiler_ring ();
+
+  unsigned int epoch = __atomic_load_n (&profiler_epoch, __ATOMIC_ACQUIRE);
+  if (r->epoch != epoch) {
+    memset (r->stats, 0, sizeof (r->stats));
+    r->epoch = epoch;
+  }
+  if (begin < profiler_epoch_time) return;
+
+  struct profiler_scope_stats *st = &r->stats[s];
+  st->count++;
+  st->total += end - begin;
+  if (end - begin > st->max) st->max = end - begin;
+
+  uint64_t head = r->head;
+  struct profiler_event *e = &r->event[head % PROFILER_RING_SIZE];
+  e->begin = begin;
+  e->end = end;
+  e->scope = s;
+  e->depth = depth;
+  __atomic_store_n (&r->head, head + 1, __ATOMIC_RELEASE);
+}
+
+void
+reset_profiler_scopes (void)
+{
+  profiler_epoch_time = al_get_time ();
+  __atomic_add_fetch (&profiler_epoch, 1, __ATOMIC_RELEASE);
+}
+
+const char *
+profiler_scope_name (enum profiler_scope s)
+{
+  return profiler_scope_names[s];
+}
+
+/* Return how many times scope S has been left in the current epoch,
+   summed over all threads, storing the total and the maximum time
+   spent in it into TOTAL and MAX */
+uint64_t
+get_profiler_scope_stats (enum profiler_scope s, double *total, double *max)
+{
+  uint64_t count = 0;
+  *total = *max = 0;
+
+  unsigned int epoch = __atomic_load_n (&profiler_epoch, __ATOMIC_ACQUIRE);
+
+  struct profiler_ring *r;
+  for (r = __atomic_load_n (&profiler_rings, __ATOMIC_ACQUIRE);
+       r; r = r->next) {
+    if (r->epoch != epoch) continue;
+    count += r->stats[s].count;
+    *total += r->stats[s].total;
+    if (r->stats[s].max > *max) *max = r->stats[s].max;
+  }
+
+  return count;
+}
+
+/* Write every event still held by the rings to FILENAME in the Chrome
+   trace event format, loadable by 'chrome://tracing' and compatible
+   viewers */
+bool
+write_profiler_trace (const char *filename)
+{
+  ALLEGRO_FILE *f = al_fopen (filename, "w");
+  if (! f) return false;
+
+  struct profiler_event *event =
+    xmalloc (PROFILER_RING_SIZE * sizeof (*event));
+  bool first = true;
+
+  al_fputs (f, "{\"traceEvents\":[");
+
+  struct profiler_ring *r;
+  for (r = __atomic_load_n (&profiler_rings, __ATOMIC_ACQUIRE);
+       r; r = r->next) {
+    uint64_t head = __atomic_load_n (&r->head, __ATOMIC_ACQUIRE);
+    uint64_t tail = head > PROFILER_RING_SIZE
+      ? head - PROFILER_RING_SIZE : 0;
+
+    uint64_t i;
+    for (i = tail; i < head; i++)
+      event[i - tail] = r->event[i % PROFILER_RING_SIZE];
+
+    /* drop what the owner overwrote while the events were copied,
+       including the slot of event NEW_HEAD, which it may be writing
+       right now */
+    __atomic_thread_fence (__ATOMIC_ACQUIRE);
+    uint64_t new_head = __atomic_load_n (&r->head, __ATOMIC_RELAXED);
+    i = new_head >= PROFILER_RING_SIZE
+      ? new_head - PROFILER_RING_SIZE + 1 : 0;
+    if (i < tail) i = tail;
+
+    for (; i < head; i++) {
+      struct profiler_event *e = &event[i - tail];
+      if (e->begin < profiler_epoch_time) continue;
+      al_fprintf (f, "%s\n{\"name\":\"%s\",\"cat\":\"engine\",\"ph\":\"X\","
+                  "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%i,"
+                  "\"args\":{\"depth\":%i}}", first ? "" : ",",
+                  profiler_scope_names[e->scope], e->begin * 1e6,
+                  (e->end - e->begin) * 1e6, r->tid, e->depth);
+      first = false;
+    }
+  }
+
+  al_fputs (f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+  al_free (event);
+  bool error = al_ferror (f);
+  al_fclose (f);
+  return ! error;
+}
+
+void
+finalize_profiler (void)
+{
+  if (profiler_trace_filename && ! is_replay_worker ()
+      && ! write_profiler_trace (profiler_trace_filename))
+    error (0, al_get_errno (), "can't write profiler trace '%s'",
+           profiler_trace_filename);
+
+  engine_profiling = false;
+
+  struct profiler_ring *r, *next;
+  for (r = profiler_rings; r; r = next) {
+    next = r->next;
+    al_free (r->event);
+    al_free (r);
+  }
+  profiler_rings = NULL;
+  profiler_ring = NULL;
+  profiler_depth = 0;
+}
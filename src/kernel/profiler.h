@@ -0,0 +1,38 @@
+/*
+  profiler.h -- engine profiler module;
+
+  Copyright (C) 2015, 2016, 2017 Bruno Félix Rezende Ribeiro
+  <oitofelix@gnu.org>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MININIM_PROFILER_H
+#define MININIM_PROFILER_H
+
+/* functions */
+void begin_profiler_scope (enum profiler_scope s);
+void end_profiler_scope (enum profiler_scope s);
+void reset_profiler_scopes (void);
+const char *profiler_scope_name (enum profiler_scope s);
+uint64_t get_profiler_scope_stats (enum profiler_scope s,
+                                   double *total, double *max);
+bool write_profiler_trace (const char *filename);
+void finalize_profiler (void);
+
+/* variables */
+extern bool engine_profiling;
+extern char *profiler_trace_filename;
+
+#endif	/* MININIM_PROFILER_H */
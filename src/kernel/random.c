@@ -20,18 +20,15 @@
 
 #include "mininim.h"
 
-/* random number generator seed */
-uint32_t random_seed = 0;
-static uint32_t random_seedb = 0;
 unsigned int mrandom_seed;
 
 int
 prandom (int max)
 {
-	if (! random_seed) random_seed = time (NULL);
-	random_seed = random_seed * 214013 + 2531011;
-  if (! random_seed) random_seed = 1;
-	return (random_seed >> 16) % (max + 1);
+	if (! engine->random_seed) engine->random_seed = time (NULL);
+	engine->random_seed = engine->random_seed * 214013 + 2531011;
+  if (! engine->random_seed) engine->random_seed = 1;
+	return (engine->random_seed >> 16) % (max + 1);
 }
 
 int
@@ -55,26 +52,26 @@ prandom_max (void)
 int
 prandom_uniq (uint32_t seed, int period, int max)
 {
-  uint32_t random_seed_backup = random_seed;
+  uint32_t random_seed_backup = engine->random_seed;
 
-  random_seed = seed - seed % period;
+  engine->random_seed = seed - seed % period;
   int prev_random = prandom (max);
 
   if (seed % period) {
-    random_seed = random_seed_backup;
+    engine->random_seed = random_seed_backup;
     return prev_random;
   }
 
-  random_seed = (seed - 1) - (seed - 1) % period;
+  engine->random_seed = (seed - 1) - (seed - 1) % period;
   prev_random = prandom (max);
 
-  random_seed = seed;
+  engine->random_seed = seed;
   int next_random = prandom (max);
 
   if (prev_random == next_random)
     next_random = (next_random + 1) % (max + 1);
 
-  random_seed = random_seed_backup;
+  engine->random_seed = random_seed_backup;
 
   return next_random;
 }
@@ -102,19 +99,19 @@ void
 seedp (struct pos *p)
 {
   struct pos np; npos (p, &np);
-  random_seedb = random_seed;
-  random_seed = np.room + np.floor * PLACES + np.place;
+  engine->random_seed_backup = engine->random_seed;
+  engine->random_seed = np.room + np.floor * PLACES + np.place;
   /* a null random seed makes the random number generator get a
      non-null seed based on the current time, but we avoid this
      non-deterministic behavior because it affects the position
      (0,0,0) odly */
-  random_seed = random_seed ? random_seed : UINT32_MAX;
+  engine->random_seed = engine->random_seed ? engine->random_seed : UINT32_MAX;
 }
 
 void
 unseedp (void)
 {
-  random_seed = random_seedb;
+  engine->random_seed = engine->random_seed_backup;
 }
 
 int
@@ -123,8 +120,8 @@ prandom_seq (uint32_t seed, int n, int p, int max)
   uint32_t orand_seed;
   int i, r0 = -1, r1 = -1;
 
-	orand_seed = random_seed;
-	random_seed = seed;
+	orand_seed = engine->random_seed;
+	engine->random_seed = seed;
   prandom (1);
 
   for (i = 0; i <= n; i++) {
@@ -135,7 +132,7 @@ prandom_seq (uint32_t seed, int n, int p, int max)
     r0 = r1;
   }
 
-  random_seed = orand_seed;
+  engine->random_seed = orand_seed;
   return r1;
 }
 
@@ -22,7 +22,6 @@
 #define MININIM_RANDOM_H
 
 /* random number generator seed */
-extern uint32_t random_seed;
 extern unsigned int mrandom_seed;
 
 /* functions */
@@ -0,0 +1,218 @@
+/*
+  telemetry.c -- telemetry module;
+
+  Copyright (C) 2015, 2016, 2017 Bruno Félix Rezende Ribeiro
+  <oitofelix@gnu.org>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mininim.h"
+
+/* Per cycle timings of the main loop are kept in log-linear
+   histograms: microsecond values are split by their highest set bit
+   and then into TELEMETRY_SUB_BUCKETS linear steps, so any value is
+   known to within about 6% no matter its magnitude, in constant
+   space.  Each metric has a histogram for the whole session, which is
+   dumped at exit, and another for the last TELEMETRY_WINDOW cycles,
+   which is shown by the overlay. */
+
+struct telemetry_histogram {
+  uint64_t count[TELEMETRY_BUCKETS];
+  uint64_t total;
+};
+
+struct telemetry_series {
+  struct telemetry_histogram session, window;
+  uint16_t sample[TELEMETRY_WINDOW];
+  size_t next;
+  double sum, max;
+};
+
+bool telemetry_overlay;
+char *telemetry_filename;
+
+static struct telemetry_series telemetry[TELEMETRY_METRICS];
+static uint64_t dropped_frames;
+
+static const char *telemetry_names[TELEMETRY_METRICS] = {
+  [COMPUTE_TELEMETRY] = "COMPUTE",
+  [DRAW_TELEMETRY] = "DRAW",
+  [FLIP_TELEMETRY] = "FLIP",
+  [WAIT_TELEMETRY] = "WAIT",
+  [FRAME_TELEMETRY] = "FRAME",
+};
+
+static int
+telemetry_bucket (double t)
+{
+  uint64_t v = t > 0 ? t * 1e6 : 0;
+  if (v < TELEMETRY_SUB_BUCKETS) return v;
+
+  int e = TELEMETRY_SUB_BUCKET_BITS;
+  while (v >> (e + 1)) e++;
+
+  int i = (e - TELEMETRY_SUB_BUCKET_BITS + 1) * TELEMETRY_SUB_BUCKETS
+    + (v >> (e - TELEMETRY_SUB_BUCKET_BITS)) - TELEMETRY_SUB_BUCKETS;
+  return min_int (i, TELEMETRY_BUCKETS - 1);
+}
+
+/* Highest value, in seconds, that falls into bucket I */
+static double
+telemetry_bucket_value (int i)
+{
+  if (i < TELEMETRY_SUB_BUCKETS) return (i + 1) / 1e6;
+  int e = i / TELEMETRY_SUB_BUCKETS + TELEMETRY_SUB_BUCKET_BITS - 1;
+  uint64_t m = i % TELEMETRY_SUB_BUCKETS + TELEMETRY_SUB_BUCKETS;
+  return ((m + 1) << (e - TELEMETRY_SUB_BUCKET_BITS)) / 1e6;
+}
+
+static double
+histogram_percentile (struct telemetry_histogram *h, double q)
+{
+  if (! h->total) return 0;
+
+  uint64_t rank = ceil (q * h->total);
+  if (rank < 1) rank = 1;
+
+  uint64_t n = 0;
+  int i;
+  for (i = 0; i < TELEMETRY_BUCKETS; i++)
+    if ((n += h->count[i]) >= rank) break;
+
+  return telemetry_bucket_value (min_int (i, TELEMETRY_BUCKETS - 1));
+}
+
+/* Record T seconds spent this cycle in metric M */
+void
+record_telemetry (enum telemetry_metric m, double t)
+{
+  struct telemetry_series *s = &telemetry[m];
+  int b = telemetry_bucket (t);
+
+  s->session.count[b]++;
+  s->session.total++;
+  s->sum += t;
+  if (t > s->max) s->max = t;
+
+  if (s->window.total == TELEMETRY_WINDOW) {
+    s->window.count[s->sample[s->next]]--;
+    s->window.total--;
+  }
+  s->sample[s->next] = b;
+  s->next = (s->next + 1) % TELEMETRY_WINDOW;
+  s->window.count[b]++;
+  s->window.total++;
+
+  if (m == FRAME_TELEMETRY && anim_freq > 0
+      && t > TELEMETRY_DROPPED_FRAME_FACTOR / anim_freq)
+    dropped_frames++;
+}
+
+/* Return the Q quantile of metric M, in seconds, over the last
+   TELEMETRY_WINDOW cycles if WINDOW is true, or over the whole
+   session otherwise */
+double
+telemetry_percentile (enum telemetry_metric m, bool window, double q)
+{
+  struct telemetry_series *s = &telemetry[m];
+  return histogram_percentile (window ? &s->window : &s->session, q);
+}
+
+void
+draw_telemetry_overlay (ALLEGRO_BITMAP *bitmap)
+{
+  if (! telemetry_overlay
+      || rendering == NONE_RENDERING || rendering == AUDIO_RENDERING)
+    return;
+
+  int lines = TELEMETRY_METRICS + 2;
+  int y = CUTSCENE_HEIGHT - 8 - lines * 8 - 2;
+
+  push_reset_clipping_rectangle (bitmap);
+
+  draw_filled_rectangle (bitmap, 0, y - 1, CUTSCENE_WIDTH - 1,
+                         CUTSCENE_HEIGHT - 10, BLACK);
+
+  draw_text (bitmap, "MS          P50    P99    MAX", 0, y, 0);
+  y += 8;
+
+  enum telemetry_metric m;
+  for (m = 0; m < TELEMETRY_METRICS; m++) {
+    char *text = xasprintf
+      ("%-8s %6.2f %6.2f %6.2f", telemetry_names[m],
+       telemetry_percentile (m, true, 0.50) * 1000,
+       telemetry_percentile (m, true, 0.99) * 1000,
+       telemetry_percentile (m, true, 1) * 1000);
+    draw_text (bitmap, text, 0, y, 0);
+    al_free (text);
+    y += 8;
+  }
+
+  char *text = xasprintf ("DROPPED FRAMES: %ju", dropped_frames);
+  draw_text (bitmap, text, 0, y, 0);
+  al_free (text);
+
+  pop_clipping_rectangle ();
+}
+
+/* Write a summary of every metric over the whole session, followed by
+   its non-empty histogram buckets, to FILENAME */
+bool
+write_telemetry (const char *filename)
+{
+  ALLEGRO_FILE *f = al_fopen (filename, "w");
+  if (! f) return false;
+
+  al_fprintf (f, "# cycles: %ju, dropped frames: %ju\n",
+              telemetry[FRAME_TELEMETRY].session.total, dropped_frames);
+  al_fprintf (f, "# %-8s %10s %9s %9s %9s %9s %9s %9s\n", "metric",
+              "count", "mean", "p50", "p90", "p99", "p99.9", "max");
+
+  enum telemetry_metric m;
+  for (m = 0; m < TELEMETRY_METRICS; m++) {
+    struct telemetry_series *s = &telemetry[m];
+    uint64_t n = s->session.total;
+    al_fprintf (f, "%-10s %10ju %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n",
+                telemetry_names[m], n, n ? s->sum / n * 1000 : 0,
+                histogram_percentile (&s->session, 0.5) * 1000,
+                histogram_percentile (&s->session, 0.9) * 1000,
+                histogram_percentile (&s->session, 0.99) * 1000,
+                histogram_percentile (&s->session, 0.999) * 1000,
+                s->max * 1000);
+  }
+
+  al_fprintf (f, "# %-8s %12s %10s\n", "metric", "up to (ms)", "count");
+  for (m = 0; m < TELEMETRY_METRICS; m++) {
+    int i;
+    for (i = 0; i < TELEMETRY_BUCKETS; i++)
+      if (telemetry[m].session.count[i])
+        al_fprintf (f, "%-10s %12.3f %10ju\n", telemetry_names[m],
+                    telemetry_bucket_value (i) * 1000,
+                    telemetry[m].session.count[i]);
+  }
+
+  bool error = al_ferror (f);
+  al_fclose (f);
+  return ! error;
+}
+
+void
+finalize_telemetry (void)
+{
+  if (telemetry_filename && ! is_replay_worker ()
+      && ! write_telemetry (telemetry_filename))
+    error (0, al_get_errno (), "can't write telemetry '%s'",
+           telemetry_filename);
+}
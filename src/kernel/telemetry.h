@@ -0,0 +1,36 @@
+/*
+  telemetry.h -- telemetry module;
+
+  Copyright (C) 2015, 2016, 2017 Bruno Félix Rezende Ribeiro
+  <oitofelix@gnu.org>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MININIM_TELEMETRY_H
+#define MININIM_TELEMETRY_H
+
+/* functions */
+void record_telemetry (enum telemetry_metric m, double t);
+double telemetry_percentile (enum telemetry_metric m, bool window,
+                             double q);
+void draw_telemetry_overlay (ALLEGRO_BITMAP *bitmap);
+bool write_telemetry (const char *filename);
+void finalize_telemetry (void);
+
+/* variables */
+extern bool telemetry_overlay;
+extern char *telemetry_filename;
+
+#endif	/* MININIM_TELEMETRY_H */
@@ -41,15 +41,73 @@ int display_mode = -1;
 bool about_screen;
 ALLEGRO_BITMAP *oitofelix_face_gray, *oitofelix_face_bw;
 
+/* Palette cache: open addressing hash table, with linear probing, of
+   entries keyed on input bitmap and palette, which are also linked in
+   least recently used order for eviction.  Entries added or hit while
+   pinning is on are linked in a list of their own instead, are never
+   evicted and don't count towards the size limit, until unpinned. */
 static struct palette_cache {
   ALLEGRO_BITMAP *ib, *ob;
   palette pal;
-  double time;
-} *palette_cache;
+  size_t size;
+  bool lua, pinned;
+  struct palette_cache *prev, *next;
+} **palette_cache;
+static size_t palette_cache_capacity;
 static size_t palette_cache_nmemb;
 static size_t palette_cache_size;
+static struct palette_cache *palette_cache_mru, *palette_cache_lru;
+static struct palette_cache *palette_cache_pinned;
+static bool palette_cache_pinning;
+
+/* Compiled palettes: a color lookup table per palette key and video
+   mode, filled as colors are first seen, so each palette function is
+   called at most once per distinct color in each mode.  Some palettes
+   (like 'selection_palette') depend on the video mode, environment
+   mode, Hercules flag and hue, so tables are told apart by those too.
+   Apart from that, palettes are taken to be pure functions of the
+   color.  Tables are kept sorted by key and mode for binary
+   search. */
+static struct palette_lut {
+  const void *k;
+  int mode;
+  bool lua;
+  struct palette_lut_entry {
+    uint32_t c0, c1;
+    bool set;
+  } *e;
+  size_t nmemb, capacity;
+} *palette_lut;
+static size_t palette_lut_nmemb;
 ssize_t palette_cache_size_limit = 4 * 1024 * 1024;
 
+/* Bitmap atlas: while active, loaded sprites are copied into a few
+   large pages, shelf by shelf, and handed out as sub-bitmaps, so
+   consecutive draws of different sprites share a texture.  Pages
+   live until the video module is finalized. */
+static struct bitmap_atlas {
+  bool active;
+  ALLEGRO_BITMAP **page;
+  size_t page_nmemb;
+  int x, y, shelf_h;
+} bitmap_atlas;
+
+/* Draw batch: bitmap draws into one target, recorded with the
+   clipping rectangle in effect at the time and submitted together
+   under held drawing by flush_draw_batch. */
+static struct draw_batch {
+  ALLEGRO_BITMAP *to;
+  struct draw_command {
+    ALLEGRO_BITMAP *from, *texture;
+    float sx, sy, sw, sh, dx, dy;
+    int flags;
+    int cx, cy, cw, ch;
+    int layer;
+    size_t i;
+  } *c;
+  size_t nmemb, capacity;
+} draw_batch;
+
 struct drawn_rectangle drawn_rectangle_stack[DRAWN_RECTANGLE_STACK_NMEMB_MAX];
 size_t drawn_rectangle_stack_nmemb;
 
@@ -151,6 +209,7 @@ finalize_video (void)
   destroy_bitmap (uscreen);
   destroy_bitmap (effect_buffer);
   destroy_bitmap (black_screen);
+  destroy_bitmap_atlas ();
   al_destroy_font (builtin_font);
   al_destroy_timer (video_timer);
   al_destroy_display (display);
@@ -277,11 +336,104 @@ load_bitmap (const char *filename)
 
   validate_bitmap_for_mingw (bitmap);
 
+  if (bitmap_atlas.active) bitmap = pack_bitmap (bitmap);
+
   if (load_callback) load_callback ();
 
   return bitmap;
 }
 
+void
+start_bitmap_atlas (void)
+{
+  bitmap_atlas.active = true;
+}
+
+void
+stop_bitmap_atlas (void)
+{
+  bitmap_atlas.active = false;
+}
+
+void
+destroy_bitmap_atlas (void)
+{
+  size_t i;
+  for (i = 0; i < bitmap_atlas.page_nmemb; i++)
+    destroy_bitmap (bitmap_atlas.page[i]);
+  destroy_array ((void **) &bitmap_atlas.page, &bitmap_atlas.page_nmemb);
+  bitmap_atlas.x = bitmap_atlas.y = bitmap_atlas.shelf_h = 0;
+}
+
+static ALLEGRO_BITMAP *
+new_bitmap_atlas_page (void)
+{
+  ALLEGRO_BITMAP *page =
+    create_bitmap (BITMAP_ATLAS_PAGE_SIZE, BITMAP_ATLAS_PAGE_SIZE);
+  if (! page) return NULL;
+  clear_bitmap (page, TRANSPARENT_COLOR);
+
+  bitmap_atlas.page =
+    add_to_array (&page, 1, bitmap_atlas.page, &bitmap_atlas.page_nmemb,
+                  bitmap_atlas.page_nmemb, sizeof (page));
+  bitmap_atlas.x = bitmap_atlas.y = bitmap_atlas.shelf_h = 0;
+  return page;
+}
+
+/* Copy BITMAP into the current atlas page and return a sub-bitmap of
+   the page in its place, destroying BITMAP.  Bitmaps too large for a
+   page, or failures to get one, leave BITMAP untouched. */
+ALLEGRO_BITMAP *
+pack_bitmap (ALLEGRO_BITMAP *bitmap)
+{
+  if (! bitmap) return NULL;
+
+  int w = al_get_bitmap_width (bitmap);
+  int h = al_get_bitmap_height (bitmap);
+  int p = BITMAP_ATLAS_PADDING;
+
+  if (w + 2 * p > BITMAP_ATLAS_PAGE_SIZE
+      || h + 2 * p > BITMAP_ATLAS_PAGE_SIZE)
+    return bitmap;
+
+  ALLEGRO_BITMAP *page = bitmap_atlas.page_nmemb
+    ? bitmap_atlas.page[bitmap_atlas.page_nmemb - 1] : NULL;
+
+  /* next shelf */
+  if (page && bitmap_atlas.x + w + 2 * p > BITMAP_ATLAS_PAGE_SIZE) {
+    bitmap_atlas.x = 0;
+    bitmap_atlas.y += bitmap_atlas.shelf_h;
+    bitmap_atlas.shelf_h = 0;
+  }
+
+  /* next page */
+  if (! page || bitmap_atlas.y + h + 2 * p > BITMAP_ATLAS_PAGE_SIZE) {
+    page = new_bitmap_atlas_page ();
+    if (! page) return bitmap;
+  }
+
+  int x = bitmap_atlas.x + p;
+  int y = bitmap_atlas.y + p;
+
+  /* copy pixels verbatim, alpha included, whatever the rendering
+     mode */
+  int op, src, dst;
+  al_get_blender (&op, &src, &dst);
+  al_set_blender (ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_ZERO);
+  set_target_bitmap (page);
+  al_draw_bitmap (bitmap, x, y, 0);
+  al_set_blender (op, src, dst);
+
+  ALLEGRO_BITMAP *sub = al_create_sub_bitmap (page, x, y, w, h);
+  if (! sub) return bitmap;
+
+  bitmap_atlas.x += w + p;
+  bitmap_atlas.shelf_h = max_int (bitmap_atlas.shelf_h, h + p);
+
+  destroy_bitmap (bitmap);
+  return sub;
+}
+
 void
 validate_bitmap_for_mingw (ALLEGRO_BITMAP *bitmap)
 {
@@ -297,6 +449,7 @@ validate_bitmap_for_mingw (ALLEGRO_BITMAP *bitmap)
 void
 destroy_bitmap (ALLEGRO_BITMAP *bitmap)
 {
+  flush_draw_batch ();
   al_destroy_bitmap (bitmap);
 }
 
@@ -332,93 +485,383 @@ set_target_backbuffer (ALLEGRO_DISPLAY *display)
 void
 clear_bitmap (ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR color)
 {
+  flush_draw_batch ();
   set_target_bitmap (bitmap);
   al_clear_to_color (color);
 }
 
-ALLEGRO_BITMAP *
-get_cached_palette (ALLEGRO_BITMAP *bitmap, palette p)
+static size_t
+hash_palette_cache (ALLEGRO_BITMAP *ib, const void *pal)
+{
+  uint64_t h = (uintptr_t) ib;
+  h ^= (uintptr_t) pal + UINT64_C (0x9e3779b97f4a7c15) + (h << 6) + (h >> 2);
+  h ^= h >> 33;
+  h *= UINT64_C (0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  return h;
+}
+
+static size_t
+find_palette_cache_slot (ALLEGRO_BITMAP *ib, const void *pal)
 {
-  struct palette_cache pc, *rpc;
-  pc.ib = bitmap;
-  pc.pal = p;
+  size_t mask = palette_cache_capacity - 1;
+  size_t i = hash_palette_cache (ib, pal) & mask;
+  while (palette_cache[i]
+         && (palette_cache[i]->ib != ib
+             || (void *) palette_cache[i]->pal != pal))
+    i = (i + 1) & mask;
+  return i;
+}
 
-  rpc = bsearch (&pc, palette_cache, palette_cache_nmemb, sizeof (pc),
-                 compare_palette_caches);
+static void
+unlink_palette_cache (struct palette_cache *pc)
+{
+  if (pc->pinned) {
+    if (pc->prev) pc->prev->next = pc->next;
+    else palette_cache_pinned = pc->next;
+    if (pc->next) pc->next->prev = pc->prev;
+    return;
+  }
 
-  if (rpc) return rpc->ob;
-  else return NULL;
+  if (pc->prev) pc->prev->next = pc->next;
+  else palette_cache_mru = pc->next;
+  if (pc->next) pc->next->prev = pc->prev;
+  else palette_cache_lru = pc->prev;
+  palette_cache_size -= pc->size;
 }
 
-int
-compare_palette_caches (const void *pc0, const void *pc1)
+static void
+link_palette_cache (struct palette_cache *pc)
 {
-  struct palette_cache *p0 = (struct palette_cache *) pc0;
-  struct palette_cache *p1 = (struct palette_cache *) pc1;
+  pc->prev = NULL;
 
-  if (p0->ib < p1->ib) return -1;
-  else if (p0->ib > p1->ib) return 1;
-  else if ((void *) p0->pal < (void *) p1->pal) return -1;
-  else if ((void *) p0->pal > (void *) p1->pal) return 1;
-  else return 0;
+  if (pc->pinned) {
+    pc->next = palette_cache_pinned;
+    if (palette_cache_pinned) palette_cache_pinned->prev = pc;
+    palette_cache_pinned = pc;
+    return;
+  }
+
+  pc->next = palette_cache_mru;
+  if (palette_cache_mru) palette_cache_mru->prev = pc;
+  else palette_cache_lru = pc;
+  palette_cache_mru = pc;
+  palette_cache_size += pc->size;
 }
 
-int
-compare_palette_caches_by_time (const void *pc0, const void *pc1)
+static void
+grow_palette_cache (void)
 {
-  struct palette_cache *p0 = (struct palette_cache *) pc0;
-  struct palette_cache *p1 = (struct palette_cache *) pc1;
+  struct palette_cache **old = palette_cache;
+  size_t i, old_capacity = palette_cache_capacity;
+
+  palette_cache_capacity = old_capacity ? 2 * old_capacity : 256;
+  palette_cache = xcalloc (palette_cache_capacity, sizeof (*palette_cache));
+
+  for (i = 0; i < old_capacity; i++)
+    if (old[i])
+      palette_cache[find_palette_cache_slot (old[i]->ib, old[i]->pal)]
+        = old[i];
+
+  al_free (old);
+}
 
-  if (p0->time < p1->time) return -1;
-  else if (p0->time > p1->time) return 1;
-  else return 0;
+void
+set_palette_cache_pinning (bool pin)
+{
+  palette_cache_pinning = pin;
 }
 
+/* Pinned entries are appended to the least recently used end, so
+   they are the first to go once the cache is over its limit */
 void
-remove_palette_cache (lua_State *L, ssize_t i)
+unpin_palette_cache (void)
+{
+  while (palette_cache_pinned) {
+    struct palette_cache *pc = palette_cache_pinned;
+    unlink_palette_cache (pc);
+    pc->pinned = false;
+    pc->prev = palette_cache_lru;
+    pc->next = NULL;
+    if (palette_cache_lru) palette_cache_lru->next = pc;
+    else palette_cache_mru = pc;
+    palette_cache_lru = pc;
+    palette_cache_size += pc->size;
+  }
+}
+
+ALLEGRO_BITMAP *
+get_cached_palette (ALLEGRO_BITMAP *bitmap, palette p)
+{
+  if (! palette_cache_nmemb) return NULL;
+
+  struct palette_cache *pc =
+    palette_cache[find_palette_cache_slot (bitmap, p)];
+  if (! pc) return NULL;
+
+  if (palette_cache_pinning && ! pc->pinned) {
+    unlink_palette_cache (pc);
+    pc->pinned = true;
+    link_palette_cache (pc);
+  } else if (! pc->pinned && pc != palette_cache_mru) {
+    unlink_palette_cache (pc);
+    link_palette_cache (pc);
+  }
+
+  return pc->ob;
+}
+
+static void
+add_palette_cache (ALLEGRO_BITMAP *ib, const void *pal, ALLEGRO_BITMAP *ob,
+                   bool lua)
 {
-  palette_cache_size -= al_get_pixel_size (ALLEGRO_PIXEL_FORMAT_ANY)
-    * al_get_bitmap_width (palette_cache[i].ob)
-    * al_get_bitmap_height (palette_cache[i].ob);
+  /* keep the load factor at most one half */
+  if (2 * (palette_cache_nmemb + 1) > palette_cache_capacity)
+    grow_palette_cache ();
+
+  struct palette_cache *pc = xmalloc (sizeof (*pc));
+  pc->ib = ib;
+  pc->pal = pal;
+  pc->ob = ob;
+  pc->size = al_get_pixel_size (ALLEGRO_PIXEL_FORMAT_ANY)
+    * al_get_bitmap_width (ob) * al_get_bitmap_height (ob);
+  pc->lua = lua;
+  pc->pinned = palette_cache_pinning;
+
+  palette_cache[find_palette_cache_slot (ib, pal)] = pc;
+  palette_cache_nmemb++;
+  link_palette_cache (pc);
+}
 
-  L_get_registry_by_ptr (L, palette_cache[i].ob);
+static void
+remove_palette_cache (lua_State *L, struct palette_cache *pc)
+{
+  L_get_registry_by_ptr (L, pc->ob);
   if (lua_isnil (L, -1)) {
     /* C bitmap */
     lua_pop (L, 1);
-    destroy_bitmap (palette_cache[i].ob);
+    destroy_bitmap (pc->ob);
   } else {
     /* Lua bitmap */
     lua_pop (L, 1);
     lua_pushnil (L);
-    L_set_registry_by_ptr (L, palette_cache[i].ob);
+    L_set_registry_by_ptr (L, pc->ob);
+  }
+
+  /* backward shift deletion, so no tombstones are needed */
+  size_t mask = palette_cache_capacity - 1;
+  size_t i = find_palette_cache_slot (pc->ib, pc->pal);
+  size_t j = i;
+  palette_cache[i] = NULL;
+  for (j = (j + 1) & mask; palette_cache[j]; j = (j + 1) & mask) {
+    size_t k = hash_palette_cache (palette_cache[j]->ib,
+                                   palette_cache[j]->pal) & mask;
+    if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j))) {
+      palette_cache[i] = palette_cache[j];
+      palette_cache[j] = NULL;
+      i = j;
+    }
   }
 
-  palette_cache =
-    remove_from_array (palette_cache, &palette_cache_nmemb, i, 1,
-                       sizeof (*palette_cache));
+  unlink_palette_cache (pc);
+  palette_cache_nmemb--;
+  al_free (pc);
 }
 
-void
-palette_cache_gc (lua_State *L)
+static int
+get_palette_lut_mode (void)
 {
-  ssize_t i;
-  for (i = 0; i < palette_cache_nmemb; i++) {
-    L_get_weak_registry_by_ptr (L, palette_cache[i].ob);
+  return vm | em << 8 | hgc << 16 | hue << 17;
+}
+
+/* Return the index of the table of key K and mode MODE, or of where it
+   should be inserted in case there is none, storing into FOUND whether
+   it's there */
+static size_t
+find_palette_lut (const void *k, int mode, bool *found)
+{
+  size_t lo = 0, hi = palette_lut_nmemb;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    struct palette_lut *l = &palette_lut[mid];
+    if (l->k < k || (l->k == k && l->mode < mode)) lo = mid + 1;
+    else hi = mid;
+  }
+  *found = lo < palette_lut_nmemb && palette_lut[lo].k == k
+    && palette_lut[lo].mode == mode;
+  return lo;
+}
+
+static void
+destroy_palette_lut (struct palette_lut *l)
+{
+  al_free (l->e);
+  size_t i = l - palette_lut;
+  palette_lut =
+    remove_from_array (palette_lut, &palette_lut_nmemb, i, 1,
+                       sizeof (*palette_lut));
+}
+
+static struct palette_lut *
+get_palette_lut (palette p, const void *k)
+{
+  struct palette_lut l;
+  int mode = get_palette_lut_mode ();
+  bool found;
+  size_t i = find_palette_lut (k, mode, &found);
+
+  if (found && palette_lut[i].lua) {
+    /* a collected Lua palette's address may have been reused */
+    L_get_weak_registry_by_ptr (main_L, (void *) k);
+    bool same = lua_rawequal (main_L, -1, -2);
+    lua_pop (main_L, 1);
+    if (same) return &palette_lut[i];
+    destroy_palette_lut (&palette_lut[i]);
+  } else if (found) return &palette_lut[i];
+
+  l.k = k;
+  l.mode = mode;
+  l.lua = p == L_palette;
+  l.nmemb = 0;
+  l.capacity = 64;
+  l.e = xcalloc (l.capacity, sizeof (*l.e));
+
+  /* In case it's a Lua palette, track it for GC */
+  if (l.lua) {
+    lua_pushvalue (main_L, -1);
+    L_set_weak_registry_by_ptr (main_L, (void *) k);
+  }
+
+  palette_lut =
+    add_to_array (&l, 1, palette_lut, &palette_lut_nmemb, i, sizeof (l));
+
+  return &palette_lut[i];
+}
+
+static struct palette_lut_entry *
+find_palette_lut_entry (struct palette_lut *l, uint32_t c)
+{
+  size_t mask = l->capacity - 1;
+  uint32_t h = c ^ (c >> 16);
+  h *= 0x45d9f3b;
+  h ^= h >> 16;
+  size_t i = h & mask;
+  while (l->e[i].set && l->e[i].c0 != c) i = (i + 1) & mask;
+  return &l->e[i];
+}
+
+static uint32_t
+palette_lut_color (struct palette_lut *l, palette p, uint32_t c)
+{
+  struct palette_lut_entry *e = find_palette_lut_entry (l, c);
+  if (e->set) return e->c1;
+
+  /* compile this color */
+  unsigned char rgba[4];
+  memcpy (rgba, &c, sizeof (rgba));
+  ALLEGRO_COLOR r = p (al_map_rgba (rgba[0], rgba[1], rgba[2], rgba[3]));
+  al_unmap_rgba (r, &rgba[0], &rgba[1], &rgba[2], &rgba[3]);
+
+  uint32_t c1;
+  memcpy (&c1, rgba, sizeof (c1));
+
+  /* keep the load factor at most one half */
+  if (2 * (l->nmemb + 1) > l->capacity) {
+    struct palette_lut_entry *old = l->e;
+    size_t i, old_capacity = l->capacity;
+    l->capacity *= 2;
+    l->e = xcalloc (l->capacity, sizeof (*l->e));
+    for (i = 0; i < old_capacity; i++)
+      if (old[i].set) *find_palette_lut_entry (l, old[i].c0) = old[i];
+    al_free (old);
+    e = find_palette_lut_entry (l, c);
+  }
+
+  e->c0 = c;
+  e->c1 = c1;
+  e->set = true;
+  l->nmemb++;
+
+  return c1;
+}
+
+static bool
+apply_palette_lut (ALLEGRO_BITMAP *b, palette p, const void *k)
+{
+  ALLEGRO_LOCKED_REGION *lr =
+    al_lock_bitmap (b, ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE,
+                    ALLEGRO_LOCK_READWRITE);
+  if (! lr) return false;
+
+  struct palette_lut *l = get_palette_lut (p, k);
+
+  int w = al_get_bitmap_width (b);
+  int h = al_get_bitmap_height (b);
+
+  /* sprites come in runs of the same color, so the last translation
+     is tried before the table */
+  uint32_t last_c0 = 0, last_c1 = 0;
+  bool has_last = false;
+
+  int x, y;
+  for (y = 0; y < h; y++) {
+    unsigned char *row = (unsigned char *) lr->data + y * lr->pitch;
+    for (x = 0; x < w; x++) {
+      uint32_t c;
+      memcpy (&c, row + 4 * x, sizeof (c));
+      if (! has_last || c != last_c0) {
+        has_last = true;
+        last_c0 = c;
+        last_c1 = palette_lut_color (l, p, c);
+      }
+      memcpy (row + 4 * x, &last_c1, sizeof (last_c1));
+    }
+  }
+
+  al_unlock_bitmap (b);
+  return true;
+}
+
+/* Only entries made by Lua palettes can have been collected */
+static void
+palette_cache_list_gc (lua_State *L, struct palette_cache *pc)
+{
+  struct palette_cache *next;
+  for (; pc; pc = next) {
+    next = pc->next;
+    if (! pc->lua) continue;
+
+    L_get_weak_registry_by_ptr (L, pc->ob);
     if (lua_isnil (L, -1)) {
       lua_pop (L, 1);
-      remove_palette_cache (L, i--);
+      remove_palette_cache (L, pc);
       continue;
     } else lua_pop (L, 1);
 
-    L_get_weak_registry_by_ptr (L, palette_cache[i].pal);
+    L_get_weak_registry_by_ptr (L, pc->pal);
     if (lua_isnil (L, -1)) {
       lua_pop (L, 1);
-      remove_palette_cache (L, i--);
+      remove_palette_cache (L, pc);
       continue;
     } else lua_pop (L, 1);
   }
 }
 
+void
+palette_cache_gc (lua_State *L)
+{
+  ssize_t i;
+  for (i = 0; i < palette_lut_nmemb; i++) {
+    if (! palette_lut[i].lua) continue;
+    L_get_weak_registry_by_ptr (L, (void *) palette_lut[i].k);
+    if (lua_isnil (L, -1)) destroy_palette_lut (&palette_lut[i--]);
+    lua_pop (L, 1);
+  }
+
+  palette_cache_list_gc (L, palette_cache_mru);
+  palette_cache_list_gc (L, palette_cache_pinned);
+}
+
 void
 enforce_palette_cache_limit (lua_State *L, ALLEGRO_BITMAP *b)
 {
@@ -427,22 +870,8 @@ enforce_palette_cache_limit (lua_State *L, ALLEGRO_BITMAP *b)
   size_t additional_size = al_get_pixel_size (ALLEGRO_PIXEL_FORMAT_ANY)
     * al_get_bitmap_width (b) * al_get_bitmap_height (b);
 
-  if (palette_cache_size + additional_size > palette_cache_size_limit) {
-
-    palette_cache_gc (L);
-
-    if (palette_cache_size + additional_size <= palette_cache_size_limit)
-      return;
-
-    qsort (palette_cache, palette_cache_nmemb, sizeof (*palette_cache),
-           compare_palette_caches_by_time);
-
-    while (palette_cache_size + additional_size > palette_cache_size_limit
-           && palette_cache_nmemb > 0) remove_palette_cache (L, 0);
-
-    qsort (palette_cache, palette_cache_nmemb, sizeof (*palette_cache),
-           compare_palette_caches);
-  }
+  while (palette_cache_size + additional_size > palette_cache_size_limit
+         && palette_cache_lru) remove_palette_cache (L, palette_cache_lru);
 }
 
 ALLEGRO_BITMAP *
@@ -463,16 +892,23 @@ apply_palette_k (ALLEGRO_BITMAP *bitmap, palette p, const void *k)
     enforce_palette_cache_limit (main_L, bitmap);
   }
 
-  int x, y;
+  /* only cache misses are timed, hits being a mere lookup */
+  begin_profiler_scope (APPLY_PALETTE_SCOPE);
+
   ALLEGRO_BITMAP *rbitmap = clone_bitmap (bitmap);
-  int w = al_get_bitmap_width (bitmap);
-  int h = al_get_bitmap_height (bitmap);
-  al_lock_bitmap (rbitmap, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READWRITE);
-  set_target_bitmap (rbitmap);
-  for (y = 0; y < h; y++)
-    for (x = 0; x < w; x++)
-      al_put_pixel (x, y, p (al_get_pixel (rbitmap, x, y)));
-  al_unlock_bitmap (rbitmap);
+
+  if (! apply_palette_lut (rbitmap, p, k)) {
+    int x, y;
+    int w = al_get_bitmap_width (bitmap);
+    int h = al_get_bitmap_height (bitmap);
+    al_lock_bitmap (rbitmap, ALLEGRO_PIXEL_FORMAT_ANY,
+                    ALLEGRO_LOCK_READWRITE);
+    set_target_bitmap (rbitmap);
+    for (y = 0; y < h; y++)
+      for (x = 0; x < w; x++)
+        al_put_pixel (x, y, p (al_get_pixel (rbitmap, x, y)));
+    al_unlock_bitmap (rbitmap);
+  }
 
   if (palette_cache_size_limit) {
     /* In case it's Lua bitmap and palette */
@@ -486,24 +922,27 @@ apply_palette_k (ALLEGRO_BITMAP *bitmap, palette p, const void *k)
       L_set_registry_by_ptr (main_L, rbitmap);
     }
 
-    struct palette_cache pc;
-    pc.ib = bitmap;
-    pc.pal = k;
-    pc.ob = rbitmap;
-    pc.time = al_get_time ();
+    add_palette_cache (bitmap, k, rbitmap, p == L_palette);
+  }
 
-    palette_cache_size += al_get_pixel_size (ALLEGRO_PIXEL_FORMAT_ANY)
-      * w * h;
+  end_profiler_scope (APPLY_PALETTE_SCOPE);
 
-    palette_cache =
-      add_to_array (&pc, 1, palette_cache, &palette_cache_nmemb,
-                    palette_cache_nmemb, sizeof (pc));
+  return rbitmap;
+}
 
-    qsort (palette_cache, palette_cache_nmemb, sizeof (pc),
-           compare_palette_caches);
-  }
+/* Translate a single color through the compiled palette of key K */
+ALLEGRO_COLOR
+apply_palette_to_color_k (ALLEGRO_COLOR c, palette p, const void *k)
+{
+  unsigned char rgba[4];
+  al_unmap_rgba (c, &rgba[0], &rgba[1], &rgba[2], &rgba[3]);
 
-  return rbitmap;
+  uint32_t c0;
+  memcpy (&c0, rgba, sizeof (c0));
+  uint32_t c1 = palette_lut_color (get_palette_lut (p, k), p, c0);
+  memcpy (rgba, &c1, sizeof (rgba));
+
+  return al_map_rgba (rgba[0], rgba[1], rgba[2], rgba[3]);
 }
 
 bool
@@ -571,6 +1010,8 @@ draw_bitmap_region (ALLEGRO_BITMAP *from, ALLEGRO_BITMAP *to,
   if (rendering == NONE_RENDERING || rendering == AUDIO_RENDERING)
     return;
 
+  if (to != draw_batch.to) flush_draw_batch ();
+
   merge_drawn_rectangle (to, dx, dy, sw, sh);
   set_target_bitmap (to);
 
@@ -579,16 +1020,138 @@ draw_bitmap_region (ALLEGRO_BITMAP *from, ALLEGRO_BITMAP *to,
 
   if (cw <= 0 || ch <= 0) return;
 
+  if (to == draw_batch.to) {
+    if (draw_batch.nmemb == draw_batch.capacity) {
+      draw_batch.capacity = draw_batch.capacity
+        ? 2 * draw_batch.capacity : 256;
+      draw_batch.c = xrealloc (draw_batch.c, draw_batch.capacity
+                               * sizeof (*draw_batch.c));
+    }
+    struct draw_command *dc = &draw_batch.c[draw_batch.nmemb];
+    ALLEGRO_BITMAP *parent = al_get_parent_bitmap (from);
+    dc->from = from;
+    dc->texture = parent ? parent : from;
+    dc->sx = sx; dc->sy = sy; dc->sw = sw; dc->sh = sh;
+    dc->dx = dx; dc->dy = dy;
+    dc->flags = flags;
+    dc->cx = cx; dc->cy = cy; dc->cw = cw; dc->ch = ch;
+    dc->i = draw_batch.nmemb++;
+    return;
+  }
+
   al_draw_bitmap_region (from, sx, sy, sw, sh, dx, dy, flags);
 }
 
+/* Draws into TO are recorded instead of issued, until the batch is
+   ended or flushed.  Any other kind of drawing, drawing into another
+   target and destroying a bitmap flush the batch first. */
+void
+start_draw_batch (ALLEGRO_BITMAP *to)
+{
+  flush_draw_batch ();
+  draw_batch.to = to;
+}
+
+void
+end_draw_batch (void)
+{
+  flush_draw_batch ();
+  draw_batch.to = NULL;
+}
+
+static bool
+draw_commands_overlap (struct draw_command *c0, struct draw_command *c1)
+{
+  int x0, y0, w0, h0, x1, y1, w1, h1;
+  intersection_rectangle (c0->dx, c0->dy, c0->sw, c0->sh,
+                          c0->cx, c0->cy, c0->cw, c0->ch,
+                          &x0, &y0, &w0, &h0);
+  intersection_rectangle (c1->dx, c1->dy, c1->sw, c1->sh,
+                          c1->cx, c1->cy, c1->cw, c1->ch,
+                          &x1, &y1, &w1, &h1);
+  return intersection_rectangle (x0, y0, w0, h0, x1, y1, w1, h1,
+                                 &x0, &y0, &w0, &h0);
+}
+
+static int
+compare_draw_commands (const void *_c0, const void *_c1)
+{
+  const struct draw_command *c0 = _c0;
+  const struct draw_command *c1 = _c1;
+
+  if (c0->layer != c1->layer) return c0->layer < c1->layer ? -1 : 1;
+  if (c0->cx != c1->cx) return c0->cx < c1->cx ? -1 : 1;
+  if (c0->cy != c1->cy) return c0->cy < c1->cy ? -1 : 1;
+  if (c0->cw != c1->cw) return c0->cw < c1->cw ? -1 : 1;
+  if (c0->ch != c1->ch) return c0->ch < c1->ch ? -1 : 1;
+  if (c0->texture != c1->texture)
+    return (uintptr_t) c0->texture < (uintptr_t) c1->texture ? -1 : 1;
+  if (c0->i != c1->i) return c0->i < c1->i ? -1 : 1;
+  return 0;
+}
+
+/* Submit the recorded draws.  Each draw is put on the layer right
+   above the highest earlier draw it overlaps, so sorting by layer
+   keeps the painter's order wherever it matters, while draws within
+   a layer are free to be grouped by clipping rectangle and texture.
+   Every run of a same clipping rectangle is one held-drawing batch. */
+void
+flush_draw_batch (void)
+{
+  if (! draw_batch.nmemb) return;
+
+  struct draw_command *c = draw_batch.c;
+  size_t i, j, n = draw_batch.nmemb;
+  int max_layer = -1;
+
+  /* empty the batch first, as drawing below must not record */
+  draw_batch.nmemb = 0;
+  ALLEGRO_BITMAP *to = draw_batch.to;
+  draw_batch.to = NULL;
+
+  for (i = 0; i < n; i++) {
+    c[i].layer = 0;
+    for (j = i; j-- > 0 && c[i].layer <= max_layer;)
+      if (c[j].layer >= c[i].layer && draw_commands_overlap (&c[j], &c[i]))
+        c[i].layer = c[j].layer + 1;
+    max_layer = max_int (max_layer, c[i].layer);
+  }
+
+  qsort (c, n, sizeof (*c), compare_draw_commands);
+
+  ALLEGRO_BITMAP *target = al_get_target_bitmap ();
+  set_target_bitmap (to);
+
+  int cx, cy, cw, ch;
+  al_get_clipping_rectangle (&cx, &cy, &cw, &ch);
+
+  for (i = 0; i < n; i = j) {
+    al_set_clipping_rectangle (c[i].cx, c[i].cy, c[i].cw, c[i].ch);
+    al_hold_bitmap_drawing (true);
+    for (j = i; j < n && c[j].cx == c[i].cx && c[j].cy == c[i].cy
+           && c[j].cw == c[i].cw && c[j].ch == c[i].ch; j++)
+      al_draw_bitmap_region (c[j].from, c[j].sx, c[j].sy, c[j].sw, c[j].sh,
+                             c[j].dx, c[j].dy, c[j].flags);
+    al_hold_bitmap_drawing (false);
+  }
+
+  al_set_clipping_rectangle (cx, cy, cw, ch);
+  if (target) set_target_bitmap (target);
+
+  draw_batch.to = to;
+}
+
 void
 draw_rectangle (ALLEGRO_BITMAP *to, float x1, float y1,
                 float x2, float y2, ALLEGRO_COLOR color,
                 float thickness)
 {
+  flush_draw_batch ();
   if (rendering == NONE_RENDERING || rendering == AUDIO_RENDERING)
     return;
+  int t = ceil (thickness);
+  merge_drawn_rectangle (to, x1 - t, y1 - t,
+                         x2 - x1 + 2 + 2 * t, y2 - y1 + 1 + 2 * t);
   set_target_bitmap (to);
   al_draw_rectangle (x1 + 1, y1, x2 + 1, y2, color, thickness);
 }
@@ -597,8 +1160,10 @@ void
 draw_filled_rectangle (ALLEGRO_BITMAP *to, float x1, float y1,
                        float x2, float y2, ALLEGRO_COLOR color)
 {
+  flush_draw_batch ();
   if (rendering == NONE_RENDERING || rendering == AUDIO_RENDERING)
     return;
+  merge_drawn_rectangle (to, x1, y1, x2 - x1 + 1, y2 - y1 + 1);
   set_target_bitmap (to);
   al_draw_filled_rectangle (x1, y1, x2 + 1, y2 + 1, color);
 }
@@ -606,6 +1171,13 @@ draw_filled_rectangle (ALLEGRO_BITMAP *to, float x1, float y1,
 void
 draw_text (ALLEGRO_BITMAP *bitmap, char const *text, float x, float y, int flags)
 {
+  flush_draw_batch ();
+  int tw = al_get_text_width (builtin_font, text);
+  int tx = x;
+  if (flags & ALLEGRO_ALIGN_CENTRE) tx -= tw / 2 + 1;
+  else if (flags & ALLEGRO_ALIGN_RIGHT) tx -= tw;
+  merge_drawn_rectangle (bitmap, tx, y, tw + 1,
+                         al_get_font_line_height (builtin_font));
   set_target_bitmap (bitmap);
   al_draw_text (builtin_font, WHITE, x, y, flags, text);
 }
@@ -726,6 +1298,8 @@ draw_mr_select_rect (int x, int y, ALLEGRO_COLOR color)
 void
 flip_display (ALLEGRO_BITMAP *bitmap)
 {
+  begin_profiler_scope (FLIP_DISPLAY_SCOPE);
+
   int w = al_get_display_width (display);
   int h = al_get_display_height (display);
 
@@ -751,9 +1325,14 @@ flip_display (ALLEGRO_BITMAP *bitmap)
     int iw = al_get_bitmap_width (iscreen);
     int ih = al_get_bitmap_height (iscreen);
 
+    bool full_redraw = mr.last.display_width != w
+      || mr.last.display_height != h
+      || force_full_redraw || no_room_drawing;
+
     if (iw != w || ih != h) {
       destroy_bitmap (iscreen);
       iscreen = clone_bitmap (al_get_backbuffer (display));
+      full_redraw = true;
     }
 
     al_set_target_bitmap (iscreen);
@@ -762,24 +1341,38 @@ flip_display (ALLEGRO_BITMAP *bitmap)
     int tw, th;
     mr_get_resolution (&tw, &th);
 
+    /* Only the screen area of each cell that changed since it was
+       last drawn is scaled into the intermediate screen; the rest of
+       it is still there from previous frames. */
     for (y = mr.h - 1; y >= 0; y--)
       for (x = 0; x < mr.w; x++) {
+        struct multi_room_cell *c = &mr.cell[x][y];
         ALLEGRO_BITMAP *screen =
-          (mr.cell[x][y].room || no_room_drawing)
-          ? mr.cell[x][y].screen : mr.cell[x][y].cache;
+          (c->room || no_room_drawing) ? c->screen : c->cache;
         int sw = al_get_bitmap_width (screen);
         int sh = al_get_bitmap_height (screen);
-        float dx = ((ORIGINAL_WIDTH * x) * w) / (float) tw;
-        float dy = ((ROOM_HEIGHT * y) * h) / (float) th;
-        float dw = (sw * w) / (float) tw;
-        float dh = (sh * h) / (float) th;
-
-        if (mr.cell[x][y].room
-            || mr.last.display_width != w
-            || mr.last.display_height != h
-            || force_full_redraw)
+        float sx = w / (float) tw;
+        float sy = h / (float) th;
+        float dx = ORIGINAL_WIDTH * x * sx;
+        float dy = ROOM_HEIGHT * y * sy;
+
+        int rx, ry, rw, rh;
+        if (full_redraw) {
+          rx = ry = 0;
+          rw = sw;
+          rh = sh;
+        } else if (! c->room
+                   || ! intersection_rectangle
+                   (c->dirty.x - 1, c->dirty.y - 1,
+                    c->dirty.w + 2, c->dirty.h + 2,
+                    0, 0, sw, sh, &rx, &ry, &rw, &rh)) rw = rh = 0;
+
+        c->dirty.w = c->dirty.h = 0;
+
+        if (rw > 0 && rh > 0)
           al_draw_scaled_bitmap
-            (screen, 0, 0, sw, sh, dx, dy, dw, dh, 0);
+            (screen, rx, ry, rw, rh, dx + rx * sx, dy + ry * sy,
+             rw * sx, rh * sy, 0);
       }
 
     set_target_backbuffer (display);
@@ -825,6 +1418,8 @@ flip_display (ALLEGRO_BITMAP *bitmap)
   al_flip_display ();
 
   force_full_redraw = false;
+
+  end_profiler_scope (FLIP_DISPLAY_SCOPE);
 }
 
 int
@@ -869,6 +1464,7 @@ void
 draw_pattern (ALLEGRO_BITMAP *bitmap, int ox, int oy, int w, int h,
               ALLEGRO_COLOR color_0, ALLEGRO_COLOR color_1)
 {
+  flush_draw_batch ();
   int x, y;
   set_target_bitmap (bitmap);
   al_lock_bitmap (bitmap, ALLEGRO_PIXEL_FORMAT_ANY,
@@ -1153,7 +1749,14 @@ pop_drawn_rectangle (void)
 {
   assert (drawn_rectangle_stack_nmemb > 0);
   drawn_rectangle_stack_nmemb--;
-  return &drawn_rectangle_stack[drawn_rectangle_stack_nmemb];
+  struct drawn_rectangle *dr =
+    &drawn_rectangle_stack[drawn_rectangle_stack_nmemb];
+
+  /* what has been drawn has been drawn for any enclosing rectangle of
+     the same bitmap as well */
+  merge_drawn_rectangle (dr->bitmap, dr->x, dr->y, dr->w, dr->h);
+
+  return dr;
 }
 
 void
@@ -1289,7 +1892,7 @@ show_logo_replaying (void)
 {
   char *text0, *text1;
   int progress; update_replay_progress (&progress);
-  text0 = xasprintf ("Level: %02u", global_level.n);
+  text0 = xasprintf ("Level: %02u", engine->level.n);
   text1 = xasprintf ("Replaying: %3u%%", progress);
 
   show_logo (text0, text1, NULL);
@@ -37,6 +37,10 @@ ALLEGRO_BITMAP *load_scaled_memory_bitmap (char *filename, int w, int h,
 ALLEGRO_BITMAP *clone_scaled_memory_bitmap (ALLEGRO_BITMAP *bitmap, int w,
                                             int h, int flags);
 ALLEGRO_BITMAP *load_bitmap (const char *filename);
+void start_bitmap_atlas (void);
+void stop_bitmap_atlas (void);
+void destroy_bitmap_atlas (void);
+ALLEGRO_BITMAP *pack_bitmap (ALLEGRO_BITMAP *bitmap);
 void validate_bitmap_for_mingw (ALLEGRO_BITMAP *bitmap);
 void save_bitmap (char *filename, ALLEGRO_BITMAP *bitmap);
 bool bitmap_heq (ALLEGRO_BITMAP *b0, ALLEGRO_BITMAP *b1);
@@ -82,12 +86,15 @@ void unload_oitofelix_face (void);
 ALLEGRO_BITMAP *oitofelix_face (enum vm vm);
 
 /* palette */
-int compare_palette_caches (const void *pc0, const void *pc1);
 void palette_cache_gc (lua_State *L);
 ALLEGRO_BITMAP *apply_palette (ALLEGRO_BITMAP *bitmap, palette p);
 ALLEGRO_BITMAP *apply_palette_k (ALLEGRO_BITMAP *bitmap, palette p,
                                  const void *k);
+ALLEGRO_COLOR apply_palette_to_color_k (ALLEGRO_COLOR c, palette p,
+                                        const void *k);
 ALLEGRO_BITMAP *get_cached_palette (ALLEGRO_BITMAP *bitmap, palette p);
+void set_palette_cache_pinning (bool pin);
+void unpin_palette_cache (void);
 ALLEGRO_COLOR hgc_palette (ALLEGRO_COLOR c);
 
 /* drawn and clipping rectangle */
@@ -113,6 +120,10 @@ bool merge_clipping_rectangle (ALLEGRO_BITMAP *bitmap, int x, int y,
                                int w, int h);
 void pop_clipping_rectangle (void);
 
+void start_draw_batch (ALLEGRO_BITMAP *to);
+void end_draw_batch (void);
+void flush_draw_batch (void);
+
 /* variables */
 extern bool force_full_redraw;
 extern ALLEGRO_DISPLAY *display;
@@ -120,7 +120,7 @@ kid_die_spiked (struct anim *k)
     k->splash = true;
     k->death_reason = SPIKES_DEATH;
 
-    if (k->id == current_kid_id) {
+    if (k->id == engine->current_kid_id) {
       mr.flicker = 2;
       mr.color = get_flicker_blood_color ();
       kid_haptic (k, KID_HAPTIC_DEATH);
@@ -155,7 +155,7 @@ kid_die_chopped (struct anim *k)
     k->splash = true;
     k->death_reason = CHOPPER_DEATH;
 
-    if (k->id == current_kid_id) {
+    if (k->id == engine->current_kid_id) {
       mr.flicker = 2;
       mr.color = get_flicker_blood_color ();
       kid_haptic (k, KID_HAPTIC_DEATH);
@@ -318,8 +318,8 @@ kill_kid_shadows (struct anim *k)
   struct pos pmt;
 
   int i;
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *ks = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *ks = &engine->anima[i];
 
     if (ks->type == KID
         && ks->shadow_of == k->id
@@ -106,7 +106,7 @@ kid_drink (struct anim *k)
 static bool
 flow (struct anim *k)
 {
-  struct pos p; new_pos (&p, &global_level, -1, -1, -1);
+  struct pos p; new_pos (&p, &engine->level, -1, -1, -1);
 
   if (k->oaction != kid_drink)
     k->i = -1, k->wait = 4, k->reverse = false;
@@ -134,7 +134,7 @@ flow (struct anim *k)
       play_audio (&harm_audio, NULL, k->id);
       kid_haptic (k, KID_HAPTIC_HARM);
       if (k->current_lives == 0) k->death_reason = POTION_DEATH;
-      if (k->id == current_kid_id) {
+      if (k->id == engine->current_kid_id) {
         mr.flicker = 2;
         mr.color = get_flicker_blood_color ();
       }
@@ -146,7 +146,7 @@ flow (struct anim *k)
       k->splash = true;
       k->death_reason = POTION_DEATH;
       play_audio (&harm_audio, NULL, k->id);
-      if (k->id == current_kid_id) {
+      if (k->id == engine->current_kid_id) {
         mr.flicker = 2;
         mr.color = get_flicker_blood_color ();
       }
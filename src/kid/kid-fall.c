@@ -231,7 +231,7 @@ physics_in (struct anim *k)
         k->uncouch_slowly = true;
         kid_haptic (k, KID_HAPTIC_HARM);
       }
-      if (k->id == current_kid_id) {
+      if (k->id == engine->current_kid_id) {
         mr.flicker = 2;
         mr.color = get_flicker_blood_color ();
       }
@@ -77,7 +77,7 @@ flow (struct anim *k)
     && ! k->key.ctrl;
   bool couch = k->key.down;
   bool vjump = k->key.up && ! k->key.ctrl && ! k->key.alt
-    && anim_cycle - k->selection_cycle > SEC2CYC (2);
+    && engine->anim_cycle - k->selection_cycle > SEC2CYC (2);
   bool take_sword = k->key.enter && k->has_sword;
 
   /* acquire item */
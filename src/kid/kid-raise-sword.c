@@ -114,7 +114,7 @@ physics_out (struct anim *k)
 
   /* sound */
   if (k->i == 0 && k->wait == 5) {
-    if (k->id == current_kid_id) {
+    if (k->id == engine->current_kid_id) {
       mr.flicker = 8;
       mr.color = get_flicker_raise_sword_color ();
     }
@@ -20,8 +20,6 @@
 
 #include "mininim.h"
 
-int current_kid_id;
-
 ALLEGRO_BITMAP *v_kid_full_life, *v_kid_empty_life, *v_kid_splash;
 
 static ALLEGRO_COLOR v_palette (ALLEGRO_COLOR c);
@@ -115,7 +113,7 @@ get_kid_start_pos (struct pos *p)
 {
   if (is_valid_pos (&start_pos) && replay_mode == NO_REPLAY)
     *p = start_pos;
-  else *p = global_level.start_pos;
+  else *p = engine->level.start_pos;
   return p;
 }
 
@@ -150,11 +148,11 @@ void
 destroy_kid (struct anim *k)
 {
   int i;
-  if (current_kid_id == k->id)
-    for (i = 0; i < anima_nmemb; i++) {
-      struct anim *a = &anima[i];
+  if (engine->current_kid_id == k->id)
+    for (i = 0; i < engine->anima_nmemb; i++) {
+      struct anim *a = &engine->anima[i];
       if (a->type == KID && a->controllable)
-        current_kid_id = a->id;
+        engine->current_kid_id = a->id;
     }
 }
 
@@ -224,19 +222,19 @@ draw_start_kid (ALLEGRO_BITMAP *bitmap, enum vm vm)
 {
   /* kid */
   struct frame f;
-  f.c.room = global_level.start_pos.room;
+  f.c.room = engine->level.start_pos.room;
   palette pal = get_kid_palette (vm);
   f.b = kid_normal_00;
   f.b = apply_palette (f.b, pal);
   if (hgc) f.b = apply_palette (f.b, hgc_palette);
   f.b = apply_palette (f.b, start_anim_palette);
-  f.flip = (global_level.start_dir == RIGHT) ? ALLEGRO_FLIP_HORIZONTAL : 0;
-  place_frame (&f, &f, f.b, &global_level.start_pos,
-               global_level.start_dir == LEFT ? +28 : +22, +15);
+  f.flip = (engine->level.start_dir == RIGHT) ? ALLEGRO_FLIP_HORIZONTAL : 0;
+  place_frame (&f, &f, f.b, &engine->level.start_pos,
+               engine->level.start_dir == LEFT ? +28 : +22, +15);
   draw_frame (bitmap, &f);
 
   /* sword */
-  if (global_level.has_sword) draw_sword (bitmap, &global_level.start_pos, vm, true);
+  if (engine->level.has_sword) draw_sword (bitmap, &engine->level.start_pos, vm, true);
 }
 
 ALLEGRO_COLOR
@@ -247,7 +245,7 @@ colorful_shadow_palette (ALLEGRO_COLOR c)
   if (a == 0) return c;
   if (color_eq (c, V_KID_SKIN_COLOR_01)
       || color_eq (c, V_KID_NOSE_COLOR))
-    switch (anim_cycle % 3) {
+    switch (engine->anim_cycle % 3) {
     case 0: return TRED_COLOR;
     case 1: return TGREEN_COLOR;
     case 2: return TBLUE_COLOR;
@@ -441,7 +439,7 @@ draw_kid_lives (ALLEGRO_BITMAP *bitmap, struct anim *k,
   for (i = 0; i < total_lives; i++)
     draw_bitmap (empty, bitmap, 7 * i, CUTSCENE_HEIGHT - 6, 0);
 
-  if (current_lives <= KID_MINIMUM_LIVES_TO_BLINK && anim_cycle % 2) {
+  if (current_lives <= KID_MINIMUM_LIVES_TO_BLINK && engine->anim_cycle % 2) {
       pop_clipping_rectangle ();
       return;
   }
@@ -461,7 +459,7 @@ increase_kid_current_lives (struct anim *k)
   k->current_lives++;
   if (! is_audio_source_playing (&small_life_potion_audio))
     play_audio (&small_life_potion_audio, NULL, k->id);
-  if (k->id == current_kid_id) {
+  if (k->id == engine->current_kid_id) {
     mr.flicker = 8;
     mr.color = get_flicker_blood_color ();
   }
@@ -480,7 +478,7 @@ increase_kid_total_lives (struct anim *k)
   k->current_lives = k->total_lives;
   if (! is_audio_source_playing (&big_life_potion_audio))
     play_audio (&big_life_potion_audio, NULL, k->id);
-  if (k->id == current_kid_id) {
+  if (k->id == engine->current_kid_id) {
     mr.flicker = 8;
     mr.color = get_flicker_blood_color ();
   }
@@ -496,7 +494,7 @@ float_kid (struct anim *k)
   stop_audio_instance (&scream_audio, NULL, k->id);
   while (stop_audio_instance (&floating_audio, NULL, k->id));
   play_audio (&floating_audio, NULL, k->id);
-  if (k->id == current_kid_id) {
+  if (k->id == engine->current_kid_id) {
     mr.flicker = 8;
     mr.color = get_flicker_float_color ();
   }
@@ -544,14 +542,14 @@ get_flicker_float_color (void)
 void
 kid_haptic (struct anim *k, double cycles)
 {
-  if (! k || k->id != current_kid_id) return;
+  if (! k || k->id != engine->current_kid_id) return;
   request_gamepad_rumble (1.0, cycles / DEFAULT_HZ);
 }
 
 void
 kid_haptic_for_range (struct pos *p, coord_f cf, double r, double cycles)
 {
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
   struct pos pk;
   struct coord ck, cp;
   survey (_m, pos, &k->f, &ck, &pk, NULL);
@@ -567,7 +565,7 @@ kid_debug (void)
 {
   if (! DEBUG || cutscene) return;
 
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
 
   /* begin kid hack */
   if (was_key_pressed (0, ALLEGRO_KEY_DELETE)) k->f.c.x--;
@@ -616,7 +614,6 @@ f = %i, p = %i, dn = %i, dp = %i, dc = %i, dcb = %i, df = %i, dl = %i, dcl = %i,
 
 
 int fellow_shadow_id[9];
-int last_fellow_shadow_id;
 
 void
 init_fellow_shadow_id (void)
@@ -624,7 +621,7 @@ init_fellow_shadow_id (void)
   size_t i;
   fellow_shadow_id[0] = 0;
   for (i = 1; i < FELLOW_SHADOW_NMEMB; i++) fellow_shadow_id[i] = -1;
-  last_fellow_shadow_id = 0;
+  engine->last_fellow_shadow_id = 0;
 }
 
 int
@@ -662,14 +659,14 @@ next_fellow_shadow_style (void)
 void
 next_fellow_shadow (int d)
 {
-  if (! last_fellow_shadow_id) {
+  if (! engine->last_fellow_shadow_id) {
     ui_msg (0, "NO FELLOW SHADOW");
     return;
   }
 
   size_t i;
   for (i = 1;
-       fellow_shadow_id[i] != last_fellow_shadow_id;
+       fellow_shadow_id[i] != engine->last_fellow_shadow_id;
        i = next_remainder (i, FELLOW_SHADOW_NMEMB, 1, d));
 
   do {
@@ -678,7 +675,7 @@ next_fellow_shadow (int d)
 
     struct anim *k = get_anim_by_id (fellow_shadow_id[i]);
 
-    if (fellow_shadow_id[i] == last_fellow_shadow_id) {
+    if (fellow_shadow_id[i] == engine->last_fellow_shadow_id) {
       ui_msg (0, "NO FELLOW SHADOW");
       return;
     } else {
@@ -692,10 +689,10 @@ next_fellow_shadow (int d)
 void
 current_fellow_shadow (void)
 {
-  if (current_kid_id) select_controllable_by_id (0);
+  if (engine->current_kid_id) select_controllable_by_id (0);
   else {
-    if (last_fellow_shadow_id) {
-      select_controllable_by_id (last_fellow_shadow_id);
+    if (engine->last_fellow_shadow_id) {
+      select_controllable_by_id (engine->last_fellow_shadow_id);
       return;
     } else ui_msg (0, "NO FELLOW SHADOW");
   }
@@ -733,8 +730,8 @@ create_fellow_shadow (bool select)
       else {
         struct anim *ke = get_anim_by_id (k->enemy_id);
         if (ke) ke->enemy_id = id;
-        last_fellow_shadow_id = id;
-        k->selection_cycle = anim_cycle;
+        engine->last_fellow_shadow_id = id;
+        k->selection_cycle = engine->anim_cycle;
         k->death_timer = 0;
       }
 
@@ -73,9 +73,7 @@ void create_fellow_shadow (bool select);
 
 
 /* variables */
-extern int current_kid_id;
 extern int fellow_shadow_id[FELLOW_SHADOW_NMEMB];
-extern int last_fellow_shadow_id;
 
 extern ALLEGRO_BITMAP *v_kid_full_life, *v_kid_empty_life, *v_kid_splash;
 
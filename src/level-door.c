@@ -56,9 +56,6 @@ ALLEGRO_BITMAP *pv_level_door_top_left, *pv_level_door_top_right,
   *pv_level_door_front;
 ALLEGRO_BITMAP *pv_level_door_front_cache[LEVEL_DOOR_STEPS];
 
-struct level_door *level_door = NULL;
-size_t level_door_nmemb = 0;
-
 void
 load_level_door (void)
 {
@@ -254,10 +251,10 @@ register_level_door (struct pos *p)
 
   init_level_door (p, &d);
 
-  level_door =
-    add_to_array (&d, 1, level_door, &level_door_nmemb, level_door_nmemb, sizeof (d));
+  engine->level_door =
+    add_to_array (&d, 1, engine->level_door, &engine->level_door_nmemb, engine->level_door_nmemb, sizeof (d));
 
-  qsort (level_door, level_door_nmemb, sizeof (d), compare_level_doors);
+  qsort (engine->level_door, engine->level_door_nmemb, sizeof (d), compare_level_doors);
 }
 
 int
@@ -284,7 +281,7 @@ level_door_at_pos (struct pos *p)
   struct level_door *dd;
 
  search:
-  dd = bsearch (&d, level_door, level_door_nmemb, sizeof (d),
+  dd = bsearch (&d, engine->level_door, engine->level_door_nmemb, sizeof (d),
                 compare_level_doors);
 
   if (dd && fg (p) != LEVEL_DOOR) {
@@ -301,9 +298,9 @@ level_door_at_pos (struct pos *p)
 void
 remove_level_door (struct level_door *d)
 {
-  size_t i =  d - level_door;
-  level_door =
-    remove_from_array (level_door, &level_door_nmemb, i, 1, sizeof (*d));
+  size_t i =  d - engine->level_door;
+  engine->level_door =
+    remove_from_array (engine->level_door, &engine->level_door_nmemb, i, 1, sizeof (*d));
 }
 
 int
@@ -341,16 +338,16 @@ compute_level_doors (void)
 {
   size_t i;
 
-  for (i = 0; i < level_door_nmemb;) {
-    struct level_door *d = &level_door[i];
+  for (i = 0; i < engine->level_door_nmemb;) {
+    struct level_door *d = &engine->level_door[i];
     if (fg (&d->p) == LEVEL_DOOR) {
       i++; continue;
     }
     remove_level_door (d);
   }
 
-  for (i = 0; i < level_door_nmemb; i++) {
-    struct level_door *d = &level_door[i];
+  for (i = 0; i < engine->level_door_nmemb; i++) {
+    struct level_door *d = &engine->level_door[i];
     switch (d->action) {
     case OPEN_LEVEL_DOOR:
       if (d->i % 5 == 2 && d->i > 2) {
@@ -388,8 +385,8 @@ struct level_door *
 get_exit_level_door (struct level *l, int n)
 {
   int i;
-  for (i = 0; i < level_door_nmemb; i++) {
-    struct level_door *d = &level_door[i];
+  for (i = 0; i < engine->level_door_nmemb; i++) {
+    struct level_door *d = &engine->level_door[i];
     if (! peq (&d->p, &l->start_pos)
         && d->i == 0
         && n-- == 0) return d;
@@ -400,7 +397,7 @@ get_exit_level_door (struct level *l, int n)
 struct pos *
 first_level_door_in_room_pos (int room, struct pos *p_ret)
 {
-  struct pos p; new_pos (&p, &global_level, room, -1, -1);
+  struct pos p; new_pos (&p, &engine->level, room, -1, -1);
   for (p.floor = 0; p.floor < FLOORS; p.floor++)
     for (p.place = 0; p.place < PLACES; p.place++)
       if (fg (&p) == LEVEL_DOOR) {
@@ -69,10 +69,6 @@
 #define PV_LEVEL_DOOR_STAIRS "data/level-door/pv-stairs.png"
 #define PV_LEVEL_DOOR_FRONT "data/level-door/pv-front.png"
 
-/* variables */
-extern struct level_door *level_door;
-extern size_t level_door_nmemb;
-
 /* functions */
 void load_level_door (void);
 void unload_level_door (void);
@@ -25,11 +25,11 @@ static void draw_level (void);
 static void compute_level (void);
 static void cleanup_level (void);
 static void process_death (void);
+static void check_time_limit (void);
 static void draw_lives (ALLEGRO_BITMAP *bitmap, struct anim *k, enum vm vm);
 
 /* variables */
 struct level vanilla_level;
-struct level global_level;
 
 struct undo undo;
 
@@ -40,10 +40,8 @@ bool no_room_drawing;
 bool game_paused;
 int step_cycle = -1;
 int retry_level = -1;
-int camera_follow_kid;
 int next_level_number = -1;
 bool ignore_level_cutscene;
-uint64_t death_timer;
 
 struct level *
 copy_level (struct level *ld, struct level *ls)
@@ -177,10 +175,10 @@ void
 replace_playing_level (struct level *l)
 {
   destroy_cons ();
-  copy_level (&global_level, l);
+  copy_level (&engine->level, l);
   register_cons ();
-  em = global_level.em;
-  hue = global_level.hue;
+  em = engine->level.em;
+  hue = engine->level.hue;
   mr.full_update = true;
 }
 
@@ -188,7 +186,7 @@ void
 play_level (struct level *lv)
 {
  start:
-  if (random_seed == 0) prandom (0);
+  if (engine->random_seed == 0) prandom (0);
 
   level_cleanup ();
 
@@ -196,7 +194,7 @@ play_level (struct level *lv)
   game_paused = false;
   ignore_level_cutscene = false;
   potion_flags = 0;
-  copy_level (&global_level, lv);
+  copy_level (&engine->level, lv);
 
   /* replay setup */
   replay_mode = level_start_replay_mode;
@@ -221,11 +219,11 @@ play_level (struct level *lv)
 
   set_replay_mode_at_level_start (replay);
 
-  play_time = start_level_time;
+  engine->play_time = start_level_time;
 
-  if (mirror_level) mirror_level_h (&global_level);
+  if (mirror_level) mirror_level_h (&engine->level);
 
-  normalize_level (&global_level);
+  normalize_level (&engine->level);
 
   apply_mr_fit_mode ();
 
@@ -233,16 +231,16 @@ play_level (struct level *lv)
   register_anims ();
 
   stop_audio_instances ();
-  play_time_stopped = false;
-  death_timer = 0;
+  engine->play_time_stopped = false;
+  engine->death_timer = 0;
 
-  if (global_level.start) global_level.start ();
+  if (engine->level.start) engine->level.start ();
 
   last_auto_show_time = 0;
-  current_kid_id = 0;
+  engine->current_kid_id = 0;
 
-  if (! force_em) em = global_level.em;
-  if (! force_hue) hue = global_level.hue;
+  if (! force_em) em = engine->level.em;
+  if (! force_hue) hue = engine->level.hue;
 
   last_edit = EDIT_MAIN;
 
@@ -251,6 +249,8 @@ play_level (struct level *lv)
 
   level_number_shown = false;
 
+  if (! headless) precompute_hue_palettes (em, vm);
+
   play_anim (draw_level, compute_level, cleanup_level);
 
   if (title_demo) {
@@ -260,7 +260,7 @@ play_level (struct level *lv)
     return;
   }
 
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
 
   switch (quit_anim) {
   default:
@@ -289,7 +289,7 @@ play_level (struct level *lv)
     replay->final_kcd = k->skill.counter_defense_prob + 1;
     total_lives = k->total_lives;
     skill = k->skill;
-    start_level_time = play_time;
+    start_level_time = engine->play_time;
     break;
   case REPLAY_RESTART_LEVEL:
     HLINE;
@@ -298,7 +298,7 @@ play_level (struct level *lv)
     break;
   case RESTART_LEVEL:
   restart_level:
-    retry_level = global_level.n;
+    retry_level = engine->level.n;
     level_cleanup ();
     ui_msg_clear (0);
    goto start;
@@ -306,16 +306,16 @@ play_level (struct level *lv)
   case NEXT_LEVEL:
   next_level:
     level_cleanup ();
-    if (global_level.next_level)
-      global_level.next_level (lv, next_level_number);
+    if (engine->level.next_level)
+      engine->level.next_level (lv, next_level_number);
     ui_msg_clear (0);
-    if (global_level.cutscene && ! ignore_level_cutscene
-        && next_level_number >= global_level.n + 1) {
+    if (engine->level.cutscene && ! ignore_level_cutscene
+        && next_level_number >= engine->level.n + 1) {
       cutscene_started = false;
       cutscene_mode (true);
       stop_video_effect ();
       stop_audio_instances ();
-      play_anim (global_level.cutscene, NULL, NULL);
+      play_anim (engine->level.cutscene, NULL, NULL);
       stop_video_effect ();
       stop_audio_instances ();
       if (quit_anim == NEXT_LEVEL) goto next_level;
@@ -351,6 +351,7 @@ play_level (struct level *lv)
  quit:
 
   if (! title_demo && replay_mode == PLAY_REPLAY) {
+    if (is_replay_worker ()) exit_replay_worker (replay);
     if (! replay->complete) complete_replay_chain = false;
     if (quit_anim == REPLAY_NEXT) {
       HLINE;
@@ -359,25 +360,14 @@ play_level (struct level *lv)
       replay_skipped = just_skipped_replay > 0;
     } else {
       print_replay_results (replay);
+      archive_replay_results (replay);
       just_skipped_replay = 0;
     }
 
     if ((quit_anim != REPLAY_NEXT
          || replay_next_number >= replay_index)
         && replay_index == replay_chain_nmemb - 1) {
-      HLINE;
-      printf ("REPLAY CHAIN END\n");
-      HLINE;
-
-      int status = ! replay_skipped && complete_replay_chain
-        && valid_replay_chain ? 0 : 1;
-
-      if (validate_replay_chain == WRITE_VALIDATE_REPLAY_CHAIN) {
-        if (status == 0) {
-          save_replay_chain ();
-          fprintf (stderr, "MININIM: replay chain VALID and COMPLETE!  Replay chain HAS been saved.\n");
-        } else fprintf (stderr, "MININIM: replay chain INVALID or INCOMPLETE!  Replay chain has NOT been saved.\n");
-      }
+      int status = end_replay_chain ();
 
       stop_replaying (1);
 
@@ -484,13 +474,13 @@ destroy_con_at_pos (struct pos *p)
 void
 destroy_cons (void)
 {
-  destroy_array ((void **) &loose_floor, &loose_floor_nmemb);
-  destroy_array ((void **) &opener_floor, &opener_floor_nmemb);
-  destroy_array ((void **) &closer_floor, &closer_floor_nmemb);
-  destroy_array ((void **) &spikes_floor, &spikes_floor_nmemb);
-  destroy_array ((void **) &door, &door_nmemb);
-  destroy_array ((void **) &level_door, &level_door_nmemb);
-  destroy_array ((void **) &chopper, &chopper_nmemb);
+  destroy_array ((void **) &engine->loose_floor, &engine->loose_floor_nmemb);
+  destroy_array ((void **) &engine->opener_floor, &engine->opener_floor_nmemb);
+  destroy_array ((void **) &engine->closer_floor, &engine->closer_floor_nmemb);
+  destroy_array ((void **) &engine->spikes_floor, &engine->spikes_floor_nmemb);
+  destroy_array ((void **) &engine->door, &engine->door_nmemb);
+  destroy_array ((void **) &engine->level_door, &engine->level_door_nmemb);
+  destroy_array ((void **) &engine->chopper, &engine->chopper_nmemb);
   destroy_array ((void **) &mirror, &mirror_nmemb);
 }
 
@@ -512,7 +502,7 @@ register_con_at_pos (struct pos *p)
 void
 register_room (int room)
 {
-  struct pos p; new_pos (&p, &global_level, room, -1, -1);
+  struct pos p; new_pos (&p, &engine->level, room, -1, -1);
   for (p.floor = 0; p.floor < FLOORS; p.floor++)
     for (p.place = 0; p.place < PLACES; p.place++)
       register_con_at_pos (&p);
@@ -531,27 +521,27 @@ register_anims (void)
 {
   /* create kid */
   struct pos kid_start_pos; get_kid_start_pos (&kid_start_pos);
-  int id = create_anim (NULL, KID, &kid_start_pos, global_level.start_dir);
-  struct anim *k = &anima[id];
+  int id = create_anim (NULL, KID, &kid_start_pos, engine->level.start_dir);
+  struct anim *k = &engine->anima[id];
   k->total_lives = total_lives;
   k->skill = skill;
   k->current_lives = total_lives;
   k->controllable = true;
   k->immortal = immortal_mode;
-  k->has_sword = global_level.has_sword;
+  k->has_sword = engine->level.has_sword;
   init_fellow_shadow_id ();
 
   /* create guards */
   int i;
   for (i = 0; i < GUARDS; i++) {
-    struct guard *g = guard (&global_level, i);
+    struct guard *g = guard (&engine->level, i);
     struct anim *a;
     int id;
     switch (g->type) {
     case NO_ANIM: continue;
     case KID:
       id = create_anim (NULL, KID, &g->p, g->dir);
-      anima[id].shadow = true;
+      engine->anima[id].shadow = true;
       break;
     case GUARD: default:
       id = create_anim (NULL, GUARD, &g->p, g->dir);
@@ -569,14 +559,14 @@ register_anims (void)
       id = create_anim (NULL, SHADOW, &g->p, g->dir);
       break;
     }
-    a = &anima[id];
+    a = &engine->anima[id];
     apply_guard_mode (a, gm);
     a->level_id = i;
     a->has_sword = true;
     a->skill = g->skill;
     a->total_lives = g->total_lives + g->skill.extra_life;
     a->current_lives = g->total_lives;
-    if (global_level.n == 3 && semantics == LEGACY_SEMANTICS) {
+    if (engine->level.n == 3 && semantics == LEGACY_SEMANTICS) {
       a->total_lives = a->current_lives = INT_MAX;
       a->dont_draw_lives = true;
     }
@@ -624,16 +614,22 @@ compute_level (void)
 {
   size_t i;
 
+  begin_profiler_scope (COMPUTE_LEVEL_SCOPE);
+
   level_key_bindings ();
   process_death ();
 
-  if (is_game_paused ()) return;
+  if (is_game_paused ()) {
+    check_time_limit ();
+    end_profiler_scope (COMPUTE_LEVEL_SCOPE);
+    return;
+  }
 
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
   struct anim *ke = get_anim_by_id (k->enemy_id);
 
   struct replay *replay = get_replay ();
-  replay_gamepad_update (k, replay, anim_cycle);
+  replay_gamepad_update (k, replay, engine->anim_cycle);
 
   if (! k->key.ctrl || ! k->key.left) k->ctrl_left = false;
   if (! k->key.ctrl || ! k->key.right) k->ctrl_right = false;
@@ -642,22 +638,22 @@ compute_level (void)
   /* process fellow shadow gamepad commands */
   if (k->key.ctrl && k->key.left && ! k->ctrl_left) {
     k->ctrl_left = true;
-    if (current_kid_id) next_fellow_shadow (-1);
+    if (engine->current_kid_id) next_fellow_shadow (-1);
     else create_fellow_shadow (! k->key.alt);
-    k = get_anim_by_id (current_kid_id);
+    k = get_anim_by_id (engine->current_kid_id);
     ke = get_anim_by_id (k->enemy_id);
     k->ctrl_left = true;
   } else if (k->key.ctrl && k->key.right && ! k->ctrl_right) {
     k->ctrl_right = true;
-    if (current_kid_id) next_fellow_shadow (+1);
+    if (engine->current_kid_id) next_fellow_shadow (+1);
     else create_fellow_shadow (! k->key.alt);
-    k = get_anim_by_id (current_kid_id);
+    k = get_anim_by_id (engine->current_kid_id);
     ke = get_anim_by_id (k->enemy_id);
     k->ctrl_right = true;
   } else if (k->key.alt && k->key.up && ! k->alt_up) {
     k->alt_up = true;
     current_fellow_shadow ();
-    k = get_anim_by_id (current_kid_id);
+    k = get_anim_by_id (engine->current_kid_id);
     ke = get_anim_by_id (k->enemy_id);
     k->alt_up = true;
   }
@@ -673,13 +669,13 @@ compute_level (void)
     }
   }
 
-  camera_follow_kid = (k->f.c.room == mr.room)
+  engine->camera_follow_kid = (k->f.c.room == mr.room)
     ? k->id : -1;
 
   int prev_room = k->f.c.room;
 
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *a = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *a = &engine->anima[i];
     a->splash = false;
     a->xf.b = NULL;
   }
@@ -687,11 +683,11 @@ compute_level (void)
   compute_loose_floors ();
 
   /* non-current controllables must defend themselves */
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *ks = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *ks = &engine->anima[i];
 
     if ((ks->id != 0 && ks->shadow_of != 0)
-        || ks->id == current_kid_id
+        || ks->id == engine->current_kid_id
         || ! is_in_fight_mode (ks)) continue;
 
     struct anim *kse = get_reciprocal_enemy (ks);
@@ -703,24 +699,24 @@ compute_level (void)
   }
 
   /* fight AI */
-  for (i = 0; i < anima_nmemb; i++) enter_fight_logic (&anima[i]);
-  for (i = 0; i < anima_nmemb; i++) leave_fight_logic (&anima[i]);
-  for (i = 0; i < anima_nmemb; i++) fight_ai (&anima[i]);
+  for (i = 0; i < engine->anima_nmemb; i++) enter_fight_logic (&engine->anima[i]);
+  for (i = 0; i < engine->anima_nmemb; i++) leave_fight_logic (&engine->anima[i]);
+  for (i = 0; i < engine->anima_nmemb; i++) fight_ai (&engine->anima[i]);
 
   /* actions */
-  for (i = 0; i < anima_nmemb; i++) {
-    if (anima[i].next_action) {
-      anima[i].next_action (&anima[i]);
-      anima[i].next_action = NULL;
-    } else anima[i].action (&anima[i]);
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    if (engine->anima[i].next_action) {
+      engine->anima[i].next_action (&engine->anima[i]);
+      engine->anima[i].next_action = NULL;
+    } else engine->anima[i].action (&engine->anima[i]);
   }
 
   /* fight mechanics */
-  for (i = 0; i < anima_nmemb; i++) fight_mechanics (&anima[i]);
+  for (i = 0; i < engine->anima_nmemb; i++) fight_mechanics (&engine->anima[i]);
 
   /* timers */
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *a = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *a = &engine->anima[i];
     if (a->float_timer && a->float_timer < FLOAT_TIMER_MAX) {
       request_gamepad_rumble (0.5 * (sin (a->float_timer * 0.17) + 1),
                               1.0 / DEFAULT_HZ);
@@ -733,22 +729,22 @@ compute_level (void)
   }
 
   /* appropriately turn controllables */
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *ks = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *ks = &engine->anima[i];
     if (ks->id == 0 || ks->shadow_of == 0)
       fight_turn_controllable (ks);
   }
 
   /* collision enforcement */
-  for (i = 0; i < anima_nmemb; i++) {
-    enforce_wall_collision (&anima[i].f);
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    enforce_wall_collision (&engine->anima[i].f);
   }
 
   clear_anims_keyboard_state ();
 
   if (k->f.c.room != prev_room
       && k->f.c.room != 0
-      && camera_follow_kid == k->id)  {
+      && engine->camera_follow_kid == k->id)  {
     if (! is_room_visible (k->f.c.room)) {
       mr_coord (k->f.c.prev_room,
                 k->f.c.xd, &mr.x, &mr.y);
@@ -760,14 +756,14 @@ compute_level (void)
   if (mr.w > 1
       && k->current_lives > 0
       && k->f.c.room != 0
-      && camera_follow_kid == k->id
+      && engine->camera_follow_kid == k->id
       && (ke = get_reciprocal_enemy (k))
       && ! is_room_visible (ke->f.c.room)) {
-    if (ke->f.c.room == roomd (&global_level, k->f.c.room, LEFT)) {
+    if (ke->f.c.room == roomd (&engine->level, k->f.c.room, LEFT)) {
       mr_view_trans (LEFT);
       mr_focus_room (k->f.c.room);
       mr.room_select = ke->f.c.room;
-    } else if (ke->f.c.room == roomd (&global_level, k->f.c.room, RIGHT)) {
+    } else if (ke->f.c.room == roomd (&engine->level, k->f.c.room, RIGHT)) {
       mr_view_trans (RIGHT);
       mr_focus_room (k->f.c.room);
       mr.room_select = ke->f.c.room;
@@ -780,7 +776,7 @@ compute_level (void)
   /* save individual multi-room origin */
   mr_save_origin (&k->mr_origin);
 
-  if (global_level.special_events) global_level.special_events ();
+  if (engine->level.special_events) engine->level.special_events ();
 
   compute_closer_floors ();
   compute_opener_floors ();
@@ -792,7 +788,19 @@ compute_level (void)
   register_changed_opener_floors ();
   register_changed_closer_floors ();
 
-  if (! play_time_stopped) play_time++;
+  if (! engine->play_time_stopped) engine->play_time++;
+
+  check_time_limit ();
+
+  end_profiler_scope (COMPUTE_LEVEL_SCOPE);
+}
+
+static void
+check_time_limit (void)
+{
+  if (title_demo) return;
+  int64_t rem_time = time_limit - engine->play_time;
+  if (rem_time <= 0) quit_anim = OUT_OF_TIME;
 }
 
 static void
@@ -810,9 +818,9 @@ process_death (void)
   /* Restart level after death */
   if (k->current_lives <= 0
       && ! is_game_paused ()) {
-    death_timer++;
+    engine->death_timer++;
 
-    if (death_timer == SEC2CYC (1)) {
+    if (engine->death_timer == SEC2CYC (1)) {
       struct audio_source *as;
       switch (k->death_reason) {
       case SHADOW_FIGHT_DEATH: as = &success_suspense_audio; break;
@@ -823,11 +831,12 @@ process_death (void)
       play_audio (as, NULL, k->id);
     }
 
-    if (death_timer >= SEC2CYC (5) && ! title_demo) {
-      if ((death_timer < SEC2CYC (20)
-           || death_timer % SEC2CYC (1) < (2 * SEC2CYC (1)) / 3)
+    if (engine->death_timer >= SEC2CYC (5) && ! title_demo) {
+      if ((engine->death_timer < SEC2CYC (20)
+           || engine->death_timer % SEC2CYC (1) < (2 * SEC2CYC (1)) / 3)
           && ! active_menu) {
-        if (death_timer >= SEC2CYC (21) && death_timer % SEC2CYC (1) == 0) {
+        if (engine->death_timer >= SEC2CYC (21)
+            && engine->death_timer % SEC2CYC (1) == 0) {
           play_audio (&press_key_audio, NULL, -1);
           kid_haptic (k, KID_HAPTIC_PRESS_ANY_KEY);
         }
@@ -837,8 +846,8 @@ process_death (void)
       if (was_any_key_pressed () && ! was_bmenu_key_pressed ())
         quit_anim = RESTART_LEVEL;
     }
-  } else if (death_timer && ! is_game_paused ()) {
-    death_timer = 0;
+  } else if (engine->death_timer && ! is_game_paused ()) {
+    engine->death_timer = 0;
     ui_msg_clear (-2);
   }
 }
@@ -849,32 +858,31 @@ draw_level (void)
 {
   draw_multi_rooms ();
 
-  draw_lives (uscreen, get_anim_by_id (current_kid_id), vm);
+  draw_lives (uscreen, get_anim_by_id (engine->current_kid_id), vm);
 
   /* automatic level display */
-  if (! title_demo && global_level.nominal_n >= 0
-      && ! level_number_shown && anim_cycle <= SEC2CYC (10)
-      && ui_msg (-1, "LEVEL %i", global_level.nominal_n))
+  if (! title_demo && engine->level.nominal_n >= 0
+      && ! level_number_shown && engine->anim_cycle <= SEC2CYC (10)
+      && ui_msg (-1, "LEVEL %i", engine->level.nominal_n))
     level_number_shown = true;
 
   /* automatic remaining time display */
   if (! title_demo) {
-    int64_t rem_time = time_limit - play_time;
+    int64_t rem_time = time_limit - engine->play_time;
     int64_t rem_time_sec = precise_unit (rem_time, 1 * DEFAULT_HZ);
     int64_t rem_time_min = precise_unit (rem_time, 60 * DEFAULT_HZ);
     if ((rem_time_min % 5 == 0
          && labs (last_auto_show_time - rem_time_min) > 1)
         || rem_time_sec <= 60
-        || (anim_cycle <= SEC2CYC (10)
+        || (engine->anim_cycle <= SEC2CYC (10)
             && labs (last_auto_show_time - rem_time_min) > 1)) {
       if (rem_time_sec <= 60
           && (rem_time + 1) % DEFAULT_HZ == 0
-          && ! play_time_stopped)
+          && ! engine->play_time_stopped)
         play_audio (&press_key_audio, NULL, -1);
       if (display_remaining_time (rem_time_sec <= 60 ? 0 : -2))
         last_auto_show_time = rem_time_min;
     }
-    if (rem_time <= 0) quit_anim = OUT_OF_TIME;
   }
 
   if (is_game_paused () && ! active_menu) print_game_paused (-1);
@@ -909,18 +917,18 @@ pause_game (bool val)
 bool
 is_game_paused (void)
 {
-  return anim_cycle > 0 && game_paused;
+  return engine->anim_cycle > 0 && game_paused;
 }
 
 void
 next_level (void)
 {
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
 
   total_lives = k->total_lives;
   current_lives = k->current_lives;
   skill = k->skill;
-  start_level_time = play_time;
-  next_level_number = global_level.n + 1;
+  start_level_time = engine->play_time;
+  next_level_number = engine->level.n + 1;
   quit_anim = NEXT_LEVEL;
 }
@@ -21,10 +21,8 @@
 #ifndef MININIM_LEVEL_H
 #define MININIM_LEVEL_H
 
-extern struct level global_level;
 extern struct level vanilla_level;
 extern int retry_level;
-extern int camera_follow_kid;
 extern int auto_rem_time_1st_cycle;
 extern bool no_room_drawing;
 extern bool game_paused;
@@ -32,7 +30,6 @@ extern int step_cycle;
 extern struct undo undo;
 extern int next_level_number;
 extern bool ignore_level_cutscene;
-extern uint64_t death_timer;
 
 void load_level (void);
 void unload_level (void);
@@ -26,21 +26,21 @@ static void end (struct pos *p);
 static void
 start (void)
 {
-  create_anim (&anima[0], 0, NULL, 0);
-  anima[1].controllable = true;
+  create_anim (&engine->anima[0], 0, NULL, 0);
+  engine->anima[1].controllable = true;
 }
 
 static void
 end (struct pos *p)
 {
-  next_level_number = global_level.n + 1;
+  next_level_number = engine->level.n + 1;
   quit_anim = NEXT_LEVEL;
 }
 
 struct level *
 next_consistency_level (struct level *l, int n)
 {
-  random_seed = n;
+  engine->random_seed = n;
   /* random_seed = time (NULL); */
   /* printf ("LEVEL NUMBER: %u\n", random_seed); */
 
@@ -21,7 +21,7 @@
 #include "mininim.h"
 
 int min_legacy_level = 1;
-int max_legacy_level = 14;
+int max_legacy_level = LEGACY_LEVELS;
 
 static int level_3_checkpoint;
 static int checkpoint_total_lives;
@@ -50,6 +50,33 @@ static enum lgroup get_group (enum ltile t);
 
 static struct legacy_level *load_legacy_level_file (int n);
 
+void
+register_legacy_level_state (void)
+{
+  register_engine_state (&level_3_checkpoint, sizeof (level_3_checkpoint));
+  register_engine_state (&checkpoint_total_lives,
+                         sizeof (checkpoint_total_lives));
+  register_engine_state (&checkpoint_current_lives,
+                         sizeof (checkpoint_current_lives));
+  register_engine_state (&coming_from_12, sizeof (coming_from_12));
+  register_engine_state (&checkpoint_skill, sizeof (checkpoint_skill));
+  register_engine_state (&shadow_id, sizeof (shadow_id));
+  register_engine_state (&skeleton_id, sizeof (skeleton_id));
+  register_engine_state (&played_sample, sizeof (played_sample));
+  register_engine_state (&mouse_timer, sizeof (mouse_timer));
+  register_engine_state (&mouse_id, sizeof (mouse_id));
+  register_engine_state (&shadow_merged, sizeof (shadow_merged));
+  register_engine_state (&met_jaffar, sizeof (met_jaffar));
+  register_engine_state (&played_vizier_death_sample,
+                         sizeof (played_vizier_death_sample));
+  register_engine_state (&glow_duration, sizeof (glow_duration));
+  register_engine_state (&level_end_wait, sizeof (level_end_wait));
+  register_engine_state (&shadow_disappearance_wait,
+                         sizeof (shadow_disappearance_wait));
+  register_engine_state (&vizier_vigilant_wait,
+                         sizeof (vizier_vigilant_wait));
+}
+
 void
 legacy_level_start (void)
 {
@@ -72,27 +99,27 @@ legacy_level_start (void)
   struct anim *k = get_anim_by_id (0);
 
   /* define camera's starting room */
-  if (global_level.n == 7) {
+  if (engine->level.n == 7) {
     mr_center_room (1);
-    camera_follow_kid = -1;
+    engine->camera_follow_kid = -1;
   } else {
     mr_center_room (k->f.c.room);
-    camera_follow_kid = k->id;
+    engine->camera_follow_kid = k->id;
   }
 
   /* if in level 14 stop the timer */
-  if (global_level.n == 14) play_time_stopped = true;
+  if (engine->level.n == 14) engine->play_time_stopped = true;
 
   /* in the third level */
-  if (global_level.n == 3) {
+  if (engine->level.n == 3) {
     /* if it's the first time playing the checkpoint hasn't been
        reached yet */
     if (retry_level != 3 && replay_mode == NO_REPLAY)
       level_3_checkpoint = false;
     /* if the checkpoint has been reached, respawn there */
-    struct pos p; new_pos (&p, &global_level, 2, 0, 6);
+    struct pos p; new_pos (&p, &engine->level, 2, 0, 6);
     if (level_3_checkpoint && replay_mode == NO_REPLAY) {
-      struct pos plf; new_pos (&plf, &global_level, 7, 0, 4);
+      struct pos plf; new_pos (&plf, &engine->level, 7, 0, 4);
       register_con_undo (&undo, &plf,
                          NO_FLOOR, MIGNORE, MIGNORE, MIGNORE,
                          NULL, true, "NO FLOOR");
@@ -108,7 +135,7 @@ legacy_level_start (void)
 
   /* in the tenth level unflip the screen vertically, (helpful if the
      kid has not drank the potion that would do it on its own) */
-  if (global_level.n == 10) screen_flags &= ~ ALLEGRO_FLIP_VERTICAL;
+  if (engine->level.n == 10) screen_flags &= ~ ALLEGRO_FLIP_VERTICAL;
 
   /* level 13 adjustements */
   if (coming_from_12) k->current_lives = current_lives;
@@ -116,7 +143,7 @@ legacy_level_start (void)
 
   coming_from_12 = false;
 
-  if (global_level.n == 13) {
+  if (engine->level.n == 13) {
     struct anim *v = get_anim_by_id (1);
     v->fight = false;
   }
@@ -129,7 +156,7 @@ legacy_level_special_events (void)
 
   struct pos p, pm;
   struct anim *k0 = get_anim_by_id (0);
-  struct anim *kc = get_anim_by_id (current_kid_id);
+  struct anim *kc = get_anim_by_id (engine->current_kid_id);
 
   /* title demo */
   if (title_demo) {
@@ -138,40 +165,40 @@ legacy_level_special_events (void)
     if (was_any_key_pressed ()) {
       quit_anim = CUTSCENE_KEY_PRESS;
       return;
-    } else if (anim_cycle >= replay->packed_gamepad_state_nmemb + 108) {
+    } else if (engine->anim_cycle >= replay->packed_gamepad_state_nmemb + 108) {
       quit_anim = CUTSCENE_END;
       return;
     }
   }
 
   /* in the first animation cycle */
-  if (anim_cycle == 0 || anim_cycle == 1) {
+  if (engine->anim_cycle == 0 || engine->anim_cycle == 1) {
     struct level_door *ld = NULL;
 
     invalid_pos (&p);
 
     if (semantics == LEGACY_SEMANTICS)
-      first_level_door_in_room_pos (global_level.start_pos.room, &p);
-    else if (fg (&global_level.start_pos) == LEVEL_DOOR)
-      p = global_level.start_pos;
+      first_level_door_in_room_pos (engine->level.start_pos.room, &p);
+    else if (fg (&engine->level.start_pos) == LEVEL_DOOR)
+      p = engine->level.start_pos;
 
     /* close level door the kid came from */
     if (is_valid_pos (&p)) {
       ld = level_door_at_pos (&p);
-      if (anim_cycle == 0) ld->i = 0;
-      if (anim_cycle == 1) ld->action = CLOSE_LEVEL_DOOR;
+      if (engine->anim_cycle == 0) ld->i = 0;
+      if (engine->anim_cycle == 1) ld->action = CLOSE_LEVEL_DOOR;
     }
   }
 
   /* in the first level, first try, play the suspense sound */
-  if (global_level.n == 1 && anim_cycle == 12
+  if (engine->level.n == 1 && engine->anim_cycle == 12
       && (retry_level != 1 || replay_mode != NO_REPLAY)) {
     /* play_audio (&suspense_audio, NULL, -1); */
     kid_haptic (kc, KID_HAPTIC_LEGACY_COUCHING_START);
   }
 
   /* in the third level */
-  if (global_level.n == 3) {
+  if (engine->level.n == 3) {
 
     /* level 3 checkpoint */
     if (! level_3_checkpoint
@@ -189,17 +216,17 @@ legacy_level_special_events (void)
     /* raise the skeleton as soon as the exit door is open and the
        kid reaches the second place of the room 1 */
     struct pos skeleton_floor_pos;
-    new_pos (&skeleton_floor_pos, &global_level, 1, 1, 5);
+    new_pos (&skeleton_floor_pos, &engine->level, 1, 1, 5);
     survey (_m, pos, &kc->f, NULL, &pm, NULL);
     if (pm.room == 1
         && (pm.place == 2 || pm.place == 3)
         && fg (&skeleton_floor_pos) == SKELETON_FLOOR
-        && get_exit_level_door (&global_level, 0)) {
+        && get_exit_level_door (&engine->level, 0)) {
       register_con_undo (&undo, &skeleton_floor_pos,
                          FLOOR, MIGNORE, MIGNORE, MIGNORE,
                          NULL, true, "FLOOR");
       skeleton_id = create_anim (NULL, SKELETON, &skeleton_floor_pos, LEFT);
-      s = &anima[skeleton_id];
+      s = &engine->anima[skeleton_id];
       get_legacy_skill (2, &s->skill);
       s->has_sword = true;
       s->total_lives = INT_MAX;
@@ -215,7 +242,7 @@ legacy_level_special_events (void)
     s = get_anim_by_id (skeleton_id);
     if (s) {
       survey (_m, pos, &s->f, NULL, &pm, NULL);
-      new_pos (&p, &global_level, 3, 1, 4);
+      new_pos (&p, &engine->level, 3, 1, 4);
       if (s->f.c.room == 3 && pm.floor == 0
           && is_guard_fall (&s->f)) {
         s->f.dir = RIGHT;
@@ -226,14 +253,14 @@ legacy_level_special_events (void)
   }
 
   /* in the fourth level */
-  if (global_level.n == 4) {
-    struct pos mirror_pos; new_pos (&mirror_pos, &global_level, 4, 0, 4);
+  if (engine->level.n == 4) {
+    struct pos mirror_pos; new_pos (&mirror_pos, &engine->level, 4, 0, 4);
 
     /* if the level door is open and the camera is on room 4, make
        the mirror appear */
     if (is_pos_visible (&mirror_pos)
         && fg (&mirror_pos) != MIRROR
-        && get_exit_level_door (&global_level, 0)) {
+        && get_exit_level_door (&engine->level, 0)) {
       register_con_undo (&undo, &mirror_pos,
                          MIRROR, MIGNORE, MIGNORE, MIGNORE,
                          NULL, true, "MIRROR");
@@ -248,7 +275,7 @@ legacy_level_special_events (void)
         && shadow_id == -1) {
       k0->current_lives = 1;
       int id = create_anim (k0, 0, NULL, 0);
-      struct anim *ks = &anima[id];
+      struct anim *ks = &engine->anima[id];
       ks->fight = false;
       invert_frame_dir (&ks->f, &ks->f);
       ks->controllable = false;
@@ -272,10 +299,10 @@ legacy_level_special_events (void)
   }
 
   /* in the fifth level */
-  if (global_level.n == 5) {
-    struct pos door_pos; new_pos (&door_pos, &global_level, 24, 0, 1);
-    struct pos potion_pos; new_pos (&potion_pos, &global_level, 24, 0, 3);
-    struct pos shadow_pos; new_pos (&shadow_pos, &global_level, 24, 0, -1);
+  if (engine->level.n == 5) {
+    struct pos door_pos; new_pos (&door_pos, &engine->level, 24, 0, 1);
+    struct pos potion_pos; new_pos (&potion_pos, &engine->level, 24, 0, 3);
+    struct pos shadow_pos; new_pos (&shadow_pos, &engine->level, 24, 0, -1);
 
     /* if there is a door sufficiently open, and a potion in room 24,
        and the camera is there, create a kid's shadow to drink the
@@ -286,7 +313,7 @@ legacy_level_special_events (void)
         && is_potion (&potion_pos)
         && door_at_pos (&door_pos)->i <= 25) {
       int id = create_anim (k0, 0, NULL, 0);
-      struct anim *ks = &anima[id];
+      struct anim *ks = &engine->anima[id];
       ks->shadow = true;
       ks->fight = false;
       ks->f.dir = RIGHT;
@@ -320,14 +347,14 @@ legacy_level_special_events (void)
   }
 
   /* in the sixth level */
-  if (global_level.n == 6) {
+  if (engine->level.n == 6) {
     struct anim *ks;
 
     /* create kid's shadow to wait for kid at room 1 */
     if (shadow_id == -1) {
-      struct pos shadow_pos; new_pos (&shadow_pos, &global_level, 1, 1, 1);
+      struct pos shadow_pos; new_pos (&shadow_pos, &engine->level, 1, 1, 1);
       int id = create_anim (k0, 0, NULL, 0);
-      ks = &anima[id];
+      ks = &engine->anima[id];
       ks->fight = false;
       ks->shadow = true;
       ks->f.dir = RIGHT;
@@ -359,14 +386,14 @@ legacy_level_special_events (void)
 
     /* when kid falls from room 1 to the room below it, quit to the
        next level */
-    if (k0->f.c.room == roomd (&global_level, 1, BELOW)
+    if (k0->f.c.room == roomd (&engine->level, 1, BELOW)
         && k0->f.c.prev_room == 1
         && k0->f.c.xd == BELOW) next_level ();
   }
 
   /* in the eighth level */
-  if (global_level.n == 8) {
-    struct pos mouse_pos; new_pos (&mouse_pos, &global_level, 16, 0, PLACES - 1);
+  if (engine->level.n == 8) {
+    struct pos mouse_pos; new_pos (&mouse_pos, &engine->level, 16, 0, PLACES - 1);
     struct anim *m = NULL;
 
     if (mouse_id != -1) m = get_anim_by_id (mouse_id);
@@ -375,13 +402,13 @@ legacy_level_special_events (void)
        start counting (or continue if started already) for the mouse
        arrival */
     if (k0->f.c.room == 16 && mouse_timer <= 138
-        && get_exit_level_door (&global_level, 0)) mouse_timer++;
+        && get_exit_level_door (&engine->level, 0)) mouse_timer++;
 
     /* if enough cycles have passed since the start of the countdown
        and the camera is at room 16, make the mouse appear */
     if (mouse_timer == 138 && is_room_visible (mouse_pos.room)) {
       mouse_id = create_anim (NULL, MOUSE, &mouse_pos, RIGHT);
-      m = &anima[mouse_id];
+      m = &engine->anima[mouse_id];
       m->f.flip = ALLEGRO_FLIP_HORIZONTAL;
     }
 
@@ -394,18 +421,18 @@ legacy_level_special_events (void)
   }
 
   /* in the twelfth level */
-  if (global_level.n == 12) {
+  if (engine->level.n == 12) {
     struct coord ms, m0;
     struct pos pm, pm0, pms;
 
-    struct pos sword_pos; new_pos (&sword_pos, &global_level, 15, 0, 1);
+    struct pos sword_pos; new_pos (&sword_pos, &engine->level, 15, 0, 1);
     struct pos first_hidden_floor_pos;
-    new_pos (&first_hidden_floor_pos, &global_level, 2, 0, 7);
+    new_pos (&first_hidden_floor_pos, &engine->level, 2, 0, 7);
     struct anim *ks = NULL;
 
     /* make the sword in room 15 disappear (kid's shadow has it) when
        the kid leaves room 18 to the right */
-    if (kc->f.c.room == roomd (&global_level, 18, RIGHT)
+    if (kc->f.c.room == roomd (&engine->level, 18, RIGHT)
         && ext (&sword_pos) == SWORD)
       set_ext (&sword_pos, NO_ITEM);
 
@@ -416,9 +443,9 @@ legacy_level_special_events (void)
         && pm.room == 15 && pm.place < 6
         && ! shadow_merged) {
       struct pos shadow_pos;
-      new_pos (&shadow_pos, &global_level, 15, 0, 1);
+      new_pos (&shadow_pos, &engine->level, 15, 0, 1);
       shadow_id = create_anim (NULL, SHADOW, &shadow_pos, RIGHT);
-      ks = &anima[shadow_id];
+      ks = &engine->anima[shadow_id];
       ks->fight = true;
       ks->controllable = false;
       ks->refraction = 12;
@@ -547,9 +574,9 @@ legacy_level_special_events (void)
       /* while the merge doesn't happen and neither the shadow nor the
          kid are in fight mode, the shadow's movements mirror the
          kid's */
-      else if (ks->type == KID && current_kid_id == 0) {
+      else if (ks->type == KID && engine->current_kid_id == 0) {
         struct replay *replay = get_replay ();
-        replay_gamepad_update (ks, replay, anim_cycle);
+        replay_gamepad_update (ks, replay, engine->anim_cycle);
         bool l = ks->key.left;
         bool r = ks->key.right;
         ks->key.left = r;
@@ -559,7 +586,7 @@ legacy_level_special_events (void)
          making them glow intermittently */
     } else if (shadow_merged && glow_duration > 0) {
       glow_duration--;
-      k0->shadow = (anim_cycle % 2);
+      k0->shadow = (engine->anim_cycle % 2);
     }
     /* after the success music has finished to play, the kid goes
        normal again */
@@ -570,7 +597,7 @@ legacy_level_special_events (void)
     if (shadow_merged
         && k0->f.c.room == 2
         && fg (&first_hidden_floor_pos) == NO_FLOOR)
-      for (new_pos (&p, &global_level, 2, 0, -4); p.place < PLACES;
+      for (new_pos (&p, &engine->level, 2, 0, -4); p.place < PLACES;
            prel (&p, &p, +0, +1))
         if (fg (&p) == NO_FLOOR) set_fg (&p, HIDDEN_FLOOR);
 
@@ -582,11 +609,11 @@ legacy_level_special_events (void)
   }
 
   /* in the thirteenth level */
-  if (global_level.n == 13) {
+  if (engine->level.n == 13) {
 
     /* make the top loose floors fall spontaneously */
     if (k0->f.c.room == 16 || k0->f.c.room == 23) {
-      struct pos p; new_pos (&p, &global_level, k0->f.c.room, -1, 0);
+      struct pos p; new_pos (&p, &engine->level, k0->f.c.room, -1, 0);
       p.place = prandom (9);
       activate_con (&p);
     }
@@ -619,13 +646,13 @@ legacy_level_special_events (void)
         stop_audio_instance (&meet_vizier_audio, NULL, kc->id);
         play_audio (&vizier_death_audio, NULL, kc->id);
         played_vizier_death_sample = true;
-        play_time_stopped = true;
+        engine->play_time_stopped = true;
         display_remaining_time (-2);
       }
 
       /* after vizier's death activate certain tile in order to open
          the exit level door */
-      struct pos p; new_pos (&p, &global_level, 24, 0, 0);
+      struct pos p; new_pos (&p, &engine->level, 24, 0, 0);
       if (v->current_lives <= 0
           && kc->f.c.room != v->f.c.room)
         activate_con (&p);
@@ -633,7 +660,7 @@ legacy_level_special_events (void)
   }
 
   /* in the fourteenth level */
-  if (global_level.n == 14) {
+  if (engine->level.n == 14) {
     /* when the kid enters room 5, go to the next level */
     if (k0->f.c.room == 5) next_level ();
   }
@@ -647,7 +674,7 @@ legacy_level_end (struct pos *p)
   /* end music samples to play per level */
   if (level_end_wait < 0) {
     stop_audio_instance (&floating_audio, NULL, k->id);
-    switch (global_level.n) {
+    switch (engine->level.n) {
     case 1: case 2: case 3: case 5: case 6: case 7:
     case 8: case 9: case 10: case 11: case 12:
       play_audio (&success_audio, NULL, k->id);
@@ -137,6 +137,7 @@ enum lm_exit {
 };
 
 /* functions */
+void register_legacy_level_state (void);
 void legacy_level_start (void);
 void legacy_level_special_events (void);
 void legacy_level_end (struct pos *p);
@@ -50,8 +50,6 @@ ALLEGRO_BITMAP *pv_loose_floor_left_00, *pv_loose_floor_right_00,
   *pv_loose_floor_base_00, *pv_loose_floor_left_01, *pv_loose_floor_right_01,
   *pv_loose_floor_base_01, *pv_loose_floor_01, *pv_broken_floor;
 
-struct loose_floor *loose_floor = NULL;
-size_t loose_floor_nmemb = 0;
 static bool must_sort;
 
 void
@@ -275,9 +273,9 @@ register_loose_floor (struct pos *p)
 
   init_loose_floor (p, &l);
 
-  loose_floor =
-    add_to_array (&l, 1, loose_floor, &loose_floor_nmemb,
-                  loose_floor_nmemb, sizeof (l));
+  engine->loose_floor =
+    add_to_array (&l, 1, engine->loose_floor, &engine->loose_floor_nmemb,
+                  engine->loose_floor_nmemb, sizeof (l));
 
   sort_loose_floors ();
 }
@@ -285,7 +283,7 @@ register_loose_floor (struct pos *p)
 void
 sort_loose_floors (void)
 {
-  qsort (loose_floor, loose_floor_nmemb, sizeof (struct loose_floor),
+  qsort (engine->loose_floor, engine->loose_floor_nmemb, sizeof (struct loose_floor),
          compare_loose_floors);
 }
 
@@ -322,7 +320,7 @@ loose_floor_at_pos (struct pos *p)
   struct loose_floor *ll;
 
  search:
-  ll = bsearch (&l, loose_floor, loose_floor_nmemb, sizeof (l),
+  ll = bsearch (&l, engine->loose_floor, engine->loose_floor_nmemb, sizeof (l),
                 compare_loose_floors);
 
   if (! ll && fg (p) == LOOSE_FLOOR) {
@@ -338,8 +336,8 @@ falling_loose_floor_at_pos (struct pos *p)
 {
   size_t i;
   struct loose_floor *l;
-  for (i = 0; i < loose_floor_nmemb; i++) {
-    l = &loose_floor[i];
+  for (i = 0; i < engine->loose_floor_nmemb; i++) {
+    l = &engine->loose_floor[i];
     if (l->action == FALL_LOOSE_FLOOR
         && peq (&l->p, p))
       return l;
@@ -350,9 +348,9 @@ falling_loose_floor_at_pos (struct pos *p)
 void
 remove_loose_floor (struct loose_floor *l)
 {
-  size_t i =  l - loose_floor;
-  loose_floor =
-    remove_from_array (loose_floor, &loose_floor_nmemb, i, 1, sizeof (*l));
+  size_t i =  l - engine->loose_floor;
+  engine->loose_floor =
+    remove_from_array (engine->loose_floor, &engine->loose_floor_nmemb, i, 1, sizeof (*l));
 }
 
 void
@@ -431,8 +429,8 @@ compute_loose_floors (void)
 
   must_sort = false;
 
-  for (i = 0; i < loose_floor_nmemb;) {
-    struct loose_floor *l = &loose_floor[i];
+  for (i = 0; i < engine->loose_floor_nmemb;) {
+    struct loose_floor *l = &engine->loose_floor[i];
     if (! should_remove_loose_floor (l)) {
       i++; continue;
     }
@@ -442,8 +440,8 @@ compute_loose_floors (void)
     remove_loose_floor (l);
   }
 
-  for (i = 0; i < loose_floor_nmemb; i++) {
-    struct loose_floor *l = &loose_floor[i];
+  for (i = 0; i < engine->loose_floor_nmemb; i++) {
+    struct loose_floor *l = &engine->loose_floor[i];
 
     switch (l->action) {
     case SHAKE_LOOSE_FLOOR:
@@ -587,9 +585,9 @@ compute_loose_floor_fall (struct loose_floor *l)
 
   /* hit character */
   int i;
-  for (i = 0; i < anima_nmemb; i++) {
+  for (i = 0; i < engine->anima_nmemb; i++) {
     struct coord kmt, ambo_f, ambo_nf; struct pos kpmt;
-    struct anim *a = &anima[i];
+    struct anim *a = &engine->anima[i];
     if (is_anim_dead (&a->f)
         || is_anim_fall (&a->f)
         || a->immortal
@@ -611,7 +609,7 @@ compute_loose_floor_fall (struct loose_floor *l)
          while jumping, for example) */
       place_on_the_ground (&a->f, &a->f.c);
       alert_guards (&kpmt);
-      if (a->id == current_kid_id) {
+      if (a->id == engine->current_kid_id) {
         mr.flicker = 2;
         mr.color = get_flicker_blood_color ();
       }
@@ -1053,8 +1051,8 @@ void
 loose_floor_fall_debug (void)
 {
   int i;
-  for (i = 0; i < loose_floor_nmemb; i++) {
-    struct loose_floor *l = &loose_floor[i];
+  for (i = 0; i < engine->loose_floor_nmemb; i++) {
+    struct loose_floor *l = &engine->loose_floor[i];
     if (l->action != FALL_LOOSE_FLOOR) continue;
     struct pos pv; pos2room (&l->p, room_view, &pv);
     struct coord cv; coord2room (&l->f.c, room_view, &cv);
@@ -1065,7 +1063,7 @@ loose_floor_fall_debug (void)
             cv.room, cv.x, cv.y,
             peq (&l->p, &pv),
             cpos (&l->p, &pv));
-    draw_falling_loose_floor (mr.cell[mr.dx][mr.dy].screen, &loose_floor[i].p,
+    draw_falling_loose_floor (mr.cell[mr.dx][mr.dy].screen, &engine->loose_floor[i].p,
                               em, vm);
   }
 }
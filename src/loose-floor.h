@@ -69,10 +69,6 @@
 #define PV_LOOSE_FLOOR_LEFT_01 "data/loose-floor/pv-left-01.png"
 #define PV_LOOSE_FLOOR_RIGHT_01 "data/loose-floor/pv-right-01.png"
 
-/* variables */
-extern struct loose_floor *loose_floor;
-extern size_t loose_floor_nmemb;
-
 /* functions */
 void load_loose_floor (void);
 void unload_loose_floor (void);
@@ -93,8 +93,6 @@ struct message_box about_dialog = {
   .flags = 0,
 };
 
-uint64_t play_time;
-bool play_time_stopped;
 enum vm vm = VGA;
 enum em em = DUNGEON;
 enum gpm gpm = JOYSTICK;
@@ -135,6 +133,7 @@ bool mouse_scream;
 struct skill skill = {.counter_attack_prob = INITIAL_KCA,
                       .counter_defense_prob = INITIAL_KCD};
 static bool replay_info;
+static char *compare_state_traces_filename[2];
 static bool skip_title;
 static bool level_module_given;
 static int start_replay_favorite = -1;
@@ -202,6 +201,7 @@ static struct argp_option options[] = {
   {"environment-mode", ENVIRONMENT_MODE_OPTION, "ENVIRONMENT-MODE", 0, "Select environment mode.  Valid values for ENVIRONMENT-MODE are: ORIGINAL, DUNGEON and PALACE.  The ORIGINAL value gives level modules autonomy in this choice for each particular level. This is the default.  This can be changed in-game using the F11 key binding.", 0},
   {"guard-mode", GUARD_MODE_OPTION, "GUARD-MODE", 0, "Select guard mode.  Valid values for GUARD-MODE are: ORIGINAL, GUARD, FAT-GUARD, VIZIER, SKELETON and SHADOW.  The ORIGINAL value gives level modules autonomy in this choice for each particular guard.  This is the default.  This can be changed in-game using the SHIFT+F11 key binding.  This option has no effect on replays.", 0},
 {"hue-mode", HUE_MODE_OPTION, "HUE-MODE", 0, "Select hue mode.  Valid values for HUE-MODE are: ORIGINAL, NONE, GREEN, GRAY, YELLOW and BLUE.  The ORIGINAL value gives level modules autonomy in this choice for each particular level.  This is the default.  For the classic behavior of the first version of the original game use NONE.  This can be changed in-game using the ALT+F11 key binding.", 0},
+  {"precompute-hues", PRECOMPUTE_HUES_OPTION, "BOOLEAN", OPTION_ARG_OPTIONAL, "Enable/disable hue precomputation.  When enabled, all hue variants of the environment sprites of each level are computed while the level starts, so switching hue never stalls the game.  The palette cache limit is raised to hold them.  The default is FALSE.", 0},
   {"display-flip-mode", DISPLAY_FLIP_MODE_OPTION, "DISPLAY-FLIP-MODE", 0, "Select display flip mode.  Valid values for DISPLAY-FLIP-MODE are: NONE, VERTICAL, HORIZONTAL and VERTICAL-HORIZONTAL.  The default is NONE.  This can be changed in-game using the SHIFT+I key binding.", 0},
   {"mirror-mode", MIRROR_MODE_OPTION, "BOOLEAN", OPTION_ARG_OPTIONAL, "Enable/disable mirror mode.  In mirror mode the screen and the keyboard are flipped horizontally.  This is equivalent of specifying both the options --display-flip-mode=HORIZONTAL and --gamepad-flip-mode=HORIZONTAL.  The default is FALSE.  This can be changed in-game using the SHIFT+I and SHIFT+K key bindings for the display and keyboard, respectively.  See also the '--mirror-level' option.", 0},
   {"blind-mode", BLIND_MODE_OPTION, "BOOLEAN", OPTION_ARG_OPTIONAL, "Enable/disable blind mode.  In blind mode background and non-animated sprites are not drawn. The default is FALSE.  This can be changed in-game using the SHIFT+B key binding.", 0},
@@ -243,8 +243,13 @@ static struct argp_option options[] = {
   {"validate-replay-chain", VALIDATE_REPLAY_CHAIN_OPTION, "MODE", 0, "Validate replay chain.  Valid values for MODE are: NONE, READ and WRITE.  The default is NONE.  If MODE is READ, instead of reporting invalid sequent replay pairs, modify replay parameters just enough to validate pairs.  Notice that this requires consecutive replay levels to succeed.  WRITE does the same, additionally updating replay files in case the resulting chain is complete and valid.", 0},
   {"print-replay-favorites", PRINT_REPLAY_FAVORITES_OPTION, NULL, OPTION_NO_USAGE, "Print replay favorites list.  Exit with zero status in case the list is non-empty (non-zero otherwise).", 0},
   {"replay-favorite", REPLAY_FAVORITE_OPTION, "N", OPTION_NO_USAGE, "Go to replay favorite N at start.  See option '--print-replay-favorites' for the list of available replay favorites.", 0},
+  {"replay-state-hash", REPLAY_STATE_HASH_OPTION, "BOOLEAN", OPTION_ARG_OPTIONAL, "Enable/disable embedding a hash of the simulation state of every cycle in recorded replays.  Replays carrying those hashes report the first cycle their playback diverges from the recording.  The default is FALSE.", 0},
+  {"state-trace", STATE_TRACE_OPTION, "FILE", OPTION_NO_USAGE, "Write a hash and a dump of the simulation state of every cycle to FILE.  Use '--compare-state-traces' to find where two such traces diverge.", 0},
+  {"compare-state-traces", COMPARE_STATE_TRACES_OPTION, "FILE0,FILE1", OPTION_NO_USAGE, "Compare state traces FILE0 and FILE1, print their first diverging cycle and state field, and exit.  Exit with zero status in case they are identical (non-zero otherwise).", 0},
+  {"headless", HEADLESS_OPTION, "BOOLEAN", OPTION_ARG_OPTIONAL, "Enable/disable headless mode.  In headless mode replay chains are simulated in a tight loop, with no event processing, no timer and no drawing, so their throughput is limited only by the game logic.  Results are exactly the same as those of regular playback.  This implies '--rendering=NONE'.  The default is FALSE.", 0},
+  {"replay-jobs", REPLAY_JOBS_OPTION, "N", 0, "Number of replays of the command line replay chain simulated at once in headless mode.  Each one is played by a separate worker process and the results are reported in chain order, exactly as if the chain had been played sequentially.  If N is 0, use as many workers as there are processors.  If N is 1, play the chain sequentially in a single process.  The default is 0.", 0},
 
-  {NULL, 0, NULL, OPTION_DOC, "Unless '--replay-info' is specified, REPLAY files given on command line are added to the replay chain in order to play and check for completion and sequence validity.  The replay chain is sorted by increasing level order before processing.  For each replay in the chain a replay summary is printed.  Unless '--validate-replay-chain' is specified, in case there is any invalid sequent pairs in the chain, their incompatible options are printed between their replay summaries.  For any complete replay summary, its 'final' field lists arguments intended to be used for continuing the game from where its respective replay ends.  If the replay chain is complete and valid, MININIM automatically exits with zero status (non-zero otherwise).  Replay chains can be played in-game using the F7 key binding.  One can use '--time-frequency' and its related key bindings to control the playback speed, in particular use '--time-frequency=0' and '--rendering=NONE' for the fastest batch processing of replays.", 0},
+  {NULL, 0, NULL, OPTION_DOC, "Unless '--replay-info' is specified, REPLAY files given on command line are added to the replay chain in order to play and check for completion and sequence validity.  The replay chain is sorted by increasing level order before processing.  For each replay in the chain a replay summary is printed.  Unless '--validate-replay-chain' is specified, in case there is any invalid sequent pairs in the chain, their incompatible options are printed between their replay summaries.  For any complete replay summary, its 'final' field lists arguments intended to be used for continuing the game from where its respective replay ends.  If the replay chain is complete and valid, MININIM automatically exits with zero status (non-zero otherwise).  Replay chains can be played in-game using the F7 key binding.  One can use '--time-frequency' and its related key bindings to control the playback speed, in particular use '--headless' for the fastest batch processing of replays.", 0},
 
   {NULL, 0, NULL, OPTION_DOC, "Replay favorites allow the user to conveniently reach previously marked points in replays.  They can be easily managed and used from the Play>Favorites menu and their records are kept in the main configuration file.", 0},
 
@@ -263,6 +268,9 @@ static struct argp_option options[] = {
   {"sound-gain", SOUND_GAIN_OPTION, "F", 0, "Set sound volume gain to F.  This number is multiplied by the volume of sound effects in order to scale they down proportionally in case the default is too loud for the user.  The default is 1.0.  Valid floating values range from 0.0 (disables sound) to 1.0 (default volume).  This can be changed in-game using the CTRL+S key binding.", 0},
   {"skip-title", SKIP_TITLE_OPTION, "BOOLEAN", OPTION_ARG_OPTIONAL, "Skip title screen.  The default is FALSE.", 0},
   {"inhibit-screensaver", INHIBIT_SCREENSAVER_OPTION, "BOOLEAN", OPTION_ARG_OPTIONAL, "Prevent the system screensaver from starting up.  The default is TRUE.", 0},
+  {"telemetry", TELEMETRY_OPTION, "FILE", OPTION_NO_USAGE, "Write per cycle timing histograms of the whole session to FILE at exit.  For each of computation, drawing, display flipping, event waiting and frame interval, FILE gives the mean, the 50th, 90th, 99th and 99.9th percentiles and the maximum, followed by the histogram itself, along with the number of dropped frames.", 0},
+  {"telemetry-overlay", TELEMETRY_OVERLAY_OPTION, "BOOLEAN", OPTION_ARG_OPTIONAL, "Enable/disable the telemetry overlay, which shows the 50th and 99th percentiles and the maximum of the same timings over the last cycles, above the bottom text line.  The default is FALSE.  This can be changed in-game using the SHIFT+F key binding.", 0},
+  {"profile-trace", PROFILE_TRACE_OPTION, "FILE", OPTION_NO_USAGE, "Time the main engine stages (level computation, multi-room drawing, display flipping, palette application and cache updates) during the whole session and write them to FILE at exit, in the Chrome trace event format.  The same timers can be started, reported and dumped by scripts through 'mininim.profiler'.", 0},
   {"random-seed", RANDOM_SEED_OPTION, "N", 0, "Set initial random seed to N.  If N is zero, the initial random seed is derived from current time.  This is the default.  Valid integers range from 0 to INT_MAX.  This option is potentially useful for debugging purposes.", 0},
 
   /* Easter eggs */
@@ -708,6 +716,7 @@ parser (int key, char *arg, struct argp_state *state)
   struct int_range display_mode_range = {-1, al_get_num_display_modes () - 1};
   struct float_range gamepad_rumble_gain_range = {0.0,1.0};
   struct int_range random_seed_range = {0, INT_MAX};
+  struct int_range replay_jobs_range = {0, INT_MAX};
   struct float_range sound_gain_range = {0.0,1.0};
   struct int_range replay_favorites_range = {0, replay_favorite_nmemb - 1};
 
@@ -906,7 +915,7 @@ Levels have been converted using module %s into native format at\n\
                          &int_val0, &int_val1, &int_val2,
                          &start_pos_room_range, &start_pos_floor_range, &start_pos_place_range);
     if (e) return e;
-    new_pos (&start_pos, &global_level, int_val0, int_val1, int_val2);
+    new_pos (&start_pos, &engine->level, int_val0, int_val1, int_val2);
     break;
   case TIME_LIMIT_OPTION:
     e = optval_to_int (&i, key, arg, state, &time_limit_range, 0);
@@ -1101,13 +1110,56 @@ Levels have been converted using module %s into native format at\n\
     case 2: validate_replay_chain = WRITE_VALIDATE_REPLAY_CHAIN; break;
     }
     break;
+  case REPLAY_JOBS_OPTION:
+    e = optval_to_int (&i, key, arg, state, &replay_jobs_range, 0);
+    if (e) return e;
+    replay_jobs = i;
+    break;
+  case REPLAY_STATE_HASH_OPTION:
+    replay_state_hash = optval_to_bool (arg);
+    break;
+  case PRECOMPUTE_HUES_OPTION:
+    precompute_hues = optval_to_bool (arg);
+    break;
+  case STATE_TRACE_OPTION:
+    set_string_var (&state_trace_filename, arg);
+    break;
+  case TELEMETRY_OPTION:
+    set_string_var (&telemetry_filename, arg);
+    break;
+  case TELEMETRY_OVERLAY_OPTION:
+    telemetry_overlay = optval_to_bool (arg);
+    break;
+  case PROFILE_TRACE_OPTION:
+    set_string_var (&profiler_trace_filename, arg);
+    engine_profiling = true;
+    break;
+  case COMPARE_STATE_TRACES_OPTION:
+    {
+      char *comma = strchr (arg, ',');
+      if (! comma) {
+        argp_error (state, "'--compare-state-traces' requires two"
+                    " comma-separated files");
+        return EINVAL;
+      }
+      al_free (compare_state_traces_filename[0]);
+      al_free (compare_state_traces_filename[1]);
+      compare_state_traces_filename[0] =
+        xasprintf ("%.*s", (int) (comma - arg), arg);
+      compare_state_traces_filename[1] = xasprintf ("%s", comma + 1);
+    }
+    break;
+  case HEADLESS_OPTION:
+    headless = optval_to_bool (arg);
+    if (headless) rendering = NONE_RENDERING;
+    break;
   case SCREAM_OPTION:
     scream = optval_to_bool (arg);
     break;
   case RANDOM_SEED_OPTION:
     e = optval_to_int (&i, key, arg, state, &random_seed_range, 0);
     if (e) return e;
-    random_seed = i;
+    engine->random_seed = i;
     break;
   case ARGP_KEY_ARG:
     if (add_replay_file_to_replay_chain (arg)) {
@@ -1424,13 +1476,23 @@ main (int _argc, char **_argv)
   config_info.type = CI_COMMAND_LINE;
   argp_parse (&argp, argc, argv, 0, NULL, &config_info);
 
+  if (compare_state_traces_filename[0])
+    exit (compare_state_traces (compare_state_traces_filename[0],
+                                compare_state_traces_filename[1]));
+
   if (replay_info) {
     if (replay_chain_nmemb == 0)
       error (-1, 0, "empty replay chain");
     print_replay_chain_info ();
+    save_replay_archive ();
     exit (0);
   }
 
+  /* replay workers are forked before the display, the audio system and
+     their threads come into existence */
+  if (start_replay_favorite < 0) play_replay_chain_in_parallel ();
+
+  init_engine ();
   init_dialog ();
   init_video ();
   init_audio ();
@@ -1451,6 +1513,7 @@ main (int _argc, char **_argv)
   init_script ();
 
   /* load assets */
+  start_bitmap_atlas ();
   run_load_hook (main_L);
 
   load_icons ();
@@ -1458,6 +1521,7 @@ main (int _argc, char **_argv)
   load_audio_data ();
   load_level ();
   load_cutscenes ();
+  stop_bitmap_atlas ();
 
   load_callback = NULL;
 
@@ -1478,7 +1542,7 @@ main (int _argc, char **_argv)
   if (skip_title) goto play_game;
 
  restart_game:
-  play_time = 0;
+  engine->play_time = 0;
   cutscene_mode (true);
   al_set_system_mouse_cursor (display, ALLEGRO_SYSTEM_MOUSE_CURSOR_DEFAULT);
   clear_bitmap (cutscene_screen, BLACK);
@@ -1572,6 +1636,13 @@ void
 quit_game (void)
 {
   finalize_script ();
+  finalize_engine ();
+  stop_replay_journal (false);
+  save_replay_archive ();
+  free_replay_archive ();
+  stop_state_trace ();
+  finalize_profiler ();
+  finalize_telemetry ();
 
   unload_icons ();
   unload_level ();
@@ -1785,7 +1856,7 @@ save_game (char *filename, int priority)
   char *start_level_str, *start_time_str, *time_limit_str,
     *total_lives_str, *kca_str, *kcd_str;
 
-  start_level_str = xasprintf ("%i", global_level.n);
+  start_level_str = xasprintf ("%i", engine->level.n);
   start_time_str = xasprintf ("%ju", start_level_time);
   time_limit_str = xasprintf ("%ju", time_limit);
   total_lives_str = xasprintf ("%i", total_lives);
@@ -96,6 +96,8 @@
 #include "dialog.h"
 #include "xconfig.h"
 #include "diff.h"
+#include "profiler.h"
+#include "telemetry.h"
 
 #include "anim.h"
 #include "arch.h"
@@ -110,6 +112,7 @@
 #include "fix.h"
 #include "cutscenes.h"
 #include "door.h"
+#include "engine.h"
 #include "fight.h"
 #include "fire.h"
 #include "floor.h"
@@ -193,6 +196,8 @@
 #include "multi-room.h"
 #include "box.h"
 #include "replay.h"
+#include "replay-archive.h"
+#include "state-hash.h"
 #include "ui.h"
 #include "xmath.h"
 #include "xstring.h"
@@ -237,8 +242,6 @@ void handle_message_box_thread (void);
 
 /* variables */
 extern enum level_module level_module;
-extern uint64_t play_time;
-extern bool play_time_stopped;
 extern enum vm vm;
 extern enum gm gm;
 extern enum em em;
@@ -32,26 +32,22 @@ size_t changed_pos_nmemb = 0;
 int *changed_room = NULL;
 size_t changed_room_nmemb = 0;
 
+/* one-based index into CHANGED_POS of each changed position (zero if
+   it hasn't changed), number of changed positions per room and
+   whether each room has changed as a whole */
+static size_t changed_pos_index[ROOMS][FLOORS][PLACES];
+static size_t changed_pos_room_nmemb[ROOMS];
+static bool changed_room_set[ROOMS];
+
 void
 optimize_changed_pos (void)
 {
   if (changed_pos_nmemb < FLOORS * PLACES) return;
-  size_t total = 0;
-  struct pos p; new_pos (&p, &global_level, -1, -1, -1);
-  for (p.room = 1; p.room < ROOMS; p.room++) {
-    int per_room = 0;
-    if (has_room_changed (p.room)) continue;
-    for (p.floor = 0; p.floor < FLOORS; p.floor++)
-      for (p.place = 0; p.place < PLACES; p.place++) {
-        if (get_changed_pos (&p)
-            && ++per_room > OPTIMIZE_CHANGED_POS_THRESHOLD) {
-          register_changed_room (p.room);
-          goto next_room;
-        }
-        if (++total > changed_pos_nmemb) return;
-      }
-  next_room:;
-  }
+  int room;
+  for (room = 1; room < ROOMS; room++)
+    if (changed_pos_room_nmemb[room] > OPTIMIZE_CHANGED_POS_THRESHOLD
+        && ! has_room_changed (room))
+      register_changed_room (room);
 }
 
 void
@@ -65,33 +61,51 @@ register_changed_pos (struct pos *p)
     add_to_array (&np, 1, changed_pos, &changed_pos_nmemb,
                   changed_pos_nmemb, sizeof (*changed_pos));
 
-  qsort (changed_pos, changed_pos_nmemb, sizeof (*changed_pos),
-         (m_comparison_fn_t) cpos);
+  changed_pos_index[np.room][np.floor][np.place] = changed_pos_nmemb;
+  changed_pos_room_nmemb[np.room]++;
 }
 
 struct pos *
 get_changed_pos (struct pos *p)
 {
-  return bsearch (p, changed_pos, changed_pos_nmemb, sizeof (*p),
-                  (m_comparison_fn_t) cpos);
+  size_t i = changed_pos_index[p->room][p->floor][p->place];
+  return i ? &changed_pos[i - 1] : NULL;
 }
 
 struct pos *
 get_changed_pos_by_room (int room)
 {
-  struct pos p;
-  p.room = room;
+  if (! changed_pos_room_nmemb[room]) return NULL;
+
+  int floor, place;
+  for (floor = 0; floor < FLOORS; floor++)
+    for (place = 0; place < PLACES; place++) {
+      size_t i = changed_pos_index[room][floor][place];
+      if (i) return &changed_pos[i - 1];
+    }
 
-  return bsearch (&p, changed_pos, changed_pos_nmemb, sizeof (p),
-                  (m_comparison_fn_t) cpos_by_room);
+  return NULL;
 }
 
 void
 remove_changed_pos (struct pos *p)
 {
   size_t i =  p - changed_pos;
+  struct pos *last = &changed_pos[changed_pos_nmemb - 1];
+
+  changed_pos_index[p->room][p->floor][p->place] = 0;
+  changed_pos_room_nmemb[p->room]--;
+
+  /* fill the hole with the last element, so removal doesn't shift
+     the whole array */
+  if (p != last) {
+    *p = *last;
+    changed_pos_index[p->room][p->floor][p->place] = i + 1;
+  }
+
   changed_pos =
-    remove_from_array (changed_pos, &changed_pos_nmemb, i, 1, sizeof (*p));
+    remove_from_array (changed_pos, &changed_pos_nmemb,
+                       changed_pos_nmemb - 1, 1, sizeof (*p));
 }
 
 void
@@ -103,11 +117,10 @@ register_changed_room (int room)
     add_to_array (&room, 1, changed_room, &changed_room_nmemb,
                   changed_room_nmemb, sizeof (room));
 
-  qsort (changed_room, changed_room_nmemb, sizeof (room),
-         (m_comparison_fn_t) cint);
+  changed_room_set[room] = true;
 
   struct pos p;
-  new_pos (&p, &global_level, room, -1, -1);
+  new_pos (&p, &engine->level, room, -1, -1);
 
   p.place = 0;
   for (p.floor = 0; p.floor < FLOORS; p.floor++)
@@ -122,8 +135,24 @@ register_changed_room (int room)
 bool
 has_room_changed (int room)
 {
-  return bsearch (&room, changed_room, changed_room_nmemb, sizeof (room),
-                  (m_comparison_fn_t) cint);
+  return room >= 0 && room < ROOMS && changed_room_set[room];
+}
+
+void
+clear_changed_pos_and_room (void)
+{
+  size_t i;
+  for (i = 0; i < changed_pos_nmemb; i++) {
+    struct pos *p = &changed_pos[i];
+    changed_pos_index[p->room][p->floor][p->place] = 0;
+    changed_pos_room_nmemb[p->room] = 0;
+  }
+
+  for (i = 0; i < changed_room_nmemb; i++)
+    changed_room_set[changed_room[i]] = false;
+
+  destroy_array ((void **) &changed_pos, &changed_pos_nmemb);
+  destroy_array ((void **) &changed_room, &changed_room_nmemb);
 }
 
 static void
@@ -142,6 +171,7 @@ destroy_multi_room (void)
     }
     al_free (mr.cell);
     al_free (mr.last.cell);
+    al_free (mr.room_cell);
   };
 }
 
@@ -169,6 +199,41 @@ redim_multi_room (int w, int h)
       mr.cell[x][y].cache = NULL;
     }
   }
+  mr.room_cell = xcalloc (w * h, sizeof (* mr.room_cell));
+  mr_index_room_cells ();
+}
+
+void
+mr_index_room_cells (void)
+{
+  int x, y, r;
+
+  /* counting sort of cells by room */
+  memset (mr.room_cell_index, 0, sizeof (mr.room_cell_index));
+  for (y = mr.h - 1; y >= 0; y--)
+    for (x = 0; x < mr.w; x++)
+      mr.room_cell_index[mr.cell[x][y].room + 1]++;
+
+  for (r = 0; r < ROOMS; r++)
+    mr.room_cell_index[r + 1] += mr.room_cell_index[r];
+
+  int next[ROOMS];
+  memcpy (next, mr.room_cell_index, sizeof (next));
+  for (y = mr.h - 1; y >= 0; y--)
+    for (x = 0; x < mr.w; x++) {
+      struct mr_cell_coord *c =
+        &mr.room_cell[next[mr.cell[x][y].room]++];
+      c->x = x;
+      c->y = y;
+    }
+}
+
+int
+mr_room_cells (int room, struct mr_cell_coord **c)
+{
+  if (room < 0 || room >= ROOMS) return 0;
+  *c = &mr.room_cell[mr.room_cell_index[room]];
+  return mr.room_cell_index[room + 1] - mr.room_cell_index[room];
 }
 
 void
@@ -207,6 +272,10 @@ mr_get_resolution (int *w, int *h)
   *h = cutscene ? CUTSCENE_HEIGHT : ROOM_HEIGHT * mr.h + 11;
 }
 
+/* no cell before this one (in column-major order) is waiting to be
+   mapped */
+static int next_multi_room_cell_index;
+
 void
 clear_multi_room_cells (void)
 {
@@ -216,32 +285,42 @@ clear_multi_room_cells (void)
       mr.cell[x][y].done = false;
       mr.cell[x][y].room = -1;
     }
+  next_multi_room_cell_index = 0;
 }
 
 bool
 next_multi_room_cell (int *rx, int *ry)
 {
-  int x, y;
-  for (x = 0; x < mr.w; x++)
-    for (y = 0; y < mr.h; y++)
-      if (mr.cell[x][y].room > 0
-          && ! mr.cell[x][y].done) {
-        *rx = x;
-        *ry = y;
-        return true;
-      }
+  int i;
+  for (i = next_multi_room_cell_index; i < mr.w * mr.h; i++) {
+    int x = i / mr.h;
+    int y = i % mr.h;
+    if (mr.cell[x][y].room > 0
+        && ! mr.cell[x][y].done) {
+      next_multi_room_cell_index = i;
+      *rx = x;
+      *ry = y;
+      return true;
+    }
+  }
 
+  next_multi_room_cell_index = i;
   return false;
 }
 
+static void
+mr_map_neighbor_room (int r, int x, int y)
+{
+  if (mr.cell[x][y].room != -1) return;
+  mr.cell[x][y].room = r;
+  next_multi_room_cell_index =
+    min_int (next_multi_room_cell_index, x * mr.h + y);
+}
+
 int
 mr_count_rooms (void)
 {
-  int x, y, c = 0;
-  for (x = 0; x < mr.w; x++)
-    for (y = 0; y < mr.h; y++)
-      c += (mr.cell[x][y].room > 0) ? 1 : 0;
-  return c;
+  return mr.room_cell_index[ROOMS] - mr.room_cell_index[1];
 }
 
 bool
@@ -340,21 +419,19 @@ mr_center_room (int room)
 void
 mr_map_room (int r, int x, int y)
 {
-  int rl = roomd (&global_level, r, LEFT);
-  int rr = roomd (&global_level, r, RIGHT);
-  int ra = roomd (&global_level, r, ABOVE);
-  int rb = roomd (&global_level, r, BELOW);
+  int rl = roomd (&engine->level, r, LEFT);
+  int rr = roomd (&engine->level, r, RIGHT);
+  int ra = roomd (&engine->level, r, ABOVE);
+  int rb = roomd (&engine->level, r, BELOW);
 
   mr.cell[x][y].room = r;
   mr.cell[x][y].done = true;
-  if (x > 0 && mr.cell[x - 1][y].room == -1)
-    mr.cell[x - 1][y].room = rl;
-  if (x < mr.w - 1 && mr.cell[x + 1][y].room == -1)
-    mr.cell[x + 1][y].room = rr;
-  if (y > 0 && mr.cell[x][y - 1].room == -1)
-    mr.cell[x][y - 1].room = ra;
-  if (y < mr.h - 1 && mr.cell[x][y + 1].room == -1)
-    mr.cell[x][y + 1].room = rb;
+  next_multi_room_cell_index =
+    min_int (next_multi_room_cell_index, x * mr.h + y);
+  if (x > 0) mr_map_neighbor_room (rl, x - 1, y);
+  if (x < mr.w - 1) mr_map_neighbor_room (rr, x + 1, y);
+  if (y > 0) mr_map_neighbor_room (ra, x, y - 1);
+  if (y < mr.h - 1) mr_map_neighbor_room (rb, x, y + 1);
 }
 
 struct mr_origin *
@@ -392,6 +469,7 @@ mr_set_origin (int room, int rx, int ry)
     for (y = 0; y < mr.h; y++) {
       if (mr.cell[x][y].room < 0) mr.cell[x][y].room = 0;
     }
+  mr_index_room_cells ();
 }
 
 void
@@ -451,7 +529,7 @@ mr_select_trans (enum dir d)
   case BELOW: dy = +1; break;
   }
 
-  int r = roomd (&global_level, mr.room, d);
+  int r = roomd (&engine->level, mr.room, d);
   if (r) {
     nmr_coord (mr.x + dx, mr.y + dy, &mr.x, &mr.y);
     mr_set_origin (r, mr.x, mr.y);
@@ -474,7 +552,7 @@ mr_view_trans (enum dir d)
     for (x = 0; x < mr.w; x++) {
       int r = mr.cell[x][y].room;
       if (r <= 0) continue;
-      r = roomd (&global_level, r, d);
+      r = roomd (&engine->level, r, d);
       if (r) {
         mr_set_origin (r, x, y);
         mr_stabilize_origin (&o, d);
@@ -565,7 +643,7 @@ mr_update_last_settings (void)
   mr.last.y = mr.y;
   mr.last.room = mr.room;
 
-  mr.last.level = global_level.n;
+  mr.last.level = engine->level.n;
   mr.last.em = em;
   mr.last.vm = vm;
   mr.last.hgc = hgc;
@@ -587,7 +665,7 @@ draw_animated_background (ALLEGRO_BITMAP *bitmap, int room)
 {
   room_view = room;
 
-  struct pos p; new_pos (&p, &global_level, room, -1, -1);
+  struct pos p; new_pos (&p, &engine->level, room, -1, -1);
 
   for (p.floor = FLOORS; p.floor >= 0; p.floor--)
     for (p.place = -1; p.place < PLACES; p.place++)
@@ -606,7 +684,7 @@ draw_animated_foreground (ALLEGRO_BITMAP *bitmap, int room)
 {
   room_view = room;
 
-  struct pos p; new_pos (&p, &global_level, room, -1, -1);
+  struct pos p; new_pos (&p, &engine->level, room, -1, -1);
 
   /* loose_floor_fall_debug (); */
 
@@ -667,95 +745,157 @@ update_room0_cache (enum em em, enum vm vm)
 
   mr.dx = 0;
   mr.dy = 0;
+  start_draw_batch (room0);
   draw_room (room0, 0, em, vm);
+  end_draw_batch ();
 
   con_caching = false;
   mouse_pos = mouse_pos_bkp;
 }
 
+static void
+mr_set_room_dirty (int room, int x, int y, int w, int h)
+{
+  struct mr_cell_coord *c;
+  int i, n = mr_room_cells (room, &c);
+  for (i = 0; i < n; i++) {
+    struct drawn_rectangle *d = &mr.cell[c[i].x][c[i].y].dirty;
+    union_rectangle (d->x, d->y, d->w, d->h, x, y, w, h,
+                     &d->x, &d->y, &d->w, &d->h);
+  }
+}
+
 void
 update_cache_room (int room, enum em em, enum vm vm)
 {
-  int x, y;
+  struct mr_cell_coord *c;
+  int i, n = mr_room_cells (room, &c);
+  if (! n) return;
+
   con_caching = true;
 
-  for (y = mr.h - 1; y >= 0; y--)
-    for (x = 0; x < mr.w; x++)
-      if (mr.cell[x][y].room == room) {
-        if (room) {
-        room_view = mr.cell[x][y].room;
-        mr.dx = x;
-        mr.dy = y;
-        clear_bitmap (mr.cell[x][y].cache, TRANSPARENT_COLOR);
-        draw_room (mr.cell[x][y].cache, mr.cell[x][y].room, em, vm);
-        break;
-        } else draw_bitmap (room0, mr.cell[x][y].cache, 0, 0, 0);
-      }
+  /* a room is drawn only in the cache of its first cell, the one
+     mr_coord returns, which every other cell showing it copies
+     from */
+  if (room) {
+    int x = c[0].x, y = c[0].y;
+    room_view = room;
+    mr.dx = x;
+    mr.dy = y;
+    clear_bitmap (mr.cell[x][y].cache, TRANSPARENT_COLOR);
+    start_draw_batch (mr.cell[x][y].cache);
+    draw_room (mr.cell[x][y].cache, room, em, vm);
+    end_draw_batch ();
+    mr_set_room_dirty (room, 0, 0, ORIGINAL_WIDTH, ORIGINAL_HEIGHT);
+  } else
+    for (i = 0; i < n; i++)
+      draw_bitmap (room0, mr.cell[c[i].x][c[i].y].cache, 0, 0, 0);
+
   con_caching = false;
 }
 
 void
 update_cache (enum em em, enum vm vm)
 {
-  struct mr_room_list l;
-  mr_get_room_list (&l);
-
-  update_cache_room (0, em, vm);
+  begin_profiler_scope (UPDATE_CACHE_SCOPE);
+  int room;
+  for (room = 0; room < ROOMS; room++)
+    update_cache_room (room, em, vm);
+  end_profiler_scope (UPDATE_CACHE_SCOPE);
+}
 
-  size_t i;
-  for (i = 0; i < l.nmemb; i++)
-    update_cache_room (l.room[i], em, vm);
+static bool
+get_changed_pos_at_room (struct pos *p, int room, struct pos *q)
+{
+  /* the first view of P from ROOM in the order the whole room grid,
+     including its borders, would be scanned */
+  new_pos (q, p->l, room, -1, -1);
+  for (q->floor = FLOORS; q->floor >= -1; q->floor--)
+    for (q->place = -1; q->place < PLACES; q->place++)
+      if (q->floor < 0 || q->floor >= FLOORS || q->place < 0) {
+        if (peq (q, p)) return true;
+      } else if (room == p->room && q->floor == p->floor
+                 && q->place == p->place) return true;
+  return false;
+}
 
-  mr_destroy_room_list (&l);
+static bool
+is_pos_near_room (struct pos *p, int room)
+{
+  if (room == p->room) return true;
+
+  struct level *l = p->l;
+  int a = roomd (l, room, ABOVE);
+  int b = roomd (l, room, BELOW);
+
+  return (p->place == PLACES - 1
+          && (roomd (l, room, LEFT) == p->room
+              || roomd (l, a, LEFT) == p->room
+              || roomd (l, b, LEFT) == p->room))
+    || (p->floor == FLOORS - 1 && a == p->room)
+    || (p->floor == 0 && b == p->room);
 }
 
 void
 update_cache_pos (struct pos *p, enum em em, enum vm vm)
 {
-  struct pos q = *p;
+  if (! is_valid_pos (p)) return;
+
+  struct pos np; npos (p, &np);
   int x, y;
 
-  for (q.room = 1; q.room < ROOMS; q.room++) {
-    for (y = mr.h - 1; y >= 0; y--)
-      for (x = 0; x < mr.w; x++)
-        if (mr.cell[x][y].room == q.room)
-          for (q.floor = FLOORS; q.floor >= -1; q.floor--)
-            for (q.place = -1; q.place < PLACES; q.place++)
-              if (peq (&q, p) && ! has_room_changed (q.room)) {
-                ALLEGRO_BITMAP *bitmap = mr.cell[x][y].cache;
-
-                room_view = q.room;
-                mr.dx = x;
-                mr.dy = y;
-                con_caching = true;
-
-                push_clipping_rectangle
-                  (bitmap,
-                   PLACE_WIDTH * q.place - 1,
-                   PLACE_HEIGHT * q.floor - 17,
-                   2 * PLACE_WIDTH + 1, PLACE_HEIGHT + 3 + 17);
-
-                clear_bitmap (bitmap, TRANSPARENT_COLOR);
-
-                struct pos p0 = q;
-                for (p0.floor = q.floor + 1; p0.floor >= q.floor - 1;
-                     p0.floor--)
-                  for (p0.place = q.place - 2; p0.place <= q.place + 1;
-                       p0.place++)
-                    draw_conbg (bitmap, &p0, em, vm);
-
-                for (p0.floor = q.floor + 1; p0.floor >= q.floor - 1;
-                     p0.floor--)
-                  for (p0.place = q.place - 2; p0.place <= q.place + 1;
-                       p0.place++)
-                    draw_confg (bitmap, &p0, em, vm);
-
-                pop_clipping_rectangle ();
-
-                con_caching = false;
-                goto next_room;
-              }
-  next_room:;
+  /* Only rooms P is visible from (its own and those it borders) have
+     to be looked at, and only in the cell holding each room's
+     cache. */
+  int room;
+  for (room = 1; room < ROOMS; room++) {
+    struct pos q;
+    if (! is_pos_near_room (&np, room)
+        || has_room_changed (room)
+        || ! mr_coord (room, -1, &x, &y)
+        || ! get_changed_pos_at_room (&np, room, &q)) continue;
+
+    ALLEGRO_BITMAP *bitmap = mr.cell[x][y].cache;
+
+    room_view = q.room;
+    mr.dx = x;
+    mr.dy = y;
+    con_caching = true;
+
+    push_clipping_rectangle
+      (bitmap,
+       PLACE_WIDTH * q.place - 1,
+       PLACE_HEIGHT * q.floor - 17,
+       2 * PLACE_WIDTH + 1, PLACE_HEIGHT + 3 + 17);
+
+    clear_bitmap (bitmap, TRANSPARENT_COLOR);
+
+    start_draw_batch (bitmap);
+
+    struct pos p0 = q;
+    for (p0.floor = q.floor + 1; p0.floor >= q.floor - 1;
+         p0.floor--)
+      for (p0.place = q.place - 2; p0.place <= q.place + 1;
+           p0.place++)
+        draw_conbg (bitmap, &p0, em, vm);
+
+    for (p0.floor = q.floor + 1; p0.floor >= q.floor - 1;
+         p0.floor--)
+      for (p0.place = q.place - 2; p0.place <= q.place + 1;
+           p0.place++)
+        draw_confg (bitmap, &p0, em, vm);
+
+    end_draw_batch ();
+
+    pop_clipping_rectangle ();
+
+    mr_set_room_dirty (q.room,
+                       PLACE_WIDTH * q.place - 1,
+                       PLACE_HEIGHT * q.floor - 17,
+                       2 * PLACE_WIDTH + 1,
+                       PLACE_HEIGHT + 3 + 17);
+
+    con_caching = false;
   }
 }
 
@@ -772,6 +912,8 @@ draw_multi_rooms (void)
 {
   int x, y;
 
+  begin_profiler_scope (DRAW_MULTI_ROOMS_SCOPE);
+
   mr_set_origin (mr.room, mr.x, mr.y);
 
   bool mr_full_update = has_mr_view_changed ()
@@ -792,7 +934,7 @@ draw_multi_rooms (void)
       register_changed_pos (&mr.last.mouse_pos);
   }
 
-  if (anim_cycle == 0
+  if (engine->anim_cycle == 0
       || em != mr.last.em
       || vm != mr.last.vm
       || hgc != mr.last.hgc
@@ -803,14 +945,15 @@ draw_multi_rooms (void)
 
   size_t i;
 
-  if (anim_cycle == 0
+  if (engine->anim_cycle == 0
       || mr_full_update
       || em != mr.last.em
       || vm != mr.last.vm
       || hgc != mr.last.hgc
       || hue != mr.last.hue
-      || global_level.n != mr.last.level) {
+      || engine->level.n != mr.last.level) {
     update_cache (em, vm);
+    force_full_redraw = true;
   } else {
     bool depedv =
       ((em == DUNGEON && vm == VGA)
@@ -834,49 +977,80 @@ draw_multi_rooms (void)
 
     /* kept together so update_cache_pos and update_cache_room can
        access each other's arrays */
-    destroy_array ((void **) &changed_pos, &changed_pos_nmemb);
-    destroy_array ((void **) &changed_room, &changed_room_nmemb);
+    clear_changed_pos_and_room ();
   }
 
+  /* flickering changes the whole screen, as does the frame right
+     after it */
+  static bool flickered;
+  if (mr.flicker > 0 || flickered) force_full_redraw = true;
+  flickered = mr.flicker > 0;
+
+  struct drawn_rectangle *dr;
+
   for (y = mr.h - 1; y >= 0; y--)
     for (x = 0; x < mr.w; x++) {
-      clear_bitmap (mr.cell[x][y].screen, (mr.flicker > 0 && mr.flicker % 2)
+      struct multi_room_cell *c = &mr.cell[x][y];
+
+      clear_bitmap (c->screen, (mr.flicker > 0 && mr.flicker % 2)
                     ? mr.color : BLACK);
 
-      if (! mr.cell[x][y].room) continue;
+      /* what has been animated on the last frame must be restored */
+      union_rectangle (c->dirty.x, c->dirty.y, c->dirty.w, c->dirty.h,
+                       c->drawn.x, c->drawn.y, c->drawn.w, c->drawn.h,
+                       &c->dirty.x, &c->dirty.y, &c->dirty.w, &c->dirty.h);
+      c->drawn.w = c->drawn.h = 0;
+
+      if (! c->room) continue;
       mr.dx = x;
       mr.dy = y;
-      draw_animated_background (mr.cell[x][y].screen,
-                                mr.cell[x][y].room);
+      push_drawn_rectangle (c->screen);
+      start_draw_batch (c->screen);
+      draw_animated_background (c->screen, c->room);
+      end_draw_batch ();
+      dr = pop_drawn_rectangle ();
+      c->drawn = *dr;
     }
 
   if (mr.flicker > 0) mr.flicker--;
 
-  struct mr_room_list l;
-  mr_get_room_list (&l);
-
-  int xm, ym;
+  int room;
   if (! no_room_drawing)
-    for (i = 0; i < l.nmemb; i++) {
-      mr_coord (l.room[i], -1, &xm, &ym);
-      for (y = mr.h - 1; y >= 0; y--)
-        for (x = 0; x < mr.w; x++)
-          if (mr.cell[x][y].room == l.room[i])
-            draw_bitmap (mr.cell[xm][ym].cache,
-                         mr.cell[x][y].screen, 0, 0, 0);
+    for (room = 1; room < ROOMS; room++) {
+      struct mr_cell_coord *c;
+      int j, n = mr_room_cells (room, &c);
+      for (j = 0; j < n; j++)
+        draw_bitmap (mr.cell[c[0].x][c[0].y].cache,
+                     mr.cell[c[j].x][c[j].y].screen, 0, 0, 0);
     }
 
-  mr_destroy_room_list (&l);
+  /* actors are sorted as many times as there are non-empty cells, as
+     they used to be sorted again before drawing each of them, and
+     then sorted out by room once for all cells */
+  if (mr_count_rooms () > 0) bucket_anims ();
 
   for (y = mr.h - 1; y >= 0; y--)
     for (x = 0; x < mr.w; x++) {
-      if (! mr.cell[x][y].room) continue;
+      struct multi_room_cell *c = &mr.cell[x][y];
+      if (! c->room) continue;
       mr.dx = x;
       mr.dy = y;
-      draw_animated_foreground (mr.cell[x][y].screen, mr.cell[x][y].room);
+      push_drawn_rectangle (c->screen);
+      start_draw_batch (c->screen);
+      draw_animated_foreground (c->screen, c->room);
+      end_draw_batch ();
+      dr = pop_drawn_rectangle ();
+      union_rectangle (c->drawn.x, c->drawn.y, c->drawn.w, c->drawn.h,
+                       dr->x, dr->y, dr->w, dr->h,
+                       &c->drawn.x, &c->drawn.y, &c->drawn.w, &c->drawn.h);
+      union_rectangle (c->dirty.x, c->dirty.y, c->dirty.w, c->dirty.h,
+                       c->drawn.x, c->drawn.y, c->drawn.w, c->drawn.h,
+                       &c->dirty.x, &c->dirty.y, &c->dirty.w, &c->dirty.h);
     }
 
   mr_update_last_settings ();
+
+  end_profiler_scope (DRAW_MULTI_ROOMS_SCOPE);
 }
 
 void
@@ -909,31 +1083,28 @@ nmr_coord (int x, int y, int *rx, int *ry)
 bool
 mr_coord (int room, enum dir dir, int *rx, int *ry)
 {
-  int x, y;
-  for (y = mr.h - 1; y >= 0; y--)
-    for (x = 0; x < mr.w; x++)
-      if (room && mr.cell[x][y].room == room) {
-        switch (dir) {
-        case LEFT:
-          nmr_coord (x - 1, y, rx, ry);
-          return true;
-        case RIGHT:
-          nmr_coord (x + 1, y, rx, ry);
-          return true;
-        case ABOVE:
-          nmr_coord (x, y - 1, rx, ry);
-          return true;
-        case BELOW:
-          nmr_coord (x, y + 1, rx, ry);
-          return true;
-        default:
-          if (rx) *rx = x;
-          if (ry) *ry = y;
-          return true;
-        }
-      }
+  struct mr_cell_coord *c;
+  if (! room || ! mr_room_cells (room, &c)) return false;
 
-  return false;
+  int x = c[0].x, y = c[0].y;
+  switch (dir) {
+  case LEFT:
+    nmr_coord (x - 1, y, rx, ry);
+    return true;
+  case RIGHT:
+    nmr_coord (x + 1, y, rx, ry);
+    return true;
+  case ABOVE:
+    nmr_coord (x, y - 1, rx, ry);
+    return true;
+  case BELOW:
+    nmr_coord (x, y + 1, rx, ry);
+    return true;
+  default:
+    if (rx) *rx = x;
+    if (ry) *ry = y;
+    return true;
+  }
 }
 
 bool
@@ -949,17 +1120,11 @@ mr_get_room_list (struct mr_room_list *l)
   l->room = NULL;
   l->nmemb = 0;
 
-  int x, y;
-  for (x = 0; x < mr.w; x++)
-    for (y = 0; y < mr.h; y++) {
-      int room = mr.cell[x][y].room;
-      if (room && ! mr_room_list_has_room (l, room)) {
-        l->room = add_to_array (&room, 1, l->room, &l->nmemb,
-                                l->nmemb, sizeof (*l->room));
-        qsort (l->room, l->nmemb, sizeof (*l->room),
-               (m_comparison_fn_t) cint);
-      }
-    }
+  int room;
+  for (room = 1; room < ROOMS; room++)
+    if (mr.room_cell_index[room + 1] > mr.room_cell_index[room])
+      l->room = add_to_array (&room, 1, l->room, &l->nmemb,
+                              l->nmemb, sizeof (*l->room));
 
   return l;
 }
@@ -973,9 +1138,9 @@ mr_destroy_room_list (struct mr_room_list *l)
 int
 mr_count_uniq_rooms (void)
 {
-  struct mr_room_list l;
-  int c = mr_get_room_list (&l)->nmemb;
-  mr_destroy_room_list (&l);
+  int room, c = 0;
+  for (room = 1; room < ROOMS; room++)
+    c += mr.room_cell_index[room + 1] > mr.room_cell_index[room];
   return c;
 }
 
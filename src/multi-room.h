@@ -37,6 +37,8 @@ bool is_room_visible (int room);
 /* functions */
 bool has_mr_view_changed (void);
 void redim_multi_room (int w, int h);
+void mr_index_room_cells (void);
+int mr_room_cells (int room, struct mr_cell_coord **c);
 void create_multi_room_bitmaps (void);
 void set_multi_room (int w, int h);
 void mr_get_resolution (int *w, int *h);
@@ -67,6 +69,7 @@ struct pos *get_changed_pos_by_room (int room);
 void optimize_changed_pos (void);
 void remove_changed_pos (struct pos *pos);
 void register_changed_room (int room);
+void clear_changed_pos_and_room (void);
 bool has_room_changed (int room);
 void mr_update_last_settings (void);
 void multi_room_fit_stretch (void);
@@ -75,6 +78,7 @@ void apply_mr_fit_mode (void);
 bool mr_room_list_has_room (struct mr_room_list *l, int room);
 struct mr_room_list *mr_get_room_list (struct mr_room_list *l);
 void mr_destroy_room_list (struct mr_room_list *l);
+int mr_count_rooms (void);
 int mr_count_uniq_rooms (void);
 void mr_stabilize_origin (struct mr_origin *o, enum dir d);
 void mr_busy (void);
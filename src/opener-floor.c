@@ -44,9 +44,6 @@ ALLEGRO_BITMAP *dv_unpressed_opener_floor_base,
 ALLEGRO_BITMAP *pv_unpressed_opener_floor_base,
   *pv_unpressed_opener_floor_left, *pv_unpressed_opener_floor_right;
 
-struct opener_floor *opener_floor = NULL;
-size_t opener_floor_nmemb = 0;
-
 void
 load_opener_floor (void)
 {
@@ -138,11 +135,11 @@ register_opener_floor (struct pos *p)
 
   init_opener_floor (p, &o);
 
-  opener_floor =
-    add_to_array (&o, 1, opener_floor, &opener_floor_nmemb,
-                  opener_floor_nmemb, sizeof (o));
+  engine->opener_floor =
+    add_to_array (&o, 1, engine->opener_floor, &engine->opener_floor_nmemb,
+                  engine->opener_floor_nmemb, sizeof (o));
 
-  qsort (opener_floor, opener_floor_nmemb, sizeof (o),
+  qsort (engine->opener_floor, engine->opener_floor_nmemb, sizeof (o),
          compare_opener_floors);
 }
 
@@ -171,7 +168,7 @@ opener_floor_at_pos (struct pos *p)
   struct opener_floor *oo;
 
  search:
-  oo = bsearch (&o, opener_floor, opener_floor_nmemb, sizeof (o),
+  oo = bsearch (&o, engine->opener_floor, engine->opener_floor_nmemb, sizeof (o),
                 compare_opener_floors);
 
   if (oo && fg (p) != OPENER_FLOOR) {
@@ -190,23 +187,23 @@ opener_floor_by_event (struct pos *p, int event, int dir)
 {
   struct opener_floor *o;
   if (p) o = opener_floor_at_pos (p);
-  else o = &opener_floor[0];
+  else o = &engine->opener_floor[0];
 
   if (! o) {
-    o = &opener_floor[0];
+    o = &engine->opener_floor[0];
     p = NULL;
   }
 
   int i;
 
   if (dir < 0)
-    for (i = o - opener_floor - (p ? 1 : 0); i >= 0; i--) {
-      if (opener_floor[i].event == event) return &opener_floor[i];
+    for (i = o - engine->opener_floor - (p ? 1 : 0); i >= 0; i--) {
+      if (engine->opener_floor[i].event == event) return &engine->opener_floor[i];
     }
   else
-    for (i = o - opener_floor + (p ? 1 : 0);
-         i < opener_floor_nmemb; i++) {
-      if (opener_floor[i].event == event) return &opener_floor[i];
+    for (i = o - engine->opener_floor + (p ? 1 : 0);
+         i < engine->opener_floor_nmemb; i++) {
+      if (engine->opener_floor[i].event == event) return &engine->opener_floor[i];
     }
 
   return NULL;
@@ -215,9 +212,9 @@ opener_floor_by_event (struct pos *p, int event, int dir)
 void
 remove_opener_floor (struct opener_floor *o)
 {
-  size_t i =  o - opener_floor;
-  opener_floor =
-    remove_from_array (opener_floor, &opener_floor_nmemb, i, 1, sizeof (*o));
+  size_t i =  o - engine->opener_floor;
+  engine->opener_floor =
+    remove_from_array (engine->opener_floor, &engine->opener_floor_nmemb, i, 1, sizeof (*o));
 }
 
 void
@@ -232,7 +229,7 @@ press_opener_floor (struct pos *p, struct anim *a)
     kid_haptic (a, KID_HAPTIC_COLLISION);
     register_changed_pos (&o->p);
     o->prev_pressed = true;
-    o->priority = anim_cycle;
+    o->priority = engine->anim_cycle;
   }
 }
 
@@ -241,7 +238,7 @@ break_opener_floor (struct pos *p)
 {
   struct opener_floor *o = opener_floor_at_pos (p);
   if (! o) return;
-  open_door (o->p.l, o->event, anim_cycle, true);
+  open_door (o->p.l, o->event, engine->anim_cycle, true);
   register_con_undo
     (&undo, p,
      MIGNORE, MIGNORE, o->event + EVENTS, MIGNORE,
@@ -253,10 +250,10 @@ void
 unpress_opener_floors (void)
 {
   size_t i;
-  for (i = 0; i < opener_floor_nmemb; i++) {
-    opener_floor[i].prev_pressed =
-      opener_floor[i].pressed;
-    opener_floor[i].pressed = false;
+  for (i = 0; i < engine->opener_floor_nmemb; i++) {
+    engine->opener_floor[i].prev_pressed =
+      engine->opener_floor[i].pressed;
+    engine->opener_floor[i].pressed = false;
   }
 }
 
@@ -264,8 +261,8 @@ void
 register_changed_opener_floors (void)
 {
   size_t i;
-  for (i = 0; i < opener_floor_nmemb; i++) {
-    struct opener_floor *o = &opener_floor[i];
+  for (i = 0; i < engine->opener_floor_nmemb; i++) {
+    struct opener_floor *o = &engine->opener_floor[i];
     if (o->prev_pressed != o->pressed)
       register_changed_pos (&o->p);
   }
@@ -276,16 +273,16 @@ compute_opener_floors (void)
 {
   size_t i;
 
-  for (i = 0; i < opener_floor_nmemb;) {
-    struct opener_floor *o = &opener_floor[i];
+  for (i = 0; i < engine->opener_floor_nmemb;) {
+    struct opener_floor *o = &engine->opener_floor[i];
     if (fg (&o->p) == OPENER_FLOOR) {
       i++; continue;
     }
     remove_opener_floor (o);
   }
 
-  for (i = 0; i < opener_floor_nmemb; i++) {
-    struct opener_floor *o = &opener_floor[i];
+  for (i = 0; i < engine->opener_floor_nmemb; i++) {
+    struct opener_floor *o = &engine->opener_floor[i];
     if (o->pressed && ! o->broken) {
       if (! o->noise) {
         alert_guards (&o->p);
@@ -51,10 +51,6 @@
 #define PV_UNPRESSED_OPENER_FLOOR_LEFT "data/opener-floor/pv-unpressed-left.png"
 #define PV_UNPRESSED_OPENER_FLOOR_RIGHT "data/opener-floor/pv-unpressed-right.png"
 
-/* variables */
-extern struct opener_floor *opener_floor;
-extern size_t opener_floor_nmemb;
-
 /* functions */
 void load_opener_floor (void);
 void unload_opener_floor (void);
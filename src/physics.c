@@ -661,8 +661,8 @@ exchange_anim_pos (struct pos *p0, struct pos *p1, bool invert_dir)
 {
   if (peq (p0, p1)) return;
   int i, j;
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *a = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *a = &engine->anima[i];
 
     struct pos p;
     survey (_m, pos, &a->f, NULL, &p, NULL);
@@ -696,8 +696,8 @@ exchange_falling_floor_pos (struct pos *p0, struct pos *p1)
 {
   if (peq (p0, p1)) return;
   size_t i;
-  for (i = 0; i < loose_floor_nmemb; i++) {
-    struct loose_floor *l = &loose_floor[i];
+  for (i = 0; i < engine->loose_floor_nmemb; i++) {
+    struct loose_floor *l = &engine->loose_floor[i];
     if (l->action != FALL_LOOSE_FLOOR) continue;
     if (peq (&l->p, p0)) {
       l->f.c.x = p1->place * PLACE_WIDTH;
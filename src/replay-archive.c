@@ -0,0 +1,472 @@
+/*
+  replay-archive.c -- replay archive index module;
+
+  Copyright (C) 2015, 2016, 2017 Bruno Félix Rezende Ribeiro
+  <oitofelix@gnu.org>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mininim.h"
+
+/* The replay archive index keeps the header, length and last known
+   results of every replay file MININIM has loaded, keyed by absolute
+   path, modification time and size.  Replays whose file is unchanged
+   since it was indexed are added to the replay chain straight from
+   the index, and their gamepad states are only read from the file
+   when they are about to be played.  Entries are replaced one at a
+   time as soon as their file is found to have changed.
+
+   Modification times only have one second resolution, so a file
+   modified within the second it was indexed in could change again
+   unnoticed; such entries aren't trusted and the file is indexed
+   anew.  The results depend on the engine and on the level data too,
+   so the index is stamped with the identity of both and is discarded
+   as a whole when either doesn't match. */
+
+#define REPLAY_ARCHIVE_ENTRY_FIELDS 24
+
+struct replay_archive_entry *replay_archive;
+size_t replay_archive_nmemb;
+
+static bool replay_archive_loaded;
+static bool replay_archive_dirty;
+
+static char *get_replay_archive_filename (void);
+static char *get_replay_archive_identity (void);
+static intptr_t stat_data_file (char *filename);
+static void load_replay_archive (void);
+static bool stat_replay_file (char *filename, char **key,
+                              int64_t *mtime, int64_t *size);
+static struct replay_archive_entry *get_replay_archive_entry (char *key);
+static struct replay_archive_entry *
+add_replay_archive_entry (struct replay_archive_entry *e);
+static void pack_replay_archive_entry (struct replay_archive_entry *e,
+                                       uint32_t *v);
+static void unpack_replay_archive_entry (struct replay_archive_entry *e,
+                                         uint32_t *v);
+static int compare_replay_archive_entries (const void *_e0,
+                                           const void *_e1);
+
+struct replay *
+load_archived_replay (struct replay *replay_ret, char *filename)
+{
+  char *key;
+  int64_t mtime, size;
+  int64_t indexed = time (NULL);
+  if (! stat_replay_file (filename, &key, &mtime, &size))
+    return load_replay (replay_ret, filename);
+
+  load_replay_archive ();
+
+  struct replay_archive_entry *e = get_replay_archive_entry (key);
+  if (e && e->mtime == mtime && e->size == size && e->mtime < e->indexed) {
+    al_free (key);
+    *replay_ret = e->replay;
+    replay_ret->filename = xasprintf ("%s", filename);
+    replay_ret->deferred = true;
+    return replay_ret;
+  }
+
+  if (! load_replay (replay_ret, filename)) {
+    al_free (key);
+    return NULL;
+  }
+
+  struct replay_archive_entry ne;
+  memset (&ne, 0, sizeof (ne));
+  ne.filename = key;
+  ne.mtime = mtime;
+  ne.size = size;
+  ne.indexed = indexed;
+  ne.replay.version = replay_ret->version;
+  ne.replay.packed_boolean_config = replay_ret->packed_boolean_config;
+  ne.replay.movements = replay_ret->movements;
+  ne.replay.semantics = replay_ret->semantics;
+  ne.replay.start_level = replay_ret->start_level;
+  ne.replay.start_time = replay_ret->start_time;
+  ne.replay.time_limit = replay_ret->time_limit;
+  ne.replay.total_lives = replay_ret->total_lives;
+  ne.replay.kca = replay_ret->kca;
+  ne.replay.kcd = replay_ret->kcd;
+  ne.replay.random_seed = replay_ret->random_seed;
+  ne.replay.packed_gamepad_state_nmemb =
+    replay_ret->packed_gamepad_state_nmemb;
+
+  if (e) {
+    al_free (e->filename);
+    *e = ne;
+  } else add_replay_archive_entry (&ne);
+
+  replay_archive_dirty = true;
+
+  return replay_ret;
+}
+
+/* Results are only recorded for replays played with the initial
+   conditions stored in their file, because validation might have
+   changed them. */
+void
+archive_replay_results (struct replay *replay)
+{
+  char *key;
+  int64_t mtime, size;
+  if (! replay->filename
+      || ! stat_replay_file (replay->filename, &key, &mtime, &size))
+    return;
+
+  load_replay_archive ();
+
+  struct replay_archive_entry *e = get_replay_archive_entry (key);
+  al_free (key);
+
+  if (! e || e->mtime != mtime || e->size != size) return;
+
+  struct replay *r = &e->replay;
+  if (r->start_time != replay->start_time
+      || r->time_limit != replay->time_limit
+      || r->total_lives != replay->total_lives
+      || r->kca != replay->kca
+      || r->kcd != replay->kcd) return;
+
+  r->validated = true;
+  r->complete = replay->complete;
+  r->reason = replay->reason;
+  r->final_total_lives = replay->final_total_lives;
+  r->final_kca = replay->final_kca;
+  r->final_kcd = replay->final_kcd;
+
+  replay_archive_dirty = true;
+}
+
+void
+invalidate_archived_replay (char *filename)
+{
+  char *key;
+  int64_t mtime, size;
+  if (! stat_replay_file (filename, &key, &mtime, &size)) return;
+
+  load_replay_archive ();
+
+  struct replay_archive_entry *e = get_replay_archive_entry (key);
+  al_free (key);
+
+  if (! e) return;
+
+  al_free (e->filename);
+  replay_archive =
+    remove_from_array (replay_archive, &replay_archive_nmemb,
+                       e - replay_archive, 1, sizeof (*e));
+
+  replay_archive_dirty = true;
+}
+
+void
+save_replay_archive (void)
+{
+  if (! replay_archive_dirty) return;
+
+  al_make_directory (user_data_dir);
+  char *filename = get_replay_archive_filename ();
+  ALLEGRO_FILE *f = al_fopen (filename, "wb");
+  if (! f) {
+    error (0, al_get_errno (), "can't save replay archive index '%s'",
+           filename);
+    al_free (filename);
+    return;
+  }
+
+  bool success =
+    al_fwrite (f, REPLAY_ARCHIVE_SIGNATURE,
+               sizeof (REPLAY_ARCHIVE_SIGNATURE))
+    == sizeof (REPLAY_ARCHIVE_SIGNATURE)
+    && al_fwrite32le (f, REPLAY_ARCHIVE_VERSION) == 4;
+
+  char *identity = get_replay_archive_identity ();
+  size_t n = strlen (identity);
+  success = success && al_fwrite32le (f, n) == 4
+    && al_fwrite (f, identity, n) == n
+    && al_fwrite32le (f, replay_archive_nmemb) == 4;
+  al_free (identity);
+
+  size_t i, j;
+  for (i = 0; success && i < replay_archive_nmemb; i++) {
+    struct replay_archive_entry *e = &replay_archive[i];
+    n = strlen (e->filename);
+    success = al_fwrite32le (f, n) == 4
+      && al_fwrite (f, e->filename, n) == n;
+
+    uint32_t v[REPLAY_ARCHIVE_ENTRY_FIELDS];
+    pack_replay_archive_entry (e, v);
+    for (j = 0; success && j < REPLAY_ARCHIVE_ENTRY_FIELDS; j++)
+      success = al_fwrite32le (f, v[j]) == 4;
+  }
+
+  al_fclose (f);
+
+  if (success) replay_archive_dirty = false;
+  else {
+    error (0, al_get_errno (), "can't save replay archive index '%s'",
+           filename);
+    al_remove_filename (filename);
+  }
+
+  al_free (filename);
+}
+
+void
+free_replay_archive (void)
+{
+  size_t i;
+  for (i = 0; i < replay_archive_nmemb; i++)
+    al_free (replay_archive[i].filename);
+  destroy_array ((void *) &replay_archive, &replay_archive_nmemb);
+  replay_archive_loaded = false;
+  replay_archive_dirty = false;
+}
+
+static char *
+get_replay_archive_filename (void)
+{
+  return xasprintf ("%s%s", user_data_dir, REPLAY_ARCHIVE_FILENAME);
+}
+
+/* A missing or corrupted index is silently taken as empty, since
+   every replay can be indexed again from its file. */
+static void
+load_replay_archive (void)
+{
+  if (replay_archive_loaded) return;
+  replay_archive_loaded = true;
+
+  char *filename = get_replay_archive_filename ();
+  ALLEGRO_FILE *f = al_fopen (filename, "rb");
+  al_free (filename);
+  if (! f) return;
+
+  char signature[sizeof (REPLAY_ARCHIVE_SIGNATURE)];
+  al_fread (f, signature, sizeof (REPLAY_ARCHIVE_SIGNATURE));
+  uint32_t version = al_fread32le (f);
+  if (al_feof (f) || al_ferror (f)
+      || memcmp (signature, REPLAY_ARCHIVE_SIGNATURE,
+                 sizeof (REPLAY_ARCHIVE_SIGNATURE))
+      || version != REPLAY_ARCHIVE_VERSION) {
+    al_fclose (f);
+    return;
+  }
+
+  /* an index made by another build or for other level data is
+     replaced as a whole */
+  char *identity = get_replay_archive_identity ();
+  size_t identity_size = strlen (identity);
+  uint32_t n = al_fread32le (f);
+  bool same_identity = ! al_feof (f) && ! al_ferror (f)
+    && n == identity_size;
+  if (same_identity) {
+    char *s = xmalloc (n);
+    same_identity = al_fread (f, s, n) == n && ! memcmp (s, identity, n);
+    al_free (s);
+  }
+  al_free (identity);
+  uint32_t nmemb = al_fread32le (f);
+  if (! same_identity || al_feof (f) || al_ferror (f)) {
+    al_fclose (f);
+    replay_archive_dirty = true;
+    return;
+  }
+
+  size_t i, j;
+  for (i = 0; i < nmemb; i++) {
+    struct replay_archive_entry e;
+    memset (&e, 0, sizeof (e));
+
+    n = al_fread32le (f);
+    if (al_feof (f) || al_ferror (f)) break;
+    e.filename = xmalloc (n + 1);
+    if (al_fread (f, e.filename, n) != n) {
+      al_free (e.filename);
+      break;
+    }
+    e.filename[n] = '\0';
+
+    uint32_t v[REPLAY_ARCHIVE_ENTRY_FIELDS];
+    for (j = 0; j < REPLAY_ARCHIVE_ENTRY_FIELDS; j++)
+      v[j] = al_fread32le (f);
+    if (al_feof (f) || al_ferror (f)) {
+      al_free (e.filename);
+      break;
+    }
+    unpack_replay_archive_entry (&e, v);
+
+    replay_archive =
+      add_to_array (&e, 1, replay_archive, &replay_archive_nmemb,
+                    replay_archive_nmemb, sizeof (e));
+  }
+
+  al_fclose (f);
+
+  qsort (replay_archive, replay_archive_nmemb, sizeof (*replay_archive),
+         compare_replay_archive_entries);
+}
+
+/* The identity of the engine is the version and the executable's
+   modification time and size, which change with every build.  The
+   identity of the level data is the location, modification time and
+   size of every legacy level file, as found by 'load_resource'. */
+static char *
+get_replay_archive_identity (void)
+{
+  int64_t mtime = 0, size = 0;
+  char *key;
+  if (stat_replay_file (exe_filename, &key, &mtime, &size)) al_free (key);
+  char *identity = xasprintf ("%s %jd %jd", VERSION, (intmax_t) mtime,
+                              (intmax_t) size);
+
+  int i;
+  for (i = 1; i <= LEGACY_LEVELS; i++) {
+    char *filename = xasprintf ("data/legacy-levels/%02d", i);
+    char *path = (char *) load_resource (filename,
+                                         (load_resource_f) stat_data_file,
+                                         true);
+    al_free (filename);
+    mtime = size = 0;
+    if (path && stat_replay_file (path, &key, &mtime, &size)) al_free (key);
+    char *s = xasprintf ("%s\n%s %jd %jd", identity, path ? path : "",
+                         (intmax_t) mtime, (intmax_t) size);
+    al_free (identity);
+    al_free (path);
+    identity = s;
+  }
+
+  return identity;
+}
+
+static intptr_t
+stat_data_file (char *filename)
+{
+  return al_filename_exists (filename)
+    ? (intptr_t) xasprintf ("%s", filename) : 0;
+}
+
+static bool
+stat_replay_file (char *filename, char **key, int64_t *mtime,
+                  int64_t *size)
+{
+  ALLEGRO_FS_ENTRY *fse = al_create_fs_entry (filename);
+  if (! fse) return false;
+
+  bool exists = al_fs_entry_exists (fse)
+    && ! (al_get_fs_entry_mode (fse) & ALLEGRO_FILEMODE_ISDIR);
+
+  if (exists) {
+    *key = xasprintf ("%s", al_get_fs_entry_name (fse));
+    *mtime = al_get_fs_entry_mtime (fse);
+    *size = al_get_fs_entry_size (fse);
+  }
+
+  al_destroy_fs_entry (fse);
+  return exists;
+}
+
+static struct replay_archive_entry *
+get_replay_archive_entry (char *key)
+{
+  struct replay_archive_entry e;
+  e.filename = key;
+  return bsearch (&e, replay_archive, replay_archive_nmemb, sizeof (e),
+                  compare_replay_archive_entries);
+}
+
+static struct replay_archive_entry *
+add_replay_archive_entry (struct replay_archive_entry *e)
+{
+  size_t a = 0, b = replay_archive_nmemb;
+  while (a < b) {
+    size_t m = a + (b - a) / 2;
+    if (compare_replay_archive_entries (e, &replay_archive[m]) < 0) b = m;
+    else a = m + 1;
+  }
+
+  replay_archive =
+    add_to_array (e, 1, replay_archive, &replay_archive_nmemb,
+                  a, sizeof (*e));
+
+  return &replay_archive[a];
+}
+
+static void
+pack_replay_archive_entry (struct replay_archive_entry *e, uint32_t *v)
+{
+  struct replay *r = &e->replay;
+  *v++ = e->mtime;
+  *v++ = (uint64_t) e->mtime >> 32;
+  *v++ = e->size;
+  *v++ = (uint64_t) e->size >> 32;
+  *v++ = e->indexed;
+  *v++ = (uint64_t) e->indexed >> 32;
+  *v++ = r->version;
+  *v++ = r->packed_boolean_config;
+  *v++ = r->movements;
+  *v++ = r->semantics;
+  *v++ = r->start_level;
+  *v++ = r->start_time;
+  *v++ = r->time_limit;
+  *v++ = r->total_lives;
+  *v++ = r->kca;
+  *v++ = r->kcd;
+  *v++ = r->random_seed;
+  *v++ = r->packed_gamepad_state_nmemb;
+  *v++ = r->validated;
+  *v++ = r->complete;
+  *v++ = r->reason;
+  *v++ = r->final_total_lives;
+  *v++ = r->final_kca;
+  *v++ = r->final_kcd;
+}
+
+static void
+unpack_replay_archive_entry (struct replay_archive_entry *e, uint32_t *v)
+{
+  struct replay *r = &e->replay;
+  e->mtime = (int64_t) (v[0] | (uint64_t) v[1] << 32);
+  e->size = (int64_t) (v[2] | (uint64_t) v[3] << 32);
+  e->indexed = (int64_t) (v[4] | (uint64_t) v[5] << 32);
+  v += 6;
+  r->version = *v++;
+  r->packed_boolean_config = *v++;
+  r->movements = *v++;
+  r->semantics = *v++;
+  r->start_level = *v++;
+  r->start_time = *v++;
+  r->time_limit = *v++;
+  r->total_lives = *v++;
+  r->kca = *v++;
+  r->kcd = *v++;
+  r->random_seed = *v++;
+  r->packed_gamepad_state_nmemb = *v++;
+  r->validated = *v++;
+  r->complete = *v++;
+  r->reason = *v++;
+  r->final_total_lives = *v++;
+  r->final_kca = *v++;
+  r->final_kcd = *v++;
+}
+
+static int
+compare_replay_archive_entries (const void *_e0, const void *_e1)
+{
+  struct replay_archive_entry *e0 = (struct replay_archive_entry *) _e0;
+  struct replay_archive_entry *e1 = (struct replay_archive_entry *) _e1;
+  return strcmp (e0->filename, e1->filename);
+}
@@ -0,0 +1,46 @@
+/*
+  replay-archive.h -- replay archive index module;
+
+  Copyright (C) 2015, 2016, 2017 Bruno Félix Rezende Ribeiro
+  <oitofelix@gnu.org>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MININIM_REPLAY_ARCHIVE_H
+#define MININIM_REPLAY_ARCHIVE_H
+
+struct replay_archive_entry {
+  char *filename;
+  int64_t mtime;
+  int64_t size;
+  int64_t indexed;
+
+  /* header, length and results only; no gamepad states */
+  struct replay replay;
+};
+
+/* functions */
+struct replay *load_archived_replay (struct replay *replay_ret,
+                                     char *filename);
+void archive_replay_results (struct replay *replay);
+void invalidate_archived_replay (char *filename);
+void save_replay_archive (void);
+void free_replay_archive (void);
+
+/* variables */
+extern struct replay_archive_entry *replay_archive;
+extern size_t replay_archive_nmemb;
+
+#endif	/* MININIM_REPLAY_ARCHIVE_H */
@@ -20,6 +20,68 @@
 
 #include "mininim.h"
 
+#if PARALLEL_REPLAY_FEATURE
+#include <sys/wait.h>
+#endif
+
+struct replay_results {
+  bool complete;
+  enum replay_incomplete reason;
+  uint32_t final_total_lives;
+  uint32_t final_kca;
+  uint32_t final_kcd;
+  bool diverged;
+  uint64_t diverged_cycle;
+  uint64_t playback_cycles;
+  double playback_seconds;
+};
+
+#if PARALLEL_REPLAY_FEATURE
+struct replay_worker {
+  pid_t pid;
+  int fd;
+  size_t i;
+};
+
+static bool simulate_replays (size_t *index, size_t nmemb, int jobs);
+static pid_t spawn_replay_worker (size_t i, int *fd);
+static bool collect_replay_worker (struct replay_worker *w, int status);
+#endif
+
+struct replay_keyframe {
+  uint64_t cycle;
+  struct engine_snapshot s;
+};
+
+static struct replay_keyframe *replay_keyframe;
+static size_t replay_keyframe_nmemb;
+static size_t replay_keyframe_size;
+
+static ALLEGRO_FILE *replay_journal;
+static uint64_t replay_journal_nmemb;
+
+static void thin_replay_keyframes (void);
+static bool write_replay_header (ALLEGRO_FILE *f, struct replay *replay,
+                                 uint32_t version);
+static bool get_packed_gamepad_state (struct replay *replay, uint64_t i,
+                                      uint8_t *pgs);
+static bool load_deferred_replay (struct replay *replay);
+static bool inflate_replay (struct replay *replay);
+static uint8_t *encode_replay_runs (struct replay *replay, size_t *size,
+                                    struct replay_seek_point **index,
+                                    size_t *index_nmemb);
+static bool write_replay_runs (ALLEGRO_FILE *f, struct replay *replay,
+                               uint8_t *data, size_t size,
+                               struct replay_seek_point *index,
+                               size_t index_nmemb);
+static bool load_replay_stream (ALLEGRO_FILE *f, struct replay *replay);
+static bool read_replay_stream (struct replay *replay, uint64_t i,
+                                uint8_t *pgs);
+static bool read_replay_run (struct replay_stream *s);
+static void close_replay_stream (struct replay *replay);
+static uint32_t adler32 (uint32_t adler, uint8_t *data, size_t size);
+static char *get_replay_journal_filename (void);
+
 struct replay recorded_replay;
 
 struct replay *replay_chain;
@@ -49,6 +111,9 @@ int replay_next_number;
 enum validate_replay_chain validate_replay_chain =
   NONE_VALIDATE_REPLAY_CHAIN;
 
+int replay_jobs;
+int replay_worker_fd = -1;
+
 struct dialog save_replay_dialog = {
   .title = "Save replay",
   .patterns = "*.mrp;*.MRP",
@@ -123,12 +188,29 @@ store_replay_gamepad_state (struct replay *replay,
                             struct gamepad_state *gs,
                             uint64_t cycle)
 {
+  /* grow geometrically, so the cost per cycle is constant */
+  if (cycle >= replay->packed_gamepad_state_capacity) {
+    uint64_t capacity = replay->packed_gamepad_state_capacity;
+    capacity = capacity < REPLAY_INITIAL_CAPACITY
+      ? REPLAY_INITIAL_CAPACITY : capacity;
+    while (capacity <= cycle) capacity *= 2;
+    replay->packed_gamepad_state =
+      xrealloc (replay->packed_gamepad_state,
+                capacity * sizeof (* replay->packed_gamepad_state));
+    replay->packed_gamepad_state_capacity = capacity;
+  }
+
+  /* cycles skipped have null gamepad state */
+  if (cycle > replay->packed_gamepad_state_nmemb)
+    memset (&replay->packed_gamepad_state
+            [replay->packed_gamepad_state_nmemb], 0,
+            cycle - replay->packed_gamepad_state_nmemb);
+
   replay->packed_gamepad_state_nmemb = cycle + 1;
-  replay->packed_gamepad_state =
-    xrealloc (replay->packed_gamepad_state,
-              replay->packed_gamepad_state_nmemb
-              * sizeof (* replay->packed_gamepad_state));
   replay->packed_gamepad_state[cycle] = pack_gamepad_state (gs);
+
+  if (replay == &recorded_replay) flush_replay_journal (false);
+
   return replay;
 }
 
@@ -138,24 +220,232 @@ get_replay_gamepad_state (struct gamepad_state *gs,
                           size_t i)
 {
   memset (gs, 0, sizeof (* gs));
-  if (i < replay->packed_gamepad_state_nmemb)
-    unpack_gamepad_state (gs, replay->packed_gamepad_state[i]);
+  uint8_t pgs;
+  if (get_packed_gamepad_state (replay, i, &pgs))
+    unpack_gamepad_state (gs, pgs);
   else return NULL;
   return gs;
 }
 
+void
+store_replay_state_hash (struct replay *replay, uint64_t h, uint64_t cycle)
+{
+  if (cycle >= replay->state_hash_capacity) {
+    uint64_t capacity = replay->state_hash_capacity;
+    capacity = capacity < REPLAY_INITIAL_CAPACITY
+      ? REPLAY_INITIAL_CAPACITY : capacity;
+    while (capacity <= cycle) capacity *= 2;
+    replay->state_hash =
+      xrealloc (replay->state_hash, capacity * sizeof (* replay->state_hash));
+    replay->state_hash_capacity = capacity;
+  }
+
+  if (cycle > replay->state_hash_nmemb)
+    memset (&replay->state_hash[replay->state_hash_nmemb], 0,
+            (cycle - replay->state_hash_nmemb)
+            * sizeof (* replay->state_hash));
+
+  replay->state_hash[cycle] = h;
+  if (cycle >= replay->state_hash_nmemb)
+    replay->state_hash_nmemb = cycle + 1;
+}
+
+/* Only the first diverging cycle is reported, since every later one
+   is expected to diverge as well. */
+void
+check_replay_state_hash (struct replay *replay, uint64_t h, uint64_t cycle)
+{
+  if (replay->diverged || cycle >= replay->state_hash_nmemb
+      || replay->state_hash[cycle] == h) return;
+  replay->diverged = true;
+  replay->diverged_cycle = cycle;
+}
+
+static bool
+get_packed_gamepad_state (struct replay *replay, uint64_t i, uint8_t *pgs)
+{
+  if (replay->deferred && ! load_deferred_replay (replay)) return false;
+  if (i >= replay->packed_gamepad_state_nmemb) return false;
+  if (replay->stream) return read_replay_stream (replay, i, pgs);
+  *pgs = replay->packed_gamepad_state[i];
+  return true;
+}
+
+/* Replay file format version 2 stores the gamepad states as a
+   sequence of runs, each one a state byte followed by the run length
+   as an unsigned LEB128 varint, and ends with an Adler-32 checksum of
+   that data.  A seek index of (cycle, offset) pairs, with at most one
+   entry every REPLAY_KEYFRAME_PERIOD cycles, lets playback and
+   seeking decode straight from the file instead of keeping the whole
+   replay in memory.  Version 1 files, which store one raw byte per
+   cycle, are still loaded; the recording journal is written in that
+   format because it can be appended to. */
 bool
 save_replay (char *filename, struct replay *replay)
 {
+  /* the replay may be streamed from the very file being written */
+  if (! inflate_replay (replay)) return false;
+
+  /* remove trailing null gamepad states */
+  uint64_t *i = &replay->packed_gamepad_state_nmemb;
+  while (*i > 0 && replay->packed_gamepad_state[*i - 1] == 0)
+    (*i)--;
+
+  size_t size, index_nmemb;
+  struct replay_seek_point *index;
+  uint8_t *data = encode_replay_runs (replay, &size, &index, &index_nmemb);
+
   ALLEGRO_FILE *f = al_fopen (filename, "wb");
-  if (! f) return false;
+  bool success = f
+    && write_replay_header (f, replay, REPLAY_FILE_FORMAT_VERSION)
+    && write_replay_runs (f, replay, data, size, index, index_nmemb);
+  if (f) al_fclose (f);
+
+  al_free (data);
+  al_free (index);
+
+  invalidate_archived_replay (filename);
+
+  return success;
+}
+
+/* Replays added to the chain from the replay archive index have only
+   their header until the gamepad states are first needed. */
+static bool
+load_deferred_replay (struct replay *replay)
+{
+  replay->deferred = false;
+
+  struct replay r;
+  if (! load_replay (&r, replay->filename)) {
+    replay->packed_gamepad_state_nmemb = 0;
+    return false;
+  }
+
+  replay->packed_gamepad_state = r.packed_gamepad_state;
+  replay->packed_gamepad_state_nmemb = r.packed_gamepad_state_nmemb;
+  replay->packed_gamepad_state_capacity = r.packed_gamepad_state_capacity;
+  replay->stream = r.stream;
+  replay->state_hash = r.state_hash;
+  replay->state_hash_nmemb = r.state_hash_nmemb;
+  replay->state_hash_capacity = r.state_hash_capacity;
+  al_free (r.filename);
+  return true;
+}
+
+static bool
+inflate_replay (struct replay *replay)
+{
+  if (replay->deferred && ! load_deferred_replay (replay)) return false;
+  if (! replay->stream) return true;
+
+  uint64_t nmemb = replay->packed_gamepad_state_nmemb;
+  uint8_t *packed_gamepad_state = nmemb > 0 ? xmalloc (nmemb) : NULL;
+
+  uint64_t i;
+  for (i = 0; i < nmemb; i++)
+    if (! read_replay_stream (replay, i, &packed_gamepad_state[i])) {
+      al_free (packed_gamepad_state);
+      return false;
+    }
+
+  close_replay_stream (replay);
+  al_free (replay->stream->index);
+  al_free (replay->stream);
+  replay->stream = NULL;
+
+  replay->packed_gamepad_state = packed_gamepad_state;
+  replay->packed_gamepad_state_capacity = nmemb;
+  return true;
+}
+
+static uint8_t *
+encode_replay_runs (struct replay *replay, size_t *size,
+                    struct replay_seek_point **index, size_t *index_nmemb)
+{
+  uint64_t nmemb = replay->packed_gamepad_state_nmemb;
+  uint8_t *pgs = replay->packed_gamepad_state;
+
+  /* a run takes one state byte plus at most five varint bytes */
+  uint8_t *data = xmalloc (nmemb * 6 + 1);
+  size_t n = 0;
+
+  *index = NULL;
+  *index_nmemb = 0;
+
+  uint64_t i, j;
+  for (i = 0; i < nmemb; i = j) {
+    for (j = i + 1; j < nmemb && pgs[j] == pgs[i]; j++);
+
+    if (*index_nmemb == 0
+        || i >= (*index)[*index_nmemb - 1].cycle
+        + REPLAY_KEYFRAME_PERIOD) {
+      struct replay_seek_point p = {i, n};
+      *index = add_to_array (&p, 1, *index, index_nmemb,
+                             *index_nmemb, sizeof (p));
+    }
+
+    data[n++] = pgs[i];
+    uint64_t length = j - i;
+    do {
+      data[n] = length & 0x7F;
+      length >>= 7;
+      if (length) data[n] |= 0x80;
+      n++;
+    } while (length);
+  }
+
+  *size = n;
+  return data;
+}
+
+static bool
+write_replay_runs (ALLEGRO_FILE *f, struct replay *replay,
+                   uint8_t *data, size_t size,
+                   struct replay_seek_point *index, size_t index_nmemb)
+{
+  /* cycles */
+  if (al_fwrite32le (f, replay->packed_gamepad_state_nmemb) != 4)
+    return false;
 
+  /* seek index */
+  if (al_fwrite32le (f, index_nmemb) != 4) return false;
+  size_t i;
+  for (i = 0; i < index_nmemb; i++) {
+    if (al_fwrite32le (f, index[i].cycle) != 4) return false;
+    if (al_fwrite32le (f, index[i].offset) != 4) return false;
+  }
+
+  /* run data */
+  if (al_fwrite32le (f, size) != 4) return false;
+  if (size > 0 && al_fwrite (f, data, size) != size) return false;
+
+  /* checksum */
+  if (al_fwrite32le (f, adler32 (1, data, size)) != 4) return false;
+
+  /* state hashes (optional) */
+  uint64_t n = replay->state_hash_nmemb < replay->packed_gamepad_state_nmemb
+    ? replay->state_hash_nmemb : replay->packed_gamepad_state_nmemb;
+  if (n == 0) return true;
+  if (al_fwrite32le (f, n) != 4) return false;
+  for (i = 0; i < n; i++) {
+    if (al_fwrite32le (f, replay->state_hash[i]) != 4) return false;
+    if (al_fwrite32le (f, replay->state_hash[i] >> 32) != 4) return false;
+  }
+
+  return true;
+}
+
+static bool
+write_replay_header (ALLEGRO_FILE *f, struct replay *replay,
+                     uint32_t version)
+{
   /* signature */
   if (al_fwrite (f, REPLAY_FILE_SIGNATURE, sizeof (REPLAY_FILE_SIGNATURE))
       != sizeof (REPLAY_FILE_SIGNATURE)) return false;
 
   /* replay file format version */
-  if (al_fwrite32le (f, REPLAY_FILE_FORMAT_VERSION) != 4) return false;
+  if (al_fwrite32le (f, version) != 4) return false;
 
   /* packed boolean config */
   if (al_fwrite32le (f, replay->packed_boolean_config) != 4) return false;
@@ -187,18 +477,6 @@ save_replay (char *filename, struct replay *replay)
   /* random seed */
   if (al_fwrite32le (f, replay->random_seed) != 4) return false;
 
-  /* remove trailing null gamepad states */
-  uint64_t *i = &replay->packed_gamepad_state_nmemb;
-  while (*i > 0 && replay->packed_gamepad_state[*i - 1] == 0)
-    (*i)--;
-
-  /* packed gamepad state */
-  if (*i > 0
-      && al_fwrite (f, replay->packed_gamepad_state, *i) != *i)
-    return false;
-
-  al_fclose (f);
-
   return true;
 }
 
@@ -214,6 +492,72 @@ save_replay_chain (void)
   }
 }
 
+/* While recording, the gamepad states are appended every
+   REPLAY_JOURNAL_PERIOD cycles to a journal file in the user data
+   directory.  That file is itself a valid replay, so in case MININIM
+   doesn't exit cleanly the session can still be played and saved. */
+void
+start_replay_journal (struct replay *replay)
+{
+  stop_replay_journal (false);
+
+  al_make_directory (user_data_dir);
+  char *filename = get_replay_journal_filename ();
+  replay_journal = al_fopen (filename, "wb");
+  if (! replay_journal)
+    error (0, al_get_errno (), "can't open replay journal '%s'", filename);
+  al_free (filename);
+  if (! replay_journal) return;
+
+  replay_journal_nmemb = 0;
+  if (! write_replay_header (replay_journal, replay,
+                             REPLAY_RAW_FILE_FORMAT_VERSION))
+    stop_replay_journal (true);
+}
+
+void
+flush_replay_journal (bool force)
+{
+  if (! replay_journal) return;
+
+  struct replay *replay = &recorded_replay;
+  if (replay->packed_gamepad_state_nmemb <= replay_journal_nmemb) return;
+
+  uint64_t n = replay->packed_gamepad_state_nmemb - replay_journal_nmemb;
+  if (! force && n < REPLAY_JOURNAL_PERIOD) return;
+
+  if (al_fwrite (replay_journal, replay->packed_gamepad_state
+                 + replay_journal_nmemb, n) != n
+      || ! al_fflush (replay_journal)) {
+    error (0, al_get_errno (), "can't write replay journal");
+    stop_replay_journal (false);
+    return;
+  }
+
+  replay_journal_nmemb += n;
+}
+
+void
+stop_replay_journal (bool remove)
+{
+  if (! replay_journal) return;
+
+  flush_replay_journal (true);
+  al_fclose (replay_journal);
+  replay_journal = NULL;
+
+  if (remove) {
+    char *filename = get_replay_journal_filename ();
+    al_remove_filename (filename);
+    al_free (filename);
+  }
+}
+
+static char *
+get_replay_journal_filename (void)
+{
+  return xasprintf ("%s%s", user_data_dir, REPLAY_JOURNAL_FILENAME);
+}
 
 struct replay *
 load_replay (struct replay *replay_ret, char *filename)
@@ -275,25 +619,261 @@ load_replay (struct replay *replay_ret, char *filename)
   replay.random_seed = al_fread32le (f);
   if (al_feof (f) || al_ferror (f)) return NULL;
 
-  /* packed gamepad state */
-  replay.packed_gamepad_state_nmemb = al_fsize (f)
-    - (sizeof (REPLAY_FILE_SIGNATURE) + 11 * sizeof (uint32_t));
-  if (replay.packed_gamepad_state_nmemb > 0) {
-    replay.packed_gamepad_state =
-      xmalloc (replay.packed_gamepad_state_nmemb);
-    al_fread (f, replay.packed_gamepad_state,
-              replay.packed_gamepad_state_nmemb);
-    if (al_feof (f) || al_ferror (f)) return NULL;
-  }
+  if (replay.version > REPLAY_FILE_FORMAT_VERSION) return NULL;
 
   /* filename */
   replay.filename = xasprintf ("%s", filename);
 
+  if (replay.version >= 2) {
+    /* run-length encoded gamepad state */
+    if (! load_replay_stream (f, &replay)) {
+      al_free (replay.filename);
+      al_fclose (f);
+      return NULL;
+    }
+  } else {
+    /* packed gamepad state */
+    replay.packed_gamepad_state_nmemb = al_fsize (f)
+      - (sizeof (REPLAY_FILE_SIGNATURE) + 11 * sizeof (uint32_t));
+    replay.packed_gamepad_state_capacity = replay.packed_gamepad_state_nmemb;
+    if (replay.packed_gamepad_state_nmemb > 0) {
+      replay.packed_gamepad_state =
+        xmalloc (replay.packed_gamepad_state_nmemb);
+      al_fread (f, replay.packed_gamepad_state,
+                replay.packed_gamepad_state_nmemb);
+      if (al_feof (f) || al_ferror (f)) return NULL;
+    }
+  }
+
+  al_fclose (f);
+
   *replay_ret = replay;
 
   return replay_ret;
 }
 
+static bool
+load_replay_stream (ALLEGRO_FILE *f, struct replay *replay)
+{
+  struct replay_stream s;
+  memset (&s, 0, sizeof (s));
+
+  /* cycles */
+  uint64_t nmemb = al_fread32le (f);
+  if (al_feof (f) || al_ferror (f)) return false;
+
+  /* seek index */
+  s.index_nmemb = al_fread32le (f);
+  if (al_feof (f) || al_ferror (f)) return false;
+  int64_t remaining = al_fsize (f) - al_ftell (f);
+  if (s.index_nmemb > nmemb || remaining < 0
+      || s.index_nmemb > (uint64_t) remaining / (2 * sizeof (uint32_t)))
+    return false;
+  if (s.index_nmemb > 0)
+    s.index = xcalloc (s.index_nmemb, sizeof (* s.index));
+  size_t i;
+  for (i = 0; i < s.index_nmemb; i++) {
+    s.index[i].cycle = al_fread32le (f);
+    s.index[i].offset = al_fread32le (f);
+    if (al_feof (f) || al_ferror (f)) goto error;
+  }
+
+  /* run data */
+  s.data_size = al_fread32le (f);
+  if (al_feof (f) || al_ferror (f)) goto error;
+  s.data_offset = al_ftell (f);
+
+  /* the index must start at the first run and point inside the data */
+  if (nmemb > 0 && (s.index_nmemb == 0 || s.index[0].cycle != 0
+                    || s.index[0].offset != 0)) goto error;
+  for (i = 0; i < s.index_nmemb; i++)
+    if (s.index[i].cycle >= nmemb || s.index[i].offset >= s.data_size
+        || (i > 0 && (s.index[i].cycle <= s.index[i - 1].cycle
+                      || s.index[i].offset <= s.index[i - 1].offset)))
+      goto error;
+
+  /* checksum, decoding the runs on the way so that a malformed stream
+     is rejected here instead of in the middle of playback: the runs
+     must add up to exactly NMEMB cycles and every seek point must
+     fall on a run boundary at its cycle */
+  uint8_t buffer[BUFSIZ];
+  uint32_t adler = 1;
+  uint64_t cycle = 0, length = 0;
+  uint32_t offset = 0;
+  int shift = -1;
+  size_t n, k = 0;
+  for (i = 0; i < s.data_size; i += n) {
+    n = s.data_size - i < sizeof (buffer)
+      ? s.data_size - i : sizeof (buffer);
+    if (al_fread (f, buffer, n) != n) goto error;
+    adler = adler32 (adler, buffer, n);
+
+    size_t j;
+    for (j = 0; j < n; j++, offset++) {
+      if (shift < 0) {
+        /* state byte */
+        if (k < s.index_nmemb && s.index[k].offset < offset) goto error;
+        if (k < s.index_nmemb && s.index[k].offset == offset) {
+          if (s.index[k].cycle != cycle) goto error;
+          k++;
+        }
+        length = 0;
+        shift = 0;
+      } else {
+        /* run length */
+        if (shift > 28) goto error;
+        length |= (uint64_t) (buffer[j] & 0x7F) << shift;
+        shift += 7;
+        if (! (buffer[j] & 0x80)) {
+          cycle += length;
+          if (! length || cycle > nmemb) goto error;
+          shift = -1;
+        }
+      }
+    }
+  }
+  if (shift >= 0 || cycle != nmemb || k != s.index_nmemb) goto error;
+
+  uint32_t checksum = al_fread32le (f);
+  if (al_feof (f) || al_ferror (f) || checksum != adler) goto error;
+
+  /* state hashes (optional) */
+  uint64_t state_hash_nmemb = (uint32_t) al_fread32le (f);
+  if (al_feof (f)) state_hash_nmemb = 0;
+  else if (al_ferror (f) || state_hash_nmemb > nmemb) goto error;
+  uint64_t *state_hash = NULL;
+  remaining = al_fsize (f) - al_ftell (f);
+  if (remaining < 0
+      || state_hash_nmemb > (uint64_t) remaining / sizeof (* state_hash))
+    goto error;
+  if (state_hash_nmemb > 0) {
+    state_hash = xmalloc (state_hash_nmemb * sizeof (* state_hash));
+    for (i = 0; i < state_hash_nmemb; i++) {
+      state_hash[i] = (uint32_t) al_fread32le (f);
+      state_hash[i] |= (uint64_t) (uint32_t) al_fread32le (f) << 32;
+    }
+    if (al_feof (f) || al_ferror (f)) {
+      al_free (state_hash);
+      goto error;
+    }
+  }
+
+  replay->packed_gamepad_state = NULL;
+  replay->packed_gamepad_state_nmemb = nmemb;
+  replay->packed_gamepad_state_capacity = 0;
+  replay->state_hash = state_hash;
+  replay->state_hash_nmemb = state_hash_nmemb;
+  replay->state_hash_capacity = state_hash_nmemb;
+  replay->stream = xmalloc (sizeof (s));
+  *replay->stream = s;
+  return true;
+
+ error:
+  al_free (s.index);
+  return false;
+}
+
+/* The stream file is opened lazily, so every process decoding a
+   replay has its own file position.  Only one replay is played at a
+   time, so opening it closes the stream of any other replay in the
+   chain, which is reopened on demand if needed again; otherwise long
+   chains would run out of file descriptors. */
+static bool
+read_replay_stream (struct replay *replay, uint64_t i, uint8_t *pgs)
+{
+  struct replay_stream *s = replay->stream;
+
+  if (! s->f) {
+    size_t j;
+    for (j = 0; j < replay_chain_nmemb; j++)
+      if (&replay_chain[j] != replay) close_replay_stream (&replay_chain[j]);
+    s->f = al_fopen (replay->filename, "rb");
+    if (! s->f) return false;
+    s->positioned = false;
+  }
+
+  /* binary search for the last seek point not after cycle I */
+  size_t a = 0, b = s->index_nmemb;
+  while (b - a > 1) {
+    size_t m = a + (b - a) / 2;
+    if (s->index[m].cycle <= i) a = m;
+    else b = m;
+  }
+  struct replay_seek_point *p = &s->index[a];
+
+  /* only jump when decoding forward from the current run would take
+     longer */
+  if (! s->positioned || i < s->run_start
+      || p->cycle > s->run_start + s->run_length) {
+    if (! al_fseek (s->f, s->data_offset + p->offset, ALLEGRO_SEEK_SET)) {
+      close_replay_stream (replay);
+      return false;
+    }
+    s->offset = p->offset;
+    s->run_start = p->cycle;
+    s->run_length = 0;
+    s->positioned = true;
+  }
+
+  while (i >= s->run_start + s->run_length) {
+    s->run_start += s->run_length;
+    if (! read_replay_run (s)) {
+      close_replay_stream (replay);
+      return false;
+    }
+  }
+
+  *pgs = s->state;
+  return true;
+}
+
+static bool
+read_replay_run (struct replay_stream *s)
+{
+  if (s->offset >= s->data_size) return false;
+  int c = al_fgetc (s->f);
+  if (c == EOF) return false;
+  s->state = c;
+  s->offset++;
+
+  uint64_t length = 0;
+  int shift = 0;
+  do {
+    if (s->offset >= s->data_size || shift > 35) return false;
+    c = al_fgetc (s->f);
+    if (c == EOF) return false;
+    s->offset++;
+    length |= (uint64_t) (c & 0x7F) << shift;
+    shift += 7;
+  } while (c & 0x80);
+
+  if (! length) return false;
+  s->run_length = length;
+  return true;
+}
+
+static void
+close_replay_stream (struct replay *replay)
+{
+  struct replay_stream *s = replay->stream;
+  if (! s || ! s->f) return;
+  al_fclose (s->f);
+  s->f = NULL;
+  s->positioned = false;
+}
+
+static uint32_t
+adler32 (uint32_t adler, uint8_t *data, size_t size)
+{
+  uint32_t a = adler & 0xFFFF, b = adler >> 16;
+  size_t i;
+  for (i = 0; i < size; i++) {
+    a = (a + data[i]) % 65521;
+    b = (b + a) % 65521;
+  }
+  return (b << 16) | a;
+}
+
 struct replay *
 xload_replay (char *filename)
 {
@@ -303,7 +883,13 @@ xload_replay (char *filename)
 void
 free_replay (struct replay *replay)
 {
+  if (replay->stream) {
+    close_replay_stream (replay);
+    al_free (replay->stream->index);
+    al_free (replay->stream);
+  }
   al_free (replay->packed_gamepad_state);
+  al_free (replay->state_hash);
   al_free (replay->filename);
   memset (replay, 0, sizeof (* replay));
 }
@@ -325,17 +911,21 @@ struct replay *
 add_replay_file_to_replay_chain (char *filename)
 {
   struct replay replay;
-  if (load_replay (&replay, filename)) {
-    replay_chain =
-      add_to_array (&replay, 1, replay_chain, &replay_chain_nmemb,
-                    replay_chain_nmemb, sizeof (replay));
+  if (! load_archived_replay (&replay, filename)) return NULL;
+
+  /* keep the chain sorted, in insertion order among equals */
+  size_t a = 0, b = replay_chain_nmemb;
+  while (a < b) {
+    size_t m = a + (b - a) / 2;
+    if (compare_replays (&replay, &replay_chain[m]) < 0) b = m;
+    else a = m + 1;
+  }
 
-    qsort (replay_chain, replay_chain_nmemb, sizeof (replay),
-           compare_replays);
+  replay_chain =
+    add_to_array (&replay, 1, replay_chain, &replay_chain_nmemb,
+                  a, sizeof (replay));
 
-    return replay_chain;
-  }
-  else return NULL;
+  return replay_chain;
 }
 
 int
@@ -414,13 +1004,18 @@ handle_save_replay_thread (int priority)
     : NULL;
   struct replay *replay = &recorded_replay;
   if (filename) {
-    char *error_str = save_replay (filename, replay)
+    bool saved = save_replay (filename, replay);
+    char *error_str = saved
       ? "REPLAY SAVED"
       : "REPLAY SAVING FAILED";
     ui_msg (priority, "%s", error_str);
     al_free (save_replay_dialog.initial_path);
     save_replay_dialog.initial_path = xasprintf ("%s", filename);
-  } else ui_msg (priority, "RECORDING STOPPED");
+    stop_replay_journal (saved);
+  } else {
+    ui_msg (priority, "RECORDING STOPPED");
+    stop_replay_journal (true);
+  }
   al_destroy_native_file_dialog (dialog);
   free_replay (replay);
   pause_animation (false);
@@ -497,8 +1092,9 @@ stop_replaying (int priority)
   replay_mode = NO_REPLAY;
   level_start_replay_mode = NO_REPLAY;
   anim_freq = DEFAULT_HZ;
-  al_set_timer_speed (timer, 1.0 / anim_freq);
+  if (timer) al_set_timer_speed (timer, 1.0 / anim_freq);
   replay_favorite_cycle = 0;
+  free_replay_keyframes ();
 }
 
 void
@@ -510,18 +1106,21 @@ set_replay_mode_at_level_start (struct replay *replay)
     complete_replay_chain = true;
   }
 
+  free_replay_keyframes ();
+
   switch (replay_mode) {
   case RECORD_REPLAY:
     replay->packed_boolean_config = pack_boolean_replay_config ();
     replay->movements = movements;
     replay->semantics = semantics;
-    replay->start_level = global_level.n;
+    replay->start_level = engine->level.n;
     replay->start_time = start_level_time;
     replay->time_limit = time_limit;
     replay->total_lives = total_lives;
     replay->kca = skill.counter_attack_prob + 1;
     replay->kcd = skill.counter_defense_prob + 1;
-    replay->random_seed = random_seed;
+    replay->random_seed = engine->random_seed;
+    start_replay_journal (replay);
     break;
   case PLAY_REPLAY:
     unpack_boolean_replay_config (replay->packed_boolean_config);
@@ -532,7 +1131,8 @@ set_replay_mode_at_level_start (struct replay *replay)
     total_lives = replay->total_lives;
     skill.counter_attack_prob = replay->kca - 1;
     skill.counter_defense_prob = replay->kcd - 1;
-    random_seed = replay->random_seed;
+    engine->random_seed = replay->random_seed;
+    replay->diverged = false;
     break;
   case NO_REPLAY: default: break;
   }
@@ -732,6 +1332,14 @@ print_replay_results (struct replay *replay)
           replay->final_total_lives,
           replay->final_kca,
           replay->final_kcd);
+  if (replay->state_hash_nmemb > 0) {
+    if (replay->diverged)
+      printf ("Diverged: CYCLE %ju\n", replay->diverged_cycle);
+    else printf ("Diverged: NO\n");
+  }
+  if (replay->playback_cycles > 0)
+    printf ("Playback: %ju cycles in %.6f seconds\n",
+            replay->playback_cycles, replay->playback_seconds);
   fflush (stdout);
 }
 
@@ -742,6 +1350,8 @@ print_replay_chain_info (void)
   for (i = 0; i < replay_chain_nmemb; i++) {
     HLINE;
     print_replay_info (&replay_chain[i]);
+    if (replay_chain[i].validated)
+      print_replay_results (&replay_chain[i]);
   }
   HLINE;
 }
@@ -757,7 +1367,7 @@ update_replay_progress (int *progress_ret)
 
   int total = replay->packed_gamepad_state_nmemb;
 
-  int progress = total ? round ((anim_cycle * 100.0) / total) : 100;
+  int progress = total ? round ((engine->anim_cycle * 100.0) / total) : 100;
 
   progress = progress > 100 ? 100 : progress;
 
@@ -785,6 +1395,339 @@ print_replay_chain_aborted (void)
   }
 }
 
+/* Keyframes are snapshots of the engine state taken periodically while
+   playing a replay.  Seeking to a given cycle restores the nearest
+   keyframe at or before it and fast-forwards only the remainder.  Their
+   total size is kept under REPLAY_KEYFRAME_MEMORY_MAX by thinning out
+   the older ones. */
+void
+record_replay_keyframe (void)
+{
+  if (title_demo || replay_mode != PLAY_REPLAY
+      || engine->anim_cycle % REPLAY_KEYFRAME_PERIOD) return;
+
+  /* find insertion point, keeping keyframes sorted by cycle */
+  size_t i = replay_keyframe_nmemb;
+  while (i > 0 && replay_keyframe[i - 1].cycle >= engine->anim_cycle) {
+    if (replay_keyframe[i - 1].cycle == engine->anim_cycle) return;
+    i--;
+  }
+
+  struct replay_keyframe kf;
+  memset (&kf, 0, sizeof (kf));
+  kf.cycle = engine->anim_cycle;
+  snapshot_engine (engine, &kf.s);
+
+  replay_keyframe =
+    add_to_array (&kf, 1, replay_keyframe, &replay_keyframe_nmemb,
+                  i, sizeof (kf));
+  replay_keyframe_size += kf.s.capacity;
+
+  thin_replay_keyframes ();
+}
+
+/* Drop every other keyframe in the older half of the list, as many
+   times as needed to fit the memory limit.  Recent keyframes are thus
+   kept one period apart while older ones get exponentially farther
+   apart.  The first keyframe is always kept, so any cycle can still be
+   reached. */
+static void
+thin_replay_keyframes (void)
+{
+  while (replay_keyframe_size > REPLAY_KEYFRAME_MEMORY_MAX
+         && replay_keyframe_nmemb > 2) {
+    size_t half = (replay_keyframe_nmemb + 1) / 2;
+    size_t i, j;
+    for (i = j = 0; i < replay_keyframe_nmemb; i++)
+      if (i < half && i % 2) {
+        replay_keyframe_size -= replay_keyframe[i].s.capacity;
+        free_engine_snapshot (&replay_keyframe[i].s);
+      } else replay_keyframe[j++] = replay_keyframe[i];
+    replay_keyframe_nmemb = j;
+  }
+}
+
+void
+free_replay_keyframes (void)
+{
+  size_t i;
+  for (i = 0; i < replay_keyframe_nmemb; i++)
+    free_engine_snapshot (&replay_keyframe[i].s);
+  destroy_array ((void **) &replay_keyframe, &replay_keyframe_nmemb);
+  replay_keyframe_size = 0;
+}
+
+bool
+seek_replay (uint64_t cycle)
+{
+  if (title_demo || replay_mode != PLAY_REPLAY) return false;
+
+  struct replay_keyframe *kf = NULL;
+  size_t i;
+  for (i = 0; i < replay_keyframe_nmemb
+         && replay_keyframe[i].cycle <= cycle; i++)
+    kf = &replay_keyframe[i];
+
+  if (! kf || ! restore_engine (engine, &kf->s)) return false;
+
+  stop_audio_instances ();
+  mr.full_update = true;
+
+  /* the remainder is fast-forwarded as for replay favorites */
+  pause_game (false);
+  if (cycle > 0) {
+    replay_favorite_cycle = cycle;
+    change_anim_freq (0);
+  }
+
+  return true;
+}
+
+int
+end_replay_chain (void)
+{
+  HLINE;
+  printf ("REPLAY CHAIN END\n");
+  HLINE;
+
+  int status = ! replay_skipped && complete_replay_chain
+    && valid_replay_chain ? 0 : 1;
+
+  if (validate_replay_chain == WRITE_VALIDATE_REPLAY_CHAIN) {
+    if (status == 0) {
+      save_replay_chain ();
+      fprintf (stderr, "MININIM: replay chain VALID and COMPLETE!  Replay chain HAS been saved.\n");
+    } else fprintf (stderr, "MININIM: replay chain INVALID or INCOMPLETE!  Replay chain has NOT been saved.\n");
+  }
+
+  save_replay_archive ();
+
+  return status;
+}
+
+
+
+/*********************************************************************
+ * Parallel replay chain validation
+ *********************************************************************/
+
+bool
+is_replay_worker (void)
+{
+  return replay_worker_fd >= 0;
+}
+
+void
+exit_replay_worker (struct replay *replay)
+{
+  struct replay_results rr;
+  memset (&rr, 0, sizeof (rr));
+  rr.complete = replay->complete;
+  rr.reason = replay->reason;
+  rr.final_total_lives = replay->final_total_lives;
+  rr.final_kca = replay->final_kca;
+  rr.final_kcd = replay->final_kcd;
+  rr.diverged = replay->diverged;
+  rr.diverged_cycle = replay->diverged_cycle;
+  rr.playback_cycles = replay->playback_cycles;
+  rr.playback_seconds = replay->playback_seconds;
+
+  int status = write (replay_worker_fd, &rr, sizeof (rr)) == sizeof (rr)
+    ? 0 : 1;
+  close (replay_worker_fd);
+  _exit (status);
+}
+
+/* Replays in a chain are recorded with their own initial conditions,
+   so they can be simulated independently of each other.  The command
+   line replay chain is thus split among forked headless workers, each
+   one playing a chain made of a single replay and sending its results
+   back through a pipe.  The parent process then checks every
+   consecutive pair in order and prints the usual report.  In case
+   '--validate-replay-chain' modifies a replay's parameters, that
+   replay is simulated once more with the new ones, since its results
+   might depend on them.
+
+   It must be called before the display and the audio system are
+   initialized, since those (and the threads Allegro runs for them)
+   can't be safely carried across 'fork'.  The parent process doesn't
+   need either, for it only collects and reports results.  Workers
+   get the same initialization a sequential run would from then on.
+
+   This function returns only in worker processes, which must go on
+   and play the level prepared for them. */
+void
+play_replay_chain_in_parallel (void)
+{
+#if PARALLEL_REPLAY_FEATURE
+  if (! headless || ! command_line_replay
+      || replay_chain_nmemb < 2) return;
+
+  int jobs = replay_jobs > 0 ? replay_jobs
+    : sysconf (_SC_NPROCESSORS_ONLN);
+  if (jobs < 2) return;
+
+  size_t i;
+  size_t *index = xmalloc (replay_chain_nmemb * sizeof (*index));
+  for (i = 0; i < replay_chain_nmemb; i++) index[i] = i;
+
+  if (! simulate_replays (index, replay_chain_nmemb, jobs)) {
+    al_free (index);
+    return;
+  }
+
+  replay_skipped = false;
+  valid_replay_chain = true;
+  complete_replay_chain = true;
+
+  for (i = 0; i < replay_chain_nmemb; i++) {
+    struct replay *replay = &replay_chain[i];
+
+    HLINE;
+
+    if (i == 0) {
+      printf ("REPLAY CHAIN BEGINNING\n");
+      HLINE;
+    } else {
+      struct replay r = *replay;
+      if (! check_valid_replay_chain_pair (replay - 1, replay))
+        valid_replay_chain = false;
+      if ((r.start_time != replay->start_time
+           || r.time_limit != replay->time_limit
+           || r.total_lives != replay->total_lives
+           || r.kca != replay->kca
+           || r.kcd != replay->kcd)
+          && ! simulate_replays (&i, 1, 1)) {
+        al_free (index);
+        return;
+      }
+    }
+
+    print_replay_info (replay);
+    if (! replay->complete) complete_replay_chain = false;
+    print_replay_results (replay);
+    archive_replay_results (replay);
+  }
+
+  al_free (index);
+  exit (end_replay_chain ());
+#endif
+}
+
+#if PARALLEL_REPLAY_FEATURE
+
+/* Simulate the replays whose chain indexes are given in INDEX,
+   running up to JOBS workers at once.  Return false in worker
+   processes and true in the parent process, once all results have
+   been collected.  Abort the program on failure. */
+static bool
+simulate_replays (size_t *index, size_t nmemb, int jobs)
+{
+  struct replay_worker *worker = xmalloc (jobs * sizeof (*worker));
+  size_t next = 0;
+  int running = 0;
+
+  while (next < nmemb || running > 0) {
+    while (next < nmemb && running < jobs) {
+      struct replay_worker *w = &worker[running];
+      w->i = index[next++];
+      w->pid = spawn_replay_worker (w->i, &w->fd);
+      if (w->pid == 0) {
+        al_free (worker);
+        return false;
+      }
+      running++;
+    }
+
+    int status;
+    pid_t pid = waitpid (-1, &status, 0);
+    if (pid < 0) error (-1, errno, "can't wait for replay worker");
+
+    int j;
+    for (j = 0; j < running && worker[j].pid != pid; j++);
+    if (j == running) continue;
+
+    if (! collect_replay_worker (&worker[j], status)) {
+      HLINE;
+      printf ("REPLAY CHAIN ABORTED\n");
+      HLINE;
+      fprintf (stderr, "MININIM: replay worker for '%s' failed\n",
+               replay_chain[worker[j].i].filename);
+      for (j = 0; j < running; j++)
+        if (worker[j].pid != pid) kill (worker[j].pid, SIGTERM);
+      exit (-1);
+    }
+
+    worker[j] = worker[--running];
+  }
+
+  al_free (worker);
+  return true;
+}
+
+static pid_t
+spawn_replay_worker (size_t i, int *fd)
+{
+  int p[2];
+  if (pipe (p)) error (-1, errno, "can't create replay worker pipe");
+
+  fflush (stdout);
+  fflush (stderr);
+
+  pid_t pid = fork ();
+  if (pid < 0) error (-1, errno, "can't fork replay worker");
+
+  if (pid == 0) {
+    close (p[0]);
+    replay_worker_fd = p[1];
+
+    /* The parent process prints the whole report in order */
+    if (! freopen ("/dev/null", "w", stdout))
+      error (-1, errno, "can't redirect replay worker output");
+
+    struct replay replay = replay_chain[i];
+    close_replay_stream (&replay);
+    replay_chain[i].packed_gamepad_state = NULL;
+    replay_chain[i].state_hash = NULL;
+    replay_chain[i].stream = NULL;
+    replay_chain[i].filename = NULL;
+    free_replay_chain ();
+    replay_chain = add_to_array (&replay, 1, NULL, &replay_chain_nmemb,
+                                 0, sizeof (replay));
+    prepare_for_playing_replay (0);
+    return 0;
+  }
+
+  close (p[1]);
+  *fd = p[0];
+  return pid;
+}
+
+static bool
+collect_replay_worker (struct replay_worker *w, int status)
+{
+  struct replay_results rr;
+  bool success = read (w->fd, &rr, sizeof (rr)) == sizeof (rr);
+  close (w->fd);
+
+  if (! WIFEXITED (status) || WEXITSTATUS (status) != 0) return false;
+
+  if (! success) return false;
+
+  struct replay *replay = &replay_chain[w->i];
+  replay->complete = rr.complete;
+  replay->reason = rr.reason;
+  replay->final_total_lives = rr.final_total_lives;
+  replay->final_kca = rr.final_kca;
+  replay->final_kcd = rr.final_kcd;
+  replay->diverged = rr.diverged;
+  replay->diverged_cycle = rr.diverged_cycle;
+  replay->playback_cycles = rr.playback_cycles;
+  replay->playback_seconds = rr.playback_seconds;
+  return true;
+}
+#endif
+
 
 
 
@@ -805,7 +1748,7 @@ void
 add_current_replay_favorite (void)
 {
   assert (replay_mode == PLAY_REPLAY);
-  add_replay_favorite (replay_chain[replay_index].filename, anim_cycle);
+  add_replay_favorite (replay_chain[replay_index].filename, engine->anim_cycle);
 }
 
 void
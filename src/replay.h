@@ -21,6 +21,26 @@
 #ifndef MININIM_REPLAY_H
 #define MININIM_REPLAY_H
 
+struct replay_seek_point {
+  uint32_t cycle;
+  uint32_t offset;
+};
+
+struct replay_stream {
+  ALLEGRO_FILE *f;
+  int64_t data_offset;
+  uint32_t data_size;
+  struct replay_seek_point *index;
+  size_t index_nmemb;
+
+  /* decoder position */
+  bool positioned;
+  uint32_t offset;
+  uint64_t run_start;
+  uint64_t run_length;
+  uint8_t state;
+};
+
 struct replay {
   uint32_t version;
   uint32_t packed_boolean_config;
@@ -40,7 +60,14 @@ struct replay {
   /* Fields below aren't properly part of the replay file format.
      Used mainly for replay results. */
   uint64_t packed_gamepad_state_nmemb;
+  uint64_t packed_gamepad_state_capacity;
+  uint64_t *state_hash;
+  uint64_t state_hash_nmemb;
+  uint64_t state_hash_capacity;
+  struct replay_stream *stream;
   char *filename;
+  bool deferred;
+  bool validated;
   bool complete;
   enum replay_incomplete {
     REPLAY_INCOMPLETE_NO_REASON,
@@ -50,6 +77,10 @@ struct replay {
   uint32_t final_total_lives;
   uint32_t final_kca;
   uint32_t final_kcd;
+  bool diverged;
+  uint64_t diverged_cycle;
+  uint64_t playback_cycles;
+  double playback_seconds;
 };
 
 struct replay_favorite {
@@ -70,8 +101,15 @@ struct replay *store_replay_gamepad_state (struct replay *replay,
 struct gamepad_state *get_replay_gamepad_state (struct gamepad_state *gs,
                                                 struct replay *replay,
                                                 size_t i);
+void store_replay_state_hash (struct replay *replay, uint64_t h,
+                              uint64_t cycle);
+void check_replay_state_hash (struct replay *replay, uint64_t h,
+                              uint64_t cycle);
 bool save_replay (char *filename, struct replay *replay);
 void save_replay_chain (void);
+void start_replay_journal (struct replay *replay);
+void flush_replay_journal (bool force);
+void stop_replay_journal (bool remove);
 struct replay *load_replay (struct replay *replay_ret, char *filename);
 struct replay *xload_replay (char *filename);
 void free_replay (struct replay *replay);
@@ -98,6 +136,13 @@ void print_replay_results (struct replay *replay);
 bool update_replay_progress (int *progress_ret);
 bool is_dedicatedly_replaying (void);
 void print_replay_chain_aborted (void);
+void record_replay_keyframe (void);
+void free_replay_keyframes (void);
+bool seek_replay (uint64_t cycle);
+int end_replay_chain (void);
+bool is_replay_worker (void);
+void exit_replay_worker (struct replay *replay);
+void play_replay_chain_in_parallel (void);
 
 /* replay favorites */
 void add_replay_favorite (const char *filename, uint64_t cycle);
@@ -124,6 +169,8 @@ extern bool replay_skipped;
 extern int just_skipped_replay;
 extern int replay_next_number;
 extern enum validate_replay_chain validate_replay_chain;
+extern int replay_jobs;
+extern int replay_worker_fd;
 
 extern ALLEGRO_THREAD *save_replay_dialog_thread,
   *load_replay_dialog_thread;
@@ -21,6 +21,7 @@
 #include "mininim.h"
 
 bool no_recursive_links_continuity;
+bool precompute_hues;
 
 void
 load_room (void)
@@ -74,7 +75,7 @@ unload_room (void)
 struct rect *
 new_rect (struct rect *r, int room, int x, int y, int w, int h)
 {
-  new_coord (&r->c, &global_level, room, x, y);
+  new_coord (&r->c, &engine->level, room, x, y);
   r->w = w;
   r->h = h;
   return r;
@@ -99,6 +100,7 @@ void
 clear_rect_to_color (ALLEGRO_BITMAP *to, struct rect *r,
                      ALLEGRO_COLOR color)
 {
+  flush_draw_batch ();
   int op, src, dst;
   al_get_blender (&op, &src, &dst);
   al_set_blender (ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_ZERO);
@@ -224,8 +226,8 @@ redraw_drawn_rectangle (struct drawn_rectangle *dr, struct pos *p,
   push_clipping_rectangle (dr->bitmap, dr->x, dr->y, dr->w, dr->h);
 
   struct coord tl, br;
-  new_coord (&tl, &global_level, room_view, dr->x, dr->y);
-  new_coord (&br, &global_level, room_view, dr->x + dr->w - 1,
+  new_coord (&tl, &engine->level, room_view, dr->x, dr->y);
+  new_coord (&br, &engine->level, room_view, dr->x + dr->w - 1,
              dr->y + dr->h - 1);
 
   struct pos ptl, pbr;
@@ -246,7 +248,7 @@ void
 draw_room (ALLEGRO_BITMAP *bitmap, int room,
            enum em em, enum vm vm)
 {
-  struct pos p; new_pos (&p, &global_level, room, -1, -1);
+  struct pos p; new_pos (&p, &engine->level, room, -1, -1);
 
   for (p.floor = FLOORS; p.floor >= -1; p.floor--)
     for (p.place = -1; p.place < PLACES; p.place++) {
@@ -933,6 +935,63 @@ apply_hue_palette (ALLEGRO_BITMAP *bitmap)
   }
 }
 
+/* Draw every room of the current level under each hue into a scratch
+   bitmap, so the palette cache ends up holding all hue variants of
+   the level's environment sprites and switching hue later is just a
+   cache hit.  Both the C hue and the hue mode seen by Lua are
+   switched, so that sprites drawn by scripts are covered as well.
+   The variants of this level are pinned in the palette cache, so they
+   are neither evicted nor counted towards its limit, and those of the
+   previous level are unpinned, to be evicted first as usual. */
+void
+precompute_hue_palettes (enum em em, enum vm vm)
+{
+  if (! precompute_hues || rendering == NONE_RENDERING
+      || rendering == AUDIO_RENDERING || ! palette_cache_size_limit)
+    return;
+
+  unpin_palette_cache ();
+  set_palette_cache_pinning (true);
+
+  enum hue hue_bkp = hue;
+  char *hue_mode_bkp = hue_mode;
+  hue_mode = NULL;
+  int room_view_bkp = room_view;
+  int dx_bkp = mr.dx, dy_bkp = mr.dy;
+  uint32_t random_seed_bkp = engine->random_seed;
+  struct pos mouse_pos_bkp = mouse_pos;
+  invalid_pos (&mouse_pos);
+
+  ALLEGRO_BITMAP *b = create_bitmap (ORIGINAL_WIDTH, ORIGINAL_HEIGHT);
+
+  con_caching = true;
+  for (hue = HUE_GREEN; hue <= HUE_BLUE; hue++) {
+    set_string_var (&hue_mode, hue_mode_string (hue));
+    int room;
+    for (room = 1; room < ROOMS; room++) {
+      room_view = room;
+      mr.dx = mr.dy = 0;
+      clear_bitmap (b, TRANSPARENT_COLOR);
+      draw_room (b, room, em, vm);
+    }
+    process_display_events ();
+  }
+  con_caching = false;
+
+  destroy_bitmap (b);
+
+  hue = hue_bkp;
+  al_free (hue_mode);
+  hue_mode = hue_mode_bkp;
+  room_view = room_view_bkp;
+  mr.dx = dx_bkp;
+  mr.dy = dy_bkp;
+  engine->random_seed = random_seed_bkp;
+  mouse_pos = mouse_pos_bkp;
+
+  set_palette_cache_pinning (false);
+}
+
 ALLEGRO_COLOR
 apply_hue_color (ALLEGRO_COLOR c)
 {
@@ -23,6 +23,7 @@
 
 /* variables */
 extern bool no_recursive_links_continuity;
+extern bool precompute_hues;
 
 /* functions */
 void load_room (void);
@@ -71,6 +72,7 @@ void draw_room_frame_fg (ALLEGRO_BITMAP *bitmap, enum em em,
 /*                    enum em em, enum vm vm, struct frame *f); */
 
 ALLEGRO_BITMAP *apply_hue_palette (ALLEGRO_BITMAP *bitmap);
+void precompute_hue_palettes (enum em em, enum vm vm);
 ALLEGRO_COLOR apply_hue_color (ALLEGRO_COLOR c);
 ALLEGRO_COLOR selection_palette (ALLEGRO_COLOR c);
 void draw_no_floor_selection (ALLEGRO_BITMAP *bitmap, struct pos *p);
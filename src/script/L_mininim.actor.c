@@ -34,6 +34,20 @@ static DECLARE_LUA (__index);
 static DECLARE_LUA (__newindex);
 static DECLARE_LUA (__tostring);
 
+enum actor_key {
+  ACTOR_ID, ACTOR_DIRECTION, ACTOR_TYPE, ACTOR_ACTION,
+  ACTOR_DELAYED_STAND_UP
+};
+
+static const char *const actor_keys[] = {
+  [ACTOR_ID] = "id",
+  [ACTOR_DIRECTION] = "direction",
+  [ACTOR_TYPE] = "type",
+  [ACTOR_ACTION] = "action",
+  [ACTOR_DELAYED_STAND_UP] = "delayed_stand_up",
+  NULL,
+};
+
 void
 define_L_mininim_actor (lua_State *L)
 {
@@ -43,13 +57,7 @@ define_L_mininim_actor (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, actor_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -180,27 +188,22 @@ BEGIN_LUA (__index)
     return 1;
   }
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "id")) {
-      lua_pushnumber (L, id);
-      return 1;
-    } else if (! strcasecmp (key, "direction")) {
-      lua_pushstring (L, direction_string (a->f.dir));
-      return 1;
-    } else if (! strcasecmp (key, "type")) {
-      lua_pushstring (L, type_string (a->type));
-      return 1;
-    } else if (! strcasecmp (key, "action")) {
-      lua_pushstring (L, action_string (a->action));
-      return 1;
-    } else if (! strcasecmp (key, "delayed_stand_up")) {
-      lua_pushboolean (L, a->uncouch_slowly);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case ACTOR_ID:
+    lua_pushnumber (L, id);
+    return 1;
+  case ACTOR_DIRECTION:
+    lua_pushstring (L, direction_string (a->f.dir));
+    return 1;
+  case ACTOR_TYPE:
+    lua_pushstring (L, type_string (a->type));
+    return 1;
+  case ACTOR_ACTION:
+    lua_pushstring (L, action_string (a->action));
+    return 1;
+  case ACTOR_DELAYED_STAND_UP:
+    lua_pushboolean (L, a->uncouch_slowly);
+    return 1;
   default: break;
   }
 
@@ -220,34 +223,32 @@ BEGIN_LUA (__newindex)
   struct anim *a = get_anim_by_id (id);
   if (! a) return 0;
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "direction")) {
-      if (! lua_isstring (L, 3)) return 0;
-      enum dir dir = direction_value (lua_tostring (L, 3));
-      if (invalid (dir)) return 0;
-      else if (dir != a->f.dir) invert_frame_dir (&a->f, &a->f);
-      return 0;
-    } else if (! strcasecmp (key, "type")) {
-      if (! lua_isstring (L, 3)) return 0;
-      enum anim_type type = type_value (lua_tostring (L, 3));
-      if (invalid (type)) return 0;
-      if (!id) return 0;
-      a->type = type;
-      return 0;
-    } else if (! strcasecmp (key, "action")) {
-      if (! lua_isstring (L, 3)) return 0;
-      ACTION action = action_value (lua_tostring (L, 3), a->type);
-      if (! action) return 0;
-      a->next_action = action;
-      return 0;
-    } else if (! strcasecmp (key, "delayed_stand_up")) {
-      a->uncouch_slowly = lua_toboolean (L, 3);
-      return 0;
-    } else break;
+  switch (L_key (L, 2)) {
+  case ACTOR_DIRECTION: {
+    if (! lua_isstring (L, 3)) return 0;
+    enum dir dir = direction_value (lua_tostring (L, 3));
+    if (invalid (dir)) return 0;
+    else if (dir != a->f.dir) invert_frame_dir (&a->f, &a->f);
+    return 0;
+  }
+  case ACTOR_TYPE: {
+    if (! lua_isstring (L, 3)) return 0;
+    enum anim_type type = type_value (lua_tostring (L, 3));
+    if (invalid (type)) return 0;
+    if (!id) return 0;
+    a->type = type;
+    return 0;
+  }
+  case ACTOR_ACTION: {
+    if (! lua_isstring (L, 3)) return 0;
+    ACTION action = action_value (lua_tostring (L, 3), a->type);
+    if (! action) return 0;
+    a->next_action = action;
+    return 0;
+  }
+  case ACTOR_DELAYED_STAND_UP:
+    a->uncouch_slowly = lua_toboolean (L, 3);
+    return 0;
   default: break;
   }
 
@@ -27,6 +27,16 @@ static DECLARE_LUA (__index);
 static DECLARE_LUA (__newindex);
 static DECLARE_LUA (__tostring);
 
+enum audio_key {
+  AUDIO_SOURCE, AUDIO_CURRENT
+};
+
+static const char *const audio_keys[] = {
+  [AUDIO_SOURCE] = "source",
+  [AUDIO_CURRENT] = "current",
+  NULL,
+};
+
 void
 define_L_mininim_audio (lua_State *L)
 {
@@ -36,13 +46,7 @@ define_L_mininim_audio (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, audio_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -98,27 +102,22 @@ END_LUA
 
 BEGIN_LUA (__index)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "source")) {
-      lua_pushcfunction (L, L_mininim_audio_source);
-      return 1;
-    } else if (! strcasecmp (key, "current")) {
-      assert (audio_mode);
-      L_get_registry_by_ref (L, audio_mode_ref);
-      lua_pushstring (L, audio_mode);
-      lua_rawget (L, -2);
-      return 1;
-    } else {
-      L_get_registry_by_ref (L, audio_mode_ref);
-      lua_replace (L, 1);
-      lua_rawget (L, 1);
-      return 1;
-    }
-  default: break;
+  switch (L_key (L, 2)) {
+  case AUDIO_SOURCE:
+    lua_pushcfunction (L, L_mininim_audio_source);
+    return 1;
+  case AUDIO_CURRENT:
+    assert (audio_mode);
+    L_get_registry_by_ref (L, audio_mode_ref);
+    lua_pushstring (L, audio_mode);
+    lua_rawget (L, -2);
+    return 1;
+  default:
+    if (lua_type (L, 2) != LUA_TSTRING) break;
+    L_get_registry_by_ref (L, audio_mode_ref);
+    lua_replace (L, 1);
+    lua_rawget (L, 1);
+    return 1;
   }
 
   lua_pushnil (L);
@@ -128,21 +127,16 @@ END_LUA
 
 BEGIN_LUA (__newindex)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "current")) {
-      L_set_string_var (L, 3, &audio_mode);
-      return 0;
-    } else {
-      L_get_registry_by_ref (L, audio_mode_ref);
-      lua_replace (L, 1);
-      lua_settable (L, 1);
-      return 0;
-    }
-  default: break;
+  switch (L_key (L, 2)) {
+  case AUDIO_CURRENT:
+    L_set_string_var (L, 3, &audio_mode);
+    return 0;
+  default:
+    if (lua_type (L, 2) != LUA_TSTRING) break;
+    L_get_registry_by_ref (L, audio_mode_ref);
+    lua_replace (L, 1);
+    lua_settable (L, 1);
+    return 0;
   }
 
   return 0;
@@ -27,6 +27,15 @@ static DECLARE_LUA (__tostring);
 
 static DECLARE_LUA (play);
 
+enum source_key {
+  SOURCE_PLAY
+};
+
+static const char *const source_keys[] = {
+  [SOURCE_PLAY] = "play",
+  NULL,
+};
+
 void
 define_L_mininim_audio_source (lua_State *L)
 {
@@ -40,9 +49,7 @@ define_L_mininim_audio_source (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, NULL, source_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -104,16 +111,10 @@ BEGIN_LUA (__index)
     return 1;
   }
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "play")) {
-      lua_pushvalue (L, 1);
-      lua_pushcclosure (L, play, 1);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case SOURCE_PLAY:
+    L_pushmethod (L, 1, SOURCE_PLAY, play);
+    return 1;
   default: break;
   }
 
@@ -155,7 +156,7 @@ BEGIN_LUA (play)
   struct pos *p = NULL;
   id = luaL_checkudata (L, 1, L_MININIM_ACTOR);
   p = luaL_checkudata (L, 1, L_MININIM_LEVEL_POSITION);
-  play_audio (as, p, (id && *id < anima_nmemb) ? *id : -1);
+  play_audio (as, p, (id && *id < engine->anima_nmemb) ? *id : -1);
   return 0;
 }
 END_LUA
@@ -29,6 +29,34 @@ static DECLARE_LUA (__tostring);
 
 static DECLARE_LUA (quit);
 
+enum mininim_key {
+  MININIM_CYCLE, MININIM_PLACE_WIDTH, MININIM_PLACE_HEIGHT,
+  MININIM_LOAD_HOOK, MININIM_LEVEL, MININIM_ACTOR, MININIM_AUDIO,
+  MININIM_VIDEO, MININIM_SETTING, MININIM_MOUSE, MININIM_MULTIROOM,
+  MININIM_PROFILER, MININIM_DEBUGGER, MININIM_MATH, MININIM_QUIT,
+  MININIM_CLIPBOARD
+};
+
+static const char *const mininim_keys[] = {
+  [MININIM_CYCLE] = "cycle",
+  [MININIM_PLACE_WIDTH] = "place_width",
+  [MININIM_PLACE_HEIGHT] = "place_height",
+  [MININIM_LOAD_HOOK] = "load_hook",
+  [MININIM_LEVEL] = "level",
+  [MININIM_ACTOR] = "actor",
+  [MININIM_AUDIO] = "audio",
+  [MININIM_VIDEO] = "video",
+  [MININIM_SETTING] = "setting",
+  [MININIM_MOUSE] = "mouse",
+  [MININIM_MULTIROOM] = "multiroom",
+  [MININIM_PROFILER] = "profiler",
+  [MININIM_DEBUGGER] = "debugger",
+  [MININIM_MATH] = "math",
+  [MININIM_QUIT] = "quit",
+  [MININIM_CLIPBOARD] = "clipboard",
+  NULL,
+};
+
 void
 define_L_mininim (lua_State *L)
 {
@@ -38,13 +66,7 @@ define_L_mininim (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, mininim_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -102,66 +124,61 @@ END_LUA
 
 BEGIN_LUA (__index)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "cycle")) {
-      lua_pushnumber (L, anim_cycle);
-      return 1;
-    } else if (! strcasecmp (key, "place_width")) {
-      lua_pushnumber (L, PLACE_WIDTH);
-      return 1;
-    } else if (! strcasecmp (key, "place_height")) {
-      lua_pushnumber (L, PLACE_HEIGHT);
-      return 1;
-    } else if (! strcasecmp (key, "load_hook")) {
-      L_get_registry_by_ref (L, load_hook_ref);
-      return 1;
-    } else if (! strcasecmp (key, "level")) {
-      L_push_interface (L, L_MININIM_LEVEL);
-      return 1;
-    } else if (! strcasecmp (key, "actor")) {
-      lua_pushcfunction (L, L_mininim_actor);
-      return 1;
-    } else if (! strcasecmp (key, "audio")) {
-      L_push_interface (L, L_MININIM_AUDIO);
-      return 1;
-    } else if (! strcasecmp (key, "video")) {
-      L_push_interface (L, L_MININIM_VIDEO);
-      return 1;
-    } else if (! strcasecmp (key, "setting")) {
-      L_push_interface (L, L_MININIM_SETTING);
-      return 1;
-    } else if (! strcasecmp (key, "mouse")) {
-      L_push_interface (L, L_MININIM_MOUSE);
-      return 1;
-    } else if (! strcasecmp (key, "multiroom")) {
-      L_push_interface (L, L_MININIM_MULTIROOM);
-      return 1;
-    } else if (! strcasecmp (key, "profiler")) {
-      L_push_interface (L, L_MININIM_PROFILER);
-      return 1;
-    } else if (! strcasecmp (key, "debugger")) {
-      L_push_interface (L, L_MININIM_DEBUGGER);
-      return 1;
-    } else if (! strcasecmp (key, "math")) {
-      L_push_interface (L, L_MININIM_MATH);
-      return 1;
-    } else if (! strcasecmp (key, "quit")) {
-      lua_pushcfunction (L, quit);
-      return 1;
-    } else if (! strcasecmp (key, "clipboard")) {
-      if (al_clipboard_has_text (display)) {
-        char *text = al_get_clipboard_text (display);
-        al_free (text);
-        text = al_get_clipboard_text (display);
-        lua_pushstring (L, text);
-        al_free (text);
-      } else lua_pushnil (L);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case MININIM_CYCLE:
+    lua_pushnumber (L, engine->anim_cycle);
+    return 1;
+  case MININIM_PLACE_WIDTH:
+    lua_pushnumber (L, PLACE_WIDTH);
+    return 1;
+  case MININIM_PLACE_HEIGHT:
+    lua_pushnumber (L, PLACE_HEIGHT);
+    return 1;
+  case MININIM_LOAD_HOOK:
+    L_get_registry_by_ref (L, load_hook_ref);
+    return 1;
+  case MININIM_LEVEL:
+    L_push_interface (L, L_MININIM_LEVEL);
+    return 1;
+  case MININIM_ACTOR:
+    lua_pushcfunction (L, L_mininim_actor);
+    return 1;
+  case MININIM_AUDIO:
+    L_push_interface (L, L_MININIM_AUDIO);
+    return 1;
+  case MININIM_VIDEO:
+    L_push_interface (L, L_MININIM_VIDEO);
+    return 1;
+  case MININIM_SETTING:
+    L_push_interface (L, L_MININIM_SETTING);
+    return 1;
+  case MININIM_MOUSE:
+    L_push_interface (L, L_MININIM_MOUSE);
+    return 1;
+  case MININIM_MULTIROOM:
+    L_push_interface (L, L_MININIM_MULTIROOM);
+    return 1;
+  case MININIM_PROFILER:
+    L_push_interface (L, L_MININIM_PROFILER);
+    return 1;
+  case MININIM_DEBUGGER:
+    L_push_interface (L, L_MININIM_DEBUGGER);
+    return 1;
+  case MININIM_MATH:
+    L_push_interface (L, L_MININIM_MATH);
+    return 1;
+  case MININIM_QUIT:
+    lua_pushcfunction (L, quit);
+    return 1;
+  case MININIM_CLIPBOARD:
+    if (al_clipboard_has_text (display)) {
+      char *text = al_get_clipboard_text (display);
+      al_free (text);
+      text = al_get_clipboard_text (display);
+      lua_pushstring (L, text);
+      al_free (text);
+    } else lua_pushnil (L);
+    return 1;
   default: break;
   }
 
@@ -172,21 +189,16 @@ END_LUA
 
 BEGIN_LUA (__newindex)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "load_hook")) {
-      L_set_registry_by_ref (L, &load_hook_ref);
-      return 0;
-    } else if (! strcasecmp (key, "clipboard")) {
-      if (lua_isstring (L, 3)) {
-        const char *text = lua_tostring (L, 3);
-        al_set_clipboard_text (display, text);
-      }
-      return 0;
-    } else break;
+  switch (L_key (L, 2)) {
+  case MININIM_LOAD_HOOK:
+    L_set_registry_by_ref (L, &load_hook_ref);
+    return 0;
+  case MININIM_CLIPBOARD:
+    if (lua_isstring (L, 3)) {
+      const char *text = lua_tostring (L, 3);
+      al_set_clipboard_text (display, text);
+    }
+    return 0;
   default: break;
   }
 
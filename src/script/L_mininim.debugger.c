@@ -94,6 +94,34 @@ static DECLARE_LUA (setupvalue);
 static DECLARE_LUA (bt);
 static DECLARE_LUA (cbt);
 
+enum debugger_key {
+  DEBUGGER_DEBUG, DEBUGGER_BR, DEBUGGER_LBR, DEBUGGER_DBR,
+  DEBUGGER_CONT, DEBUGGER_NEXT, DEBUGGER_STEP, DEBUGGER_FINISH,
+  DEBUGGER_GETLOCAL, DEBUGGER_GETUPVALUE, DEBUGGER_SETLOCAL,
+  DEBUGGER_SETUPVALUE, DEBUGGER_BT, DEBUGGER_CBT, DEBUGGER_BT_ON_ERROR,
+  DEBUGGER_SRC
+};
+
+static const char *const debugger_keys[] = {
+  [DEBUGGER_DEBUG] = "debug",
+  [DEBUGGER_BR] = "br",
+  [DEBUGGER_LBR] = "lbr",
+  [DEBUGGER_DBR] = "dbr",
+  [DEBUGGER_CONT] = "cont",
+  [DEBUGGER_NEXT] = "next",
+  [DEBUGGER_STEP] = "step",
+  [DEBUGGER_FINISH] = "finish",
+  [DEBUGGER_GETLOCAL] = "getlocal",
+  [DEBUGGER_GETUPVALUE] = "getupvalue",
+  [DEBUGGER_SETLOCAL] = "setlocal",
+  [DEBUGGER_SETUPVALUE] = "setupvalue",
+  [DEBUGGER_BT] = "bt",
+  [DEBUGGER_CBT] = "cbt",
+  [DEBUGGER_BT_ON_ERROR] = "bt_on_error",
+  [DEBUGGER_SRC] = "src",
+  NULL,
+};
+
 void
 define_L_mininim_debugger (lua_State *L)
 {
@@ -103,13 +131,7 @@ define_L_mininim_debugger (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, debugger_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -146,65 +168,61 @@ END_LUA
 
 BEGIN_LUA (__index)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "debug")) {
-      lua_pushcfunction (L, debug_here);
-      return 1;
-    } else if (! strcasecmp (key, "br")) {
-      lua_pushcfunction (L, br);
-      return 1;
-    } else if (! strcasecmp (key, "lbr")) {
-      lua_pushcfunction (L, lbr);
-      return 1;
-    } else if (! strcasecmp (key, "dbr")) {
-      lua_pushcfunction (L, dbr);
-      return 1;
-    } else if (! strcasecmp (key, "cont")) {
-      lua_pushcfunction (L, cont);
-      return 1;
-    } else if (! strcasecmp (key, "next")) {
-      lua_pushcfunction (L, next);
-      return 1;
-    } else if (! strcasecmp (key, "step")) {
-      lua_pushcfunction (L, step);
-      return 1;
-    } else if (! strcasecmp (key, "finish")) {
-      lua_pushcfunction (L, finish);
-      return 1;
-    } else if (! strcasecmp (key, "getlocal")) {
-      lua_pushcfunction (L, getlocal);
-      return 1;
-    } else if (! strcasecmp (key, "getupvalue")) {
-      lua_pushcfunction (L, getupvalue);
-      return 1;
-    } else if (! strcasecmp (key, "setlocal")) {
-      lua_pushcfunction (L, setlocal);
-      return 1;
-    } else if (! strcasecmp (key, "setupvalue")) {
-      lua_pushcfunction (L, setupvalue);
-      return 1;
-    } else if (! strcasecmp (key, "bt")) {
-      lua_pushcfunction (L, bt);
-      return 1;
-    } else if (! strcasecmp (key, "cbt")) {
-      lua_pushcfunction (L, cbt);
-      return 1;
-    } else if (! strcasecmp (key, "bt_on_error")) {
-      lua_pushstring (L, bt_on_error);
-      return 1;
-    } else if (! strcasecmp (key, "src")) {
-      lua_Debug ar;
-      if (lua_getstack (L, 1, &ar)) {
-        lua_getinfo (L, "S", &ar);
-        if (ar.source[0] == '@') lua_pushstring (L, ar.source + 1);
-        else lua_pushnil (L);
-      } else lua_pushnil (L);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case DEBUGGER_DEBUG:
+    lua_pushcfunction (L, debug_here);
+    return 1;
+  case DEBUGGER_BR:
+    lua_pushcfunction (L, br);
+    return 1;
+  case DEBUGGER_LBR:
+    lua_pushcfunction (L, lbr);
+    return 1;
+  case DEBUGGER_DBR:
+    lua_pushcfunction (L, dbr);
+    return 1;
+  case DEBUGGER_CONT:
+    lua_pushcfunction (L, cont);
+    return 1;
+  case DEBUGGER_NEXT:
+    lua_pushcfunction (L, next);
+    return 1;
+  case DEBUGGER_STEP:
+    lua_pushcfunction (L, step);
+    return 1;
+  case DEBUGGER_FINISH:
+    lua_pushcfunction (L, finish);
+    return 1;
+  case DEBUGGER_GETLOCAL:
+    lua_pushcfunction (L, getlocal);
+    return 1;
+  case DEBUGGER_GETUPVALUE:
+    lua_pushcfunction (L, getupvalue);
+    return 1;
+  case DEBUGGER_SETLOCAL:
+    lua_pushcfunction (L, setlocal);
+    return 1;
+  case DEBUGGER_SETUPVALUE:
+    lua_pushcfunction (L, setupvalue);
+    return 1;
+  case DEBUGGER_BT:
+    lua_pushcfunction (L, bt);
+    return 1;
+  case DEBUGGER_CBT:
+    lua_pushcfunction (L, cbt);
+    return 1;
+  case DEBUGGER_BT_ON_ERROR:
+    lua_pushstring (L, bt_on_error);
+    return 1;
+  case DEBUGGER_SRC: {
+    lua_Debug ar;
+    if (lua_getstack (L, 1, &ar)) {
+      lua_getinfo (L, "S", &ar);
+      if (ar.source[0] == '@') lua_pushstring (L, ar.source + 1);
+      else lua_pushnil (L);
+    } else lua_pushnil (L);
+    return 1;
+  }
   default: break;
   }
 
@@ -215,18 +233,14 @@ END_LUA
 
 BEGIN_LUA (__newindex)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "bt_on_error")) {
-      const char *value = lua_tostring (L, 3);
-      if (! value) return 0;
-      if (! strcasecmp (value, "FULL") || ! strcasecmp (value, "COMPACT"))
-        set_string_var (&bt_on_error, value);
-      return 0;
-    } else break;
+  switch (L_key (L, 2)) {
+  case DEBUGGER_BT_ON_ERROR: {
+    const char *value = lua_tostring (L, 3);
+    if (! value) return 0;
+    if (! strcasecmp (value, "FULL") || ! strcasecmp (value, "COMPACT"))
+      set_string_var (&bt_on_error, value);
+    return 0;
+  }
   default: break;
   }
   return 0;
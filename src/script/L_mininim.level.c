@@ -28,6 +28,22 @@ static DECLARE_LUA (__index);
 static DECLARE_LUA (__newindex);
 static DECLARE_LUA (__tostring);
 
+enum level_key {
+  LEVEL_NUMBER, LEVEL_ENV_MODE, LEVEL_HUE_MODE, LEVEL_START_HOOK,
+  LEVEL_CYCLE_HOOK, LEVEL_POSITION, LEVEL_RETRY
+};
+
+static const char *const level_keys[] = {
+  [LEVEL_NUMBER] = "number",
+  [LEVEL_ENV_MODE] = "env_mode",
+  [LEVEL_HUE_MODE] = "hue_mode",
+  [LEVEL_START_HOOK] = "start_hook",
+  [LEVEL_CYCLE_HOOK] = "cycle_hook",
+  [LEVEL_POSITION] = "position",
+  [LEVEL_RETRY] = "retry",
+  NULL,
+};
+
 void
 define_L_mininim_level (lua_State *L)
 {
@@ -37,13 +53,7 @@ define_L_mininim_level (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, level_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -101,34 +111,29 @@ END_LUA
 
 BEGIN_LUA (__index)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "number")) {
-      lua_pushnumber (L, global_level.n);
-      return 1;
-    } else if (! strcasecmp (key, "env_mode")) {
-      lua_pushstring (L, env_mode_string (global_level.em));
-      return 1;
-    } else if (! strcasecmp (key, "hue_mode")) {
-      lua_pushstring (L, hue_mode_string (global_level.hue));
-      return 1;
-    } else if (! strcasecmp (key, "start_hook")) {
-      L_get_registry_by_ref (L, level_start_hook_ref);
-      return 1;
-    } else if (! strcasecmp (key, "cycle_hook")) {
-      L_get_registry_by_ref (L, level_cycle_hook_ref);
-      return 1;
-    } else if (! strcasecmp (key, "position")) {
-      lua_pushcfunction (L, L_mininim_level_position);
-      return 1;
-    } else if (! strcasecmp (key, "retry")) {
-      lua_pushboolean (L, retry_level == global_level.n
-                       && replay_mode == NO_REPLAY);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case LEVEL_NUMBER:
+    lua_pushnumber (L, engine->level.n);
+    return 1;
+  case LEVEL_ENV_MODE:
+    lua_pushstring (L, env_mode_string (engine->level.em));
+    return 1;
+  case LEVEL_HUE_MODE:
+    lua_pushstring (L, hue_mode_string (engine->level.hue));
+    return 1;
+  case LEVEL_START_HOOK:
+    L_get_registry_by_ref (L, level_start_hook_ref);
+    return 1;
+  case LEVEL_CYCLE_HOOK:
+    L_get_registry_by_ref (L, level_cycle_hook_ref);
+    return 1;
+  case LEVEL_POSITION:
+    lua_pushcfunction (L, L_mininim_level_position);
+    return 1;
+  case LEVEL_RETRY:
+    lua_pushboolean (L, retry_level == engine->level.n
+                     && replay_mode == NO_REPLAY);
+    return 1;
   default: break;
   }
 
@@ -139,18 +144,13 @@ END_LUA
 
 BEGIN_LUA (__newindex)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "start_hook")) {
-      L_set_registry_by_ref (L, &level_start_hook_ref);
-      return 0;
-    } else if (! strcasecmp (key, "cycle_hook")) {
-      L_set_registry_by_ref (L, &level_cycle_hook_ref);
-      return 0;
-    } else break;
+  switch (L_key (L, 2)) {
+  case LEVEL_START_HOOK:
+    L_set_registry_by_ref (L, &level_start_hook_ref);
+    return 0;
+  case LEVEL_CYCLE_HOOK:
+    L_set_registry_by_ref (L, &level_cycle_hook_ref);
+    return 0;
   default: break;
   }
 
@@ -160,7 +160,7 @@ END_LUA
 
 BEGIN_LUA (__tostring)
 {
-  lua_pushfstring (L, "MININIM LEVEL %d INTERFACE", global_level.n);
+  lua_pushfstring (L, "MININIM LEVEL %d INTERFACE", engine->level.n);
   return 1;
 }
 END_LUA
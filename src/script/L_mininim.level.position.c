@@ -25,10 +25,23 @@ static DECLARE_LUA (__index);
 static DECLARE_LUA (__newindex);
 static DECLARE_LUA (__tostring);
 
-char *wall_correlation_string (enum wall_correlation wc);
-
 static DECLARE_LUA (activate);
 
+enum position_key {
+  POSITION_ROOM, POSITION_FLOOR, POSITION_PLACE, POSITION_NORMAL,
+  POSITION_WALL_CORRELATION, POSITION_ACTIVATE
+};
+
+static const char *const position_keys[] = {
+  [POSITION_ROOM] = "room",
+  [POSITION_FLOOR] = "floor",
+  [POSITION_PLACE] = "place",
+  [POSITION_NORMAL] = "normal",
+  [POSITION_WALL_CORRELATION] = "wall_correlation",
+  [POSITION_ACTIVATE] = "activate",
+  NULL,
+};
+
 void
 define_L_mininim_level_position (lua_State *L)
 {
@@ -38,13 +51,7 @@ define_L_mininim_level_position (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, position_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -68,7 +75,7 @@ BEGIN_LUA (L_mininim_level_position)
   int floor = luaL_checknumber (L, 2);
   int place = luaL_checknumber (L, 3);
   struct pos p;
-  new_pos (&p, &global_level, room, floor, place);
+  new_pos (&p, &engine->level, room, floor, place);
   L_pushposition (L, &p);
   return 1;
 }
@@ -105,34 +112,30 @@ BEGIN_LUA (__index)
     return 1;
   }
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "room")) {
-      lua_pushnumber (L, p->room);
-      return 1;
-    } else if (! strcasecmp (key, "floor")) {
-      lua_pushnumber (L, p->floor);
-      return 1;
-    } else if (! strcasecmp (key, "place")) {
-      lua_pushnumber (L, p->place);
-      return 1;
-    } else if (! strcasecmp (key, "normal")) {
-      struct pos np; npos (p, &np);
-      L_pushposition (L, &np);
-      return 1;
-    } else if (! strcasecmp (key, "wall_correlation")) {
-      enum wall_correlation wc = wall_correlation (p);
-      char * wc_str = wall_correlation_string (wc);
-      lua_pushstring (L, wc_str);
-      return 1;
-    } else if (! strcasecmp (key, "activate")) {
-      lua_pushvalue (L, 1);
-      lua_pushcclosure (L, activate, 1);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case POSITION_ROOM:
+    lua_pushnumber (L, p->room);
+    return 1;
+  case POSITION_FLOOR:
+    lua_pushnumber (L, p->floor);
+    return 1;
+  case POSITION_PLACE:
+    lua_pushnumber (L, p->place);
+    return 1;
+  case POSITION_NORMAL: {
+    struct pos np; npos (p, &np);
+    L_pushposition (L, &np);
+    return 1;
+  }
+  case POSITION_WALL_CORRELATION: {
+    enum wall_correlation wc = wall_correlation (p);
+    char * wc_str = wall_correlation_string (wc);
+    lua_pushstring (L, wc_str);
+    return 1;
+  }
+  case POSITION_ACTIVATE:
+    L_pushmethod (L, 1, POSITION_ACTIVATE, activate);
+    return 1;
   default: break;
   }
 
@@ -147,21 +150,16 @@ BEGIN_LUA (__newindex)
 
   if (! p) return 0;
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "room")) {
-      p->room = lua_tonumber (L, 3);
-      return 0;
-    } else if (! strcasecmp (key, "floor")) {
-      p->floor = lua_tonumber (L, 3);
-      return 0;
-    } else if (! strcasecmp (key, "place")) {
-      p->place = lua_tonumber (L, 3);
-      return 0;
-    } else break;
+  switch (L_key (L, 2)) {
+  case POSITION_ROOM:
+    p->room = lua_tonumber (L, 3);
+    return 0;
+  case POSITION_FLOOR:
+    p->floor = lua_tonumber (L, 3);
+    return 0;
+  case POSITION_PLACE:
+    p->place = lua_tonumber (L, 3);
+    return 0;
   default: break;
   }
 
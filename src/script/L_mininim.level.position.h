@@ -25,6 +25,7 @@
 
 void define_L_mininim_level_position (lua_State *L);
 void L_pushposition (lua_State *L, struct pos *p);
+char *wall_correlation_string (enum wall_correlation wc);
 
 DECLARE_LUA (L_mininim_level_position);
 
@@ -40,6 +40,26 @@ static DECLARE_LUA (bor);
 static DECLARE_LUA (bxor);
 static DECLARE_LUA (bnot);
 
+enum math_key {
+  MATH_DIV, MATH_MOD, MATH_RSHIFT, MATH_LSHIFT, MATH_UINT32,
+  MATH_UINT16, MATH_UINT8, MATH_BAND, MATH_BOR, MATH_BXOR, MATH_BNOT
+};
+
+static const char *const math_keys[] = {
+  [MATH_DIV] = "div",
+  [MATH_MOD] = "mod",
+  [MATH_RSHIFT] = "rshift",
+  [MATH_LSHIFT] = "lshift",
+  [MATH_UINT32] = "uint32",
+  [MATH_UINT16] = "uint16",
+  [MATH_UINT8] = "uint8",
+  [MATH_BAND] = "band",
+  [MATH_BOR] = "bor",
+  [MATH_BXOR] = "bxor",
+  [MATH_BNOT] = "bnot",
+  NULL,
+};
+
 void
 define_L_mininim_math (lua_State *L)
 {
@@ -49,9 +69,7 @@ define_L_mininim_math (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, NULL, math_keys);
 
   lua_pushstring (L, "__newindex");
   lua_pushcfunction (L, __newindex);
@@ -73,45 +91,40 @@ END_LUA
 
 BEGIN_LUA (__index)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "div")) {
-      lua_pushcfunction (L, _div);
-      return 1;
-    } else if (! strcasecmp (key, "mod")) {
-      lua_pushcfunction (L, mod);
-      return 1;
-    } else if (! strcasecmp (key, "rshift")) {
-      lua_pushcfunction (L, rshift);
-      return 1;
-    } else if (! strcasecmp (key, "lshift")) {
-      lua_pushcfunction (L, lshift);
-      return 1;
-    } else if (! strcasecmp (key, "uint32")) {
-      lua_pushcfunction (L, uint32);
-      return 1;
-    } else if (! strcasecmp (key, "uint16")) {
-      lua_pushcfunction (L, uint16);
-      return 1;
-    } else if (! strcasecmp (key, "uint8")) {
-      lua_pushcfunction (L, uint8);
-      return 1;
-    } else if (! strcasecmp (key, "band")) {
-      lua_pushcfunction (L, band);
-      return 1;
-    } else if (! strcasecmp (key, "bor")) {
-      lua_pushcfunction (L, bor);
-      return 1;
-    } else if (! strcasecmp (key, "bxor")) {
-      lua_pushcfunction (L, bxor);
-      return 1;
-    } else if (! strcasecmp (key, "bnot")) {
-      lua_pushcfunction (L, bnot);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case MATH_DIV:
+    lua_pushcfunction (L, _div);
+    return 1;
+  case MATH_MOD:
+    lua_pushcfunction (L, mod);
+    return 1;
+  case MATH_RSHIFT:
+    lua_pushcfunction (L, rshift);
+    return 1;
+  case MATH_LSHIFT:
+    lua_pushcfunction (L, lshift);
+    return 1;
+  case MATH_UINT32:
+    lua_pushcfunction (L, uint32);
+    return 1;
+  case MATH_UINT16:
+    lua_pushcfunction (L, uint16);
+    return 1;
+  case MATH_UINT8:
+    lua_pushcfunction (L, uint8);
+    return 1;
+  case MATH_BAND:
+    lua_pushcfunction (L, band);
+    return 1;
+  case MATH_BOR:
+    lua_pushcfunction (L, bor);
+    return 1;
+  case MATH_BXOR:
+    lua_pushcfunction (L, bxor);
+    return 1;
+  case MATH_BNOT:
+    lua_pushcfunction (L, bnot);
+    return 1;
   default: break;
   }
 
@@ -25,6 +25,15 @@ static DECLARE_LUA (__index);
 static DECLARE_LUA (__newindex);
 static DECLARE_LUA (__tostring);
 
+enum mouse_key {
+  MOUSE_POSITION
+};
+
+static const char *const mouse_keys[] = {
+  [MOUSE_POSITION] = "position",
+  NULL,
+};
+
 void
 define_L_mininim_mouse (lua_State *L)
 {
@@ -34,9 +43,7 @@ define_L_mininim_mouse (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, NULL, mouse_keys);
 
   lua_pushstring (L, "__newindex");
   lua_pushcfunction (L, __newindex);
@@ -58,15 +65,10 @@ END_LUA
 
 BEGIN_LUA (__index)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "position")) {
-      L_pushposition (L, &mouse_pos);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case MOUSE_POSITION:
+    L_pushposition (L, &mouse_pos);
+    return 1;
   default: break;
   }
 
@@ -25,6 +25,16 @@ static DECLARE_LUA (__index);
 static DECLARE_LUA (__newindex);
 static DECLARE_LUA (__tostring);
 
+enum multiroom_key {
+  MULTIROOM_WIDTH, MULTIROOM_HEIGHT
+};
+
+static const char *const multiroom_keys[] = {
+  [MULTIROOM_WIDTH] = "width",
+  [MULTIROOM_HEIGHT] = "height",
+  NULL,
+};
+
 void
 define_L_mininim_multiroom (lua_State *L)
 {
@@ -34,13 +44,7 @@ define_L_mininim_multiroom (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, multiroom_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -58,18 +62,13 @@ END_LUA
 
 BEGIN_LUA (__index)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "width")) {
-      lua_pushnumber (L, mr.w);
-      return 1;
-    } else if (! strcasecmp (key, "height")) {
-      lua_pushnumber (L, mr.h);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case MULTIROOM_WIDTH:
+    lua_pushnumber (L, mr.w);
+    return 1;
+  case MULTIROOM_HEIGHT:
+    lua_pushnumber (L, mr.h);
+    return 1;
   default: break;
   }
 
@@ -80,20 +79,17 @@ END_LUA
 
 BEGIN_LUA (__newindex)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "width")) {
-      int w = lua_tonumber (L, 3);
-      set_multi_room (w, mr.h);
-      return 0;
-    } else if (! strcasecmp (key, "height")) {
-      int h = lua_tonumber (L, 3);
-      set_multi_room (mr.w, h);
-      return 0;
-    } else break;
+  switch (L_key (L, 2)) {
+  case MULTIROOM_WIDTH: {
+    int w = lua_tonumber (L, 3);
+    set_multi_room (w, mr.h);
+    return 0;
+  }
+  case MULTIROOM_HEIGHT: {
+    int h = lua_tonumber (L, 3);
+    set_multi_room (mr.w, h);
+    return 0;
+  }
   default: break;
   }
 
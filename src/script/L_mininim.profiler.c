@@ -44,6 +44,19 @@ static DECLARE_LUA (__tostring);
 
 static DECLARE_LUA (start);
 static DECLARE_LUA (stop);
+static DECLARE_LUA (trace);
+
+enum profiler_key {
+  PROFILER_START, PROFILER_STOP, PROFILER_REPORT, PROFILER_TRACE
+};
+
+static const char *const profiler_keys[] = {
+  [PROFILER_START] = "start",
+  [PROFILER_STOP] = "stop",
+  [PROFILER_REPORT] = "report",
+  [PROFILER_TRACE] = "trace",
+  NULL,
+};
 
 void
 define_L_mininim_profiler (lua_State *L)
@@ -54,13 +67,7 @@ define_L_mininim_profiler (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, profiler_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -78,27 +85,26 @@ END_LUA
 
 BEGIN_LUA (__index)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "start")) {
-      lua_pushcfunction (L, start);
-      return 1;
-    } else if (! strcasecmp (key, "stop")) {
-      lua_pushcfunction (L, stop);
-      return 1;
-    } else if (! strcasecmp (key, "report")) {
-      fmt_begin (3);
-      report (NULL);
-      char *fmt = fmt_end ();
-      char *s = report (fmt);
-      lua_pushstring (L, s);
-      al_free (s);
-      al_free (fmt);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case PROFILER_START:
+    lua_pushcfunction (L, start);
+    return 1;
+  case PROFILER_STOP:
+    lua_pushcfunction (L, stop);
+    return 1;
+  case PROFILER_REPORT: {
+    fmt_begin (3);
+    report (NULL);
+    char *fmt = fmt_end ();
+    char *s = report (fmt);
+    lua_pushstring (L, s);
+    al_free (s);
+    al_free (fmt);
+    return 1;
+  }
+  case PROFILER_TRACE:
+    lua_pushcfunction (L, trace);
+    return 1;
   default: break;
   }
 
@@ -109,15 +115,10 @@ END_LUA
 
 BEGIN_LUA (__newindex)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "report")) {
-      reset ();
-      return 0;
-    } else break;
+  switch (L_key (L, 2)) {
+  case PROFILER_REPORT:
+    reset ();
+    return 0;
   default: break;
   }
 
@@ -135,6 +136,7 @@ END_LUA
 BEGIN_LUA (start)
 {
   L_profiling = true;
+  engine_profiling = true;
   lua_sethook (main_L, profiler_hook, LUA_MASKCALL | LUA_MASKRET
                | (L_debugging ? LUA_MASKLINE : 0), 0);
   return 0;
@@ -144,6 +146,8 @@ END_LUA
 BEGIN_LUA (stop)
 {
   L_profiling = false;
+  /* a session trace requested on the command line keeps going */
+  if (! profiler_trace_filename) engine_profiling = false;
   if (L_debugging)
     lua_sethook (main_L, debugger_hook,
                  LUA_MASKCALL | LUA_MASKRET | LUA_MASKLINE, 0);
@@ -152,6 +156,16 @@ BEGIN_LUA (stop)
 }
 END_LUA
 
+/* Write the engine scopes timed so far to the file given as argument,
+   as a Chrome trace */
+BEGIN_LUA (trace)
+{
+  const char *filename = luaL_checkstring (L, 1);
+  lua_pushboolean (L, write_profiler_trace (filename));
+  return 1;
+}
+END_LUA
+
 void
 reset (void)
 {
@@ -159,12 +173,25 @@ reset (void)
   for (i = 0; i < profiler_stats_nmemb; i++)
     al_free (profiler_stats[i].id);
   destroy_array ((void *) &profiler_stats, &profiler_stats_nmemb);
+  reset_profiler_scopes ();
 }
 
 char *
 report (const char *fmt)
 {
-  if (! profiler_stats_nmemb)
+  enum profiler_scope scope;
+  uint64_t scope_count[PROFILER_SCOPES];
+  double scope_total[PROFILER_SCOPES];
+  size_t scope_nmemb = 0;
+
+  for (scope = 0; scope < PROFILER_SCOPES; scope++) {
+    double max;
+    scope_count[scope] =
+      get_profiler_scope_stats (scope, &scope_total[scope], &max);
+    if (scope_count[scope]) scope_nmemb++;
+  }
+
+  if (! profiler_stats_nmemb && ! scope_nmemb)
     return xasprintf ("No profiling statistics collected");
 
   if (fmt)
@@ -178,6 +205,21 @@ report (const char *fmt)
   al_free (header);
   al_free (hl);
 
+  /* engine scopes come first, as the C side of the breakdown */
+  for (scope = 0; scope < PROFILER_SCOPES; scope++) {
+    if (! scope_count[scope]) continue;
+    char *count = xasprintf ("%ju", scope_count[scope]);
+    char *total_time = xasprintf ("%.4f", scope_total[scope]);
+    char *id = xasprintf ("C:%s", profiler_scope_name (scope));
+    char *old_report = report;
+    report = fmt_row (fmt, old_report, count, total_time, id,
+                      --scope_nmemb || profiler_stats_nmemb ? "\n" : "");
+    al_free (old_report);
+    al_free (count);
+    al_free (total_time);
+    al_free (id);
+  }
+
   size_t i;
   for (i = 0; i < profiler_stats_nmemb; i++) {
     struct profiler_stats *s = &profiler_stats[i];
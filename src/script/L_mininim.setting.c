@@ -25,6 +25,19 @@ static DECLARE_LUA (__index);
 static DECLARE_LUA (__newindex);
 static DECLARE_LUA (__tostring);
 
+enum setting_key {
+  SETTING_AUDIO_MODE, SETTING_VIDEO_MODE, SETTING_ENV_MODE,
+  SETTING_HUE_MODE
+};
+
+static const char *const setting_keys[] = {
+  [SETTING_AUDIO_MODE] = "audio_mode",
+  [SETTING_VIDEO_MODE] = "video_mode",
+  [SETTING_ENV_MODE] = "env_mode",
+  [SETTING_HUE_MODE] = "hue_mode",
+  NULL,
+};
+
 void
 define_L_mininim_setting (lua_State *L)
 {
@@ -34,13 +47,7 @@ define_L_mininim_setting (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, setting_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -58,24 +65,19 @@ END_LUA
 
 BEGIN_LUA (__index)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "audio_mode")) {
-      lua_pushstring (L, audio_mode);
-      return 1;
-    } else if (! strcasecmp (key, "video_mode")) {
-      lua_pushstring (L, video_mode);
-      return 1;
-    } else if (! strcasecmp (key, "env_mode")) {
-      lua_pushstring (L, env_mode);
-      return 1;
-    } else if (! strcasecmp (key, "hue_mode")) {
-      lua_pushstring (L, hue_mode);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case SETTING_AUDIO_MODE:
+    lua_pushstring (L, audio_mode);
+    return 1;
+  case SETTING_VIDEO_MODE:
+    lua_pushstring (L, video_mode);
+    return 1;
+  case SETTING_ENV_MODE:
+    lua_pushstring (L, env_mode);
+    return 1;
+  case SETTING_HUE_MODE:
+    lua_pushstring (L, hue_mode);
+    return 1;
   default: break;
   }
 
@@ -86,24 +88,19 @@ END_LUA
 
 BEGIN_LUA (__newindex)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "audio_mode")) {
-      L_set_string_var (L, 3, &audio_mode);
-      return 0;
-    } else if (! strcasecmp (key, "video_mode")) {
-      L_set_string_var (L, 3, &video_mode);
-      return 0;
-    } else if (! strcasecmp (key, "env_mode")) {
-      L_set_string_var (L, 3, &env_mode);
-      return 0;
-    } else if (! strcasecmp (key, "hue_mode")) {
-      L_set_string_var (L, 3, &hue_mode);
-      return 0;
-    } else break;
+  switch (L_key (L, 2)) {
+  case SETTING_AUDIO_MODE:
+    L_set_string_var (L, 3, &audio_mode);
+    return 0;
+  case SETTING_VIDEO_MODE:
+    L_set_string_var (L, 3, &video_mode);
+    return 0;
+  case SETTING_ENV_MODE:
+    L_set_string_var (L, 3, &env_mode);
+    return 0;
+  case SETTING_HUE_MODE:
+    L_set_string_var (L, 3, &hue_mode);
+    return 0;
   default: break;
   }
 
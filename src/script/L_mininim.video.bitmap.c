@@ -30,6 +30,16 @@ static DECLARE_LUA (__tostring);
 static DECLARE_LUA (L_apply_palette);
 static DECLARE_LUA (draw);
 
+enum bitmap_key {
+  BITMAP_APPLY_PALETTE, BITMAP_DRAW
+};
+
+static const char *const bitmap_keys[] = {
+  [BITMAP_APPLY_PALETTE] = "apply_palette",
+  [BITMAP_DRAW] = "draw",
+  NULL,
+};
+
 void
 define_L_mininim_video_bitmap (lua_State *L)
 {
@@ -43,9 +53,7 @@ define_L_mininim_video_bitmap (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, NULL, bitmap_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -106,20 +114,13 @@ BEGIN_LUA (__index)
 
   if (! b_ptr) return 0;
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "apply_palette")) {
-      lua_pushvalue (L, 1);
-      lua_pushcclosure (L, L_apply_palette, 1);
-      return 1;
-    } else if (! strcasecmp (key, "draw")) {
-      lua_pushvalue (L, 1);
-      lua_pushcclosure (L, draw, 1);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case BITMAP_APPLY_PALETTE:
+    L_pushmethod (L, 1, BITMAP_APPLY_PALETTE, L_apply_palette);
+    return 1;
+  case BITMAP_DRAW:
+    L_pushmethod (L, 1, BITMAP_DRAW, draw);
+    return 1;
   default: break;
   }
 
@@ -26,6 +26,26 @@ static DECLARE_LUA ( __eq);
 static DECLARE_LUA (__index);
 static DECLARE_LUA (__newindex);
 static DECLARE_LUA (__tostring);
+static DECLARE_LUA (register_draw_table);
+
+enum video_key {
+  VIDEO_BITMAP, VIDEO_COLOR, VIDEO_COORDINATE, VIDEO_RECTANGLE,
+  VIDEO_REGISTER_DRAW_TABLE, VIDEO_ENV_MODE, VIDEO_HUE_MODE,
+  VIDEO_PALETTE_CACHE_SIZE_LIMIT, VIDEO_CURRENT
+};
+
+static const char *const video_keys[] = {
+  [VIDEO_BITMAP] = "bitmap",
+  [VIDEO_COLOR] = "color",
+  [VIDEO_COORDINATE] = "coordinate",
+  [VIDEO_RECTANGLE] = "rectangle",
+  [VIDEO_REGISTER_DRAW_TABLE] = "register_draw_table",
+  [VIDEO_ENV_MODE] = "env_mode",
+  [VIDEO_HUE_MODE] = "hue_mode",
+  [VIDEO_PALETTE_CACHE_SIZE_LIMIT] = "palette_cache_size_limit",
+  [VIDEO_CURRENT] = "current",
+  NULL,
+};
 
 void
 define_L_mininim_video (lua_State *L)
@@ -37,13 +57,7 @@ define_L_mininim_video (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, video_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -77,49 +91,43 @@ END_LUA
 
 BEGIN_LUA (__index)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "bitmap")) {
-      lua_pushcfunction (L, L_mininim_video_bitmap);
-      return 1;
-    } else if (! strcasecmp (key, "color")) {
-      lua_pushcfunction (L, L_mininim_video_color);
-      return 1;
-    } else if (! strcasecmp (key, "coordinate")) {
-      lua_pushcfunction (L, L_mininim_video_coordinate);
-      return 1;
-    } else if (! strcasecmp (key, "rectangle")) {
-      lua_pushcfunction (L, L_mininim_video_rectangle);
-      return 1;
-    } else if (! strcasecmp (key, "env_mode")) {
-      if (! strcasecmp (env_mode, "ORIGINAL"))
-        lua_pushstring (L, env_mode_string (global_level.em));
-      else lua_pushstring (L, env_mode);
-      return 1;
-    } else if (! strcasecmp (key, "hue_mode")) {
-      if (! strcasecmp (hue_mode, "ORIGINAL"))
-        lua_pushstring (L, hue_mode_string (global_level.hue));
-      else lua_pushstring (L, hue_mode);
-      return 1;
-    } else if (! strcasecmp (key, "palette_cache_size_limit")) {
-      lua_pushnumber (L, palette_cache_size_limit);
-      return 1;
-    } else if (! strcasecmp (key, "current")) {
-      assert (video_mode);
-      L_get_registry_by_ref (L, video_mode_ref);
-      lua_pushstring (L, video_mode);
-      lua_rawget (L, 1);
-      return 1;
-    } else {
-      L_get_registry_by_ref (L, video_mode_ref);
-      lua_replace (L, 1);
-      lua_rawget (L, 1);
-      return 1;
-    }
-  default: break;
+  switch (L_key (L, 2)) {
+  case VIDEO_BITMAP:
+    lua_pushcfunction (L, L_mininim_video_bitmap);
+    return 1;
+  case VIDEO_COLOR:
+    lua_pushcfunction (L, L_mininim_video_color);
+    return 1;
+  case VIDEO_COORDINATE:
+    lua_pushcfunction (L, L_mininim_video_coordinate);
+    return 1;
+  case VIDEO_RECTANGLE:
+    lua_pushcfunction (L, L_mininim_video_rectangle);
+    return 1;
+  case VIDEO_REGISTER_DRAW_TABLE:
+    lua_pushcfunction (L, register_draw_table);
+    return 1;
+  case VIDEO_ENV_MODE:
+    lua_pushstring (L, L_env_mode ());
+    return 1;
+  case VIDEO_HUE_MODE:
+    lua_pushstring (L, L_hue_mode ());
+    return 1;
+  case VIDEO_PALETTE_CACHE_SIZE_LIMIT:
+    lua_pushnumber (L, palette_cache_size_limit);
+    return 1;
+  case VIDEO_CURRENT:
+    assert (video_mode);
+    L_get_registry_by_ref (L, video_mode_ref);
+    lua_pushstring (L, video_mode);
+    lua_rawget (L, 1);
+    return 1;
+  default:
+    if (lua_type (L, 2) != LUA_TSTRING) break;
+    L_get_registry_by_ref (L, video_mode_ref);
+    lua_replace (L, 1);
+    lua_rawget (L, 1);
+    return 1;
   }
 
   lua_pushnil (L);
@@ -129,21 +137,16 @@ END_LUA
 
 BEGIN_LUA (__newindex)
 {
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "current")) {
-      L_set_string_var (L, 3, &video_mode);
-      return 0;
-    } else {
-      L_get_registry_by_ref (L, video_mode_ref);
-      lua_replace (L, 1);
-      lua_settable (L, 1);
-      return 0;
-    }
-  default: break;
+  switch (L_key (L, 2)) {
+  case VIDEO_CURRENT:
+    L_set_string_var (L, 3, &video_mode);
+    return 0;
+  default:
+    if (lua_type (L, 2) != LUA_TSTRING) break;
+    L_get_registry_by_ref (L, video_mode_ref);
+    lua_replace (L, 1);
+    lua_settable (L, 1);
+    return 0;
   }
 
   return 0;
@@ -178,3 +181,164 @@ L_push_video_routine (lua_State *L)
 
   return true;
 }
+
+const char *
+L_env_mode (void)
+{
+  if (! strcasecmp (env_mode, "ORIGINAL"))
+    return env_mode_string (engine->level.em);
+  else return env_mode;
+}
+
+const char *
+L_hue_mode (void)
+{
+  if (! strcasecmp (hue_mode, "ORIGINAL"))
+    return hue_mode_string (engine->level.hue);
+  else return hue_mode;
+}
+
+static int
+draw_table_ref (lua_State *L, int index, const char *key,
+                int type)
+{
+  int r = LUA_NOREF;
+  lua_getfield (L, index, key);
+  if (lua_type (L, -1) == type) L_set_registry_by_ref (L, &r);
+  else lua_pop (L, 1);
+  return r;
+}
+
+static ALLEGRO_BITMAP *
+draw_table_bitmap (lua_State *L, int index, const char *key)
+{
+  ALLEGRO_BITMAP *b = NULL;
+  lua_getfield (L, index, key);
+  if (! lua_isnil (L, -1))
+    b = *(ALLEGRO_BITMAP **) L_check_type (L, -1, L_MININIM_VIDEO_BITMAP);
+  lua_pop (L, 1);
+  return b;
+}
+
+/* KEY is either a single bitmap or a table of bitmaps by wall
+   correlation */
+static void
+draw_table_wall_correlation (lua_State *L, int index, const char *key,
+                             ALLEGRO_BITMAP **b)
+{
+  enum wall_correlation wc;
+  lua_getfield (L, index, key);
+  if (lua_istable (L, -1))
+    for (wc = SWS; wc <= WWW; wc++)
+      b[wc] = draw_table_bitmap (L, -1, wall_correlation_string (wc));
+  else if (! lua_isnil (L, -1)) {
+    ALLEGRO_BITMAP **bp = L_check_type (L, -1, L_MININIM_VIDEO_BITMAP);
+    for (wc = SWS; wc <= WWW; wc++) b[wc] = *bp;
+  }
+  lua_pop (L, 1);
+}
+
+static void
+draw_table_wall_env (lua_State *L, int index, struct wall_draw_env *d)
+{
+  const char *part[WALL_PARTS] = {"BASE", "LEFT", "RIGHT", "TOP"};
+  int i;
+
+  index = lua_abs_index (L, index);
+  d->defined = true;
+
+  /* parts overridden by a Lua function */
+  for (i = 0; i < WALL_PARTS; i++)
+    d->part_ref[i] = draw_table_ref (L, index, part[i], LUA_TFUNCTION);
+
+  draw_table_wall_correlation (L, index, "base", d->base);
+  draw_table_wall_correlation (L, index, "left", d->left);
+  d->right = draw_table_bitmap (L, index, "right");
+  d->top = draw_table_bitmap (L, index, "top");
+
+  lua_getfield (L, index, "top_offset");
+  d->top_offset = lua_tonumber (L, -1);
+  lua_pop (L, 1);
+
+  d->narrow_divider = draw_table_bitmap (L, index, "narrow_divider");
+  d->wide_divider = draw_table_bitmap (L, index, "wide_divider");
+  d->random_block = draw_table_bitmap (L, index, "random_block");
+  d->mark_top_left = draw_table_bitmap (L, index, "mark_top_left");
+  d->mark_bottom_left = draw_table_bitmap (L, index, "mark_bottom_left");
+  d->mark_top_right = draw_table_bitmap (L, index, "mark_top_right");
+  d->mark_bottom_right = draw_table_bitmap (L, index, "mark_bottom_right");
+
+  /* palace bricks: eight colors and fifteen marks */
+  lua_getfield (L, index, "brick_color");
+  lua_getfield (L, index, "brick_mark");
+  d->brick = lua_istable (L, -2) && lua_istable (L, -1);
+  if (d->brick) {
+    for (i = 0; i < 8; i++) {
+      lua_rawgeti (L, -2, i + 1);
+      d->brick_color[i] =
+        *(ALLEGRO_COLOR *) L_check_type (L, -1, L_MININIM_VIDEO_COLOR);
+      lua_pop (L, 1);
+    }
+    for (i = 0; i < 15; i++) {
+      lua_rawgeti (L, -1, i + 1);
+      d->brick_mark[i] =
+        *(ALLEGRO_BITMAP **) L_check_type (L, -1, L_MININIM_VIDEO_BITMAP);
+      lua_pop (L, 1);
+    }
+  }
+  lua_pop (L, 2);
+}
+
+/* mininim.video.register_draw_table (VIDEO_MODE, OBJECT, TABLE):
+   describe how a video mode draws OBJECT, so the engine can draw it
+   without calling back into the video routine.  Only walls are
+   supported for now. */
+BEGIN_LUA (register_draw_table)
+{
+  const char *vm = luaL_checkstring (L, 1);
+  const char *object = luaL_checkstring (L, 2);
+  luaL_checktype (L, 3, LUA_TTABLE);
+
+  if (strcasecmp (object, "WALL")) return 0;
+
+  struct wall_draw_table t;
+  memset (&t, 0, sizeof (t));
+  enum hue h;
+  enum em e;
+
+  t.video_mode = xasprintf ("%s", vm);
+
+  /* keep the table, and with it every bitmap and palette it refers
+     to, alive */
+  lua_pushvalue (L, 3);
+  t.ref = LUA_NOREF;
+  L_set_registry_by_ref (L, &t.ref);
+
+  t.palette_ref = draw_table_ref (L, 3, "palette", LUA_TFUNCTION);
+
+  lua_getfield (L, 3, "hue");
+  for (h = HUE_NONE; h <= HUE_BLUE; h++)
+    t.hue_ref[h] = lua_istable (L, -1) && h != HUE_NONE
+      ? draw_table_ref (L, -1, hue_mode_string (h), LUA_TFUNCTION)
+      : LUA_NOREF;
+  lua_pop (L, 1);
+
+  t.selection_ref = draw_table_ref (L, 3, "selection", LUA_TFUNCTION);
+  lua_getfield (L, 3, "selection");
+  for (e = DUNGEON; e <= PALACE; e++)
+    t.selection_em_ref[e] = lua_istable (L, -1)
+      ? draw_table_ref (L, -1, env_mode_string (e), LUA_TFUNCTION)
+      : LUA_NOREF;
+  lua_pop (L, 1);
+
+  for (e = DUNGEON; e <= PALACE; e++) {
+    lua_getfield (L, 3, env_mode_string (e));
+    if (lua_istable (L, -1)) draw_table_wall_env (L, -1, &t.env[e]);
+    lua_pop (L, 1);
+  }
+
+  register_wall_draw_table (&t);
+
+  return 0;
+}
+END_LUA
@@ -25,6 +25,20 @@ static DECLARE_LUA (__index);
 static DECLARE_LUA (__newindex);
 static DECLARE_LUA (__tostring);
 
+enum color_key {
+  COLOR_R, COLOR_G, COLOR_B, COLOR_A, COLOR_HTML, COLOR_NAME
+};
+
+static const char *const color_keys[] = {
+  [COLOR_R] = "r",
+  [COLOR_G] = "g",
+  [COLOR_B] = "b",
+  [COLOR_A] = "a",
+  [COLOR_HTML] = "html",
+  [COLOR_NAME] = "name",
+  NULL,
+};
+
 void
 define_L_mininim_video_color (lua_State *L)
 {
@@ -34,13 +48,7 @@ define_L_mininim_video_color (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, color_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -104,46 +112,47 @@ BEGIN_LUA (__index)
     return 1;
   }
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "r")) {
-      unsigned char r, g, b;
-      al_unmap_rgb (c, &r, &g, &b);
-      lua_pushnumber (L, r);
-      return 1;
-    } else if (! strcasecmp (key, "g")) {
-      unsigned char r, g, b;
-      al_unmap_rgb (c, &r, &g, &b);
-      lua_pushnumber (L, g);
-      return 1;
-    } else if (! strcasecmp (key, "b")) {
-      unsigned char r, g, b;
-      al_unmap_rgb (c, &r, &g, &b);
-      lua_pushnumber (L, b);
-      return 1;
-    } else if (! strcasecmp (key, "a")) {
-      unsigned char r, g, b, a;
-      al_unmap_rgba (c, &r, &g, &b, &a);
-      lua_pushnumber (L, a);
-      return 1;
-    } else if (! strcasecmp (key, "html")) {
-      unsigned char r, g, b;
-      al_unmap_rgb (c, &r, &g, &b);
-      char html[8];
-      al_color_rgb_to_html (r / 255.0, g / 255.0, b / 255.0, html);
-      lua_pushstring (L, html);
-      return 1;
-    } else if (! strcasecmp (key, "name")) {
-      unsigned char r, g, b;
-      al_unmap_rgb (c, &r, &g, &b);
-      char const *name =
-        al_color_rgb_to_name (r / 255.0, g / 255.0, b / 255.0);
-      lua_pushstring (L, name);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case COLOR_R: {
+    unsigned char r, g, b;
+    al_unmap_rgb (c, &r, &g, &b);
+    lua_pushnumber (L, r);
+    return 1;
+  }
+  case COLOR_G: {
+    unsigned char r, g, b;
+    al_unmap_rgb (c, &r, &g, &b);
+    lua_pushnumber (L, g);
+    return 1;
+  }
+  case COLOR_B: {
+    unsigned char r, g, b;
+    al_unmap_rgb (c, &r, &g, &b);
+    lua_pushnumber (L, b);
+    return 1;
+  }
+  case COLOR_A: {
+    unsigned char r, g, b, a;
+    al_unmap_rgba (c, &r, &g, &b, &a);
+    lua_pushnumber (L, a);
+    return 1;
+  }
+  case COLOR_HTML: {
+    unsigned char r, g, b;
+    al_unmap_rgb (c, &r, &g, &b);
+    char html[8];
+    al_color_rgb_to_html (r / 255.0, g / 255.0, b / 255.0, html);
+    lua_pushstring (L, html);
+    return 1;
+  }
+  case COLOR_NAME: {
+    unsigned char r, g, b;
+    al_unmap_rgb (c, &r, &g, &b);
+    char const *name =
+      al_color_rgb_to_name (r / 255.0, g / 255.0, b / 255.0);
+    lua_pushstring (L, name);
+    return 1;
+  }
   default: break;
   }
 
@@ -157,48 +166,49 @@ BEGIN_LUA (__newindex)
   ALLEGRO_COLOR *c = luaL_checkudata (L, 1, L_MININIM_VIDEO_COLOR);
   if (! c) return 0;
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "r")) {
-      if (! lua_isnumber (L, 3)) return 0;
-      unsigned char r, g, b;
-      al_unmap_rgb (*c, &r, &g, &b);
-      r = lua_tonumber (L, 3);
-      *c = al_map_rgb (r, g, b);
-      return 0;
-    } else if (! strcasecmp (key, "g")) {
-      if (! lua_isnumber (L, 3)) return 0;
-      unsigned char r, g, b;
-      al_unmap_rgb (*c, &r, &g, &b);
-      g = lua_tonumber (L, 3);
-      *c = al_map_rgb (r, g, b);
-      return 0;
-    } else if (! strcasecmp (key, "b")) {
-      if (! lua_isnumber (L, 3)) return 0;
-      unsigned char r, g, b;
-      al_unmap_rgb (*c, &r, &g, &b);
-      b = lua_tonumber (L, 3);
-      *c = al_map_rgb (r, g, b);
-      return 0;
-    } else if (! strcasecmp (key, "a")) {
-      if (! lua_isnumber (L, 3)) return 0;
-      unsigned char r, g, b, a;
-      al_unmap_rgba (*c, &r, &g, &b, &a);
-      a = lua_tonumber (L, 3);
-      *c = al_map_rgba (r, g, b, a);
-      return 0;
-    } else if (! strcasecmp (key, "html")) {
-      if (lua_isstring (L, 3))
-        *c = al_color_html (lua_tostring (L, 3));
-      else return 0;
-    } else if (! strcasecmp (key, "name")) {
-      if (lua_isstring (L, 3))
-        *c = al_color_name (lua_tostring (L, 3));
-      else return 0;
-    } else break;
+  switch (L_key (L, 2)) {
+  case COLOR_R: {
+    if (! lua_isnumber (L, 3)) return 0;
+    unsigned char r, g, b;
+    al_unmap_rgb (*c, &r, &g, &b);
+    r = lua_tonumber (L, 3);
+    *c = al_map_rgb (r, g, b);
+    return 0;
+  }
+  case COLOR_G: {
+    if (! lua_isnumber (L, 3)) return 0;
+    unsigned char r, g, b;
+    al_unmap_rgb (*c, &r, &g, &b);
+    g = lua_tonumber (L, 3);
+    *c = al_map_rgb (r, g, b);
+    return 0;
+  }
+  case COLOR_B: {
+    if (! lua_isnumber (L, 3)) return 0;
+    unsigned char r, g, b;
+    al_unmap_rgb (*c, &r, &g, &b);
+    b = lua_tonumber (L, 3);
+    *c = al_map_rgb (r, g, b);
+    return 0;
+  }
+  case COLOR_A: {
+    if (! lua_isnumber (L, 3)) return 0;
+    unsigned char r, g, b, a;
+    al_unmap_rgba (*c, &r, &g, &b, &a);
+    a = lua_tonumber (L, 3);
+    *c = al_map_rgba (r, g, b, a);
+    return 0;
+  }
+  case COLOR_HTML:
+    if (lua_isstring (L, 3))
+      *c = al_color_html (lua_tostring (L, 3));
+    else return 0;
+    break;
+  case COLOR_NAME:
+    if (lua_isstring (L, 3))
+      *c = al_color_name (lua_tostring (L, 3));
+    else return 0;
+    break;
   default: break;
   }
 
@@ -25,6 +25,16 @@ static DECLARE_LUA (__index);
 static DECLARE_LUA (__newindex);
 static DECLARE_LUA (__tostring);
 
+enum coordinate_key {
+  COORDINATE_X, COORDINATE_Y
+};
+
+static const char *const coordinate_keys[] = {
+  [COORDINATE_X] = "x",
+  [COORDINATE_Y] = "y",
+  NULL,
+};
+
 void
 define_L_mininim_video_coordinate (lua_State *L)
 {
@@ -34,13 +44,7 @@ define_L_mininim_video_coordinate (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, coordinate_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -63,7 +67,7 @@ BEGIN_LUA (L_mininim_video_coordinate)
   int x = luaL_checknumber (L, 1);
   int y = luaL_checknumber (L, 2);
   struct coord c;
-  new_coord (&c, &global_level, room_view, x, y);
+  new_coord (&c, &engine->level, room_view, x, y);
   L_pushcoordinate (L, &c);
   return 1;
 }
@@ -92,18 +96,13 @@ BEGIN_LUA (__index)
     return 1;
   }
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "x")) {
-      lua_pushnumber (L, c->x);
-      return 1;
-    } else if (! strcasecmp (key, "y")) {
-      lua_pushnumber (L, c->y);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case COORDINATE_X:
+    lua_pushnumber (L, c->x);
+    return 1;
+  case COORDINATE_Y:
+    lua_pushnumber (L, c->y);
+    return 1;
   default: break;
   }
 
@@ -118,18 +117,13 @@ BEGIN_LUA (__newindex)
 
   if (! c) return 0;
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "x")) {
-      c->x = lua_tonumber (L, 3);
-      return 0;
-    } else if (! strcasecmp (key, "y")) {
-      c->y = lua_tonumber (L, 3);
-      return 0;
-    } else break;
+  switch (L_key (L, 2)) {
+  case COORDINATE_X:
+    c->x = lua_tonumber (L, 3);
+    return 0;
+  case COORDINATE_Y:
+    c->y = lua_tonumber (L, 3);
+    return 0;
   default: break;
   }
 
@@ -25,5 +25,7 @@
 
 void define_L_mininim_video (lua_State *L);
 bool L_push_video_routine (lua_State *L);
+const char *L_env_mode (void);
+const char *L_hue_mode (void);
 
 #endif	/* MININIM_L_MININIM_VIDEO_H */
@@ -27,6 +27,21 @@ static DECLARE_LUA (__tostring);
 
 static DECLARE_LUA (draw);
 
+enum rectangle_key {
+  RECTANGLE_COORDINATE, RECTANGLE_X, RECTANGLE_Y, RECTANGLE_WIDTH,
+  RECTANGLE_HEIGHT, RECTANGLE_DRAW
+};
+
+static const char *const rectangle_keys[] = {
+  [RECTANGLE_COORDINATE] = "coordinate",
+  [RECTANGLE_X] = "x",
+  [RECTANGLE_Y] = "y",
+  [RECTANGLE_WIDTH] = "width",
+  [RECTANGLE_HEIGHT] = "height",
+  [RECTANGLE_DRAW] = "draw",
+  NULL,
+};
+
 void
 define_L_mininim_video_rectangle (lua_State *L)
 {
@@ -36,13 +51,7 @@ define_L_mininim_video_rectangle (lua_State *L)
   lua_pushcfunction (L, __eq);
   lua_rawset (L, -3);
 
-  lua_pushstring (L, "__index");
-  lua_pushcfunction (L, __index);
-  lua_rawset (L, -3);
-
-  lua_pushstring (L, "__newindex");
-  lua_pushcfunction (L, __newindex);
-  lua_rawset (L, -3);
+  L_set_indexers (L, __index, __newindex, rectangle_keys);
 
   lua_pushstring (L, "__tostring");
   lua_pushcfunction (L, __tostring);
@@ -107,31 +116,25 @@ BEGIN_LUA (__index)
     return 1;
   }
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "coordinate")) {
-      L_pushcoordinate (L, &r->c);
-      return 1;
-    } else if (! strcasecmp (key, "x")) {
-      lua_pushnumber (L, r->c.x);
-      return 1;
-    } else if (! strcasecmp (key, "y")) {
-      lua_pushnumber (L, r->c.y);
-      return 1;
-    } else if (! strcasecmp (key, "width")) {
-      lua_pushnumber (L, r->w);
-      return 1;
-    } else if (! strcasecmp (key, "height")) {
-      lua_pushnumber (L, r->h);
-      return 1;
-    } else if (! strcasecmp (key, "draw")) {
-      lua_pushvalue (L, 1);
-      lua_pushcclosure (L, draw, 1);
-      return 1;
-    } else break;
+  switch (L_key (L, 2)) {
+  case RECTANGLE_COORDINATE:
+    L_pushcoordinate (L, &r->c);
+    return 1;
+  case RECTANGLE_X:
+    lua_pushnumber (L, r->c.x);
+    return 1;
+  case RECTANGLE_Y:
+    lua_pushnumber (L, r->c.y);
+    return 1;
+  case RECTANGLE_WIDTH:
+    lua_pushnumber (L, r->w);
+    return 1;
+  case RECTANGLE_HEIGHT:
+    lua_pushnumber (L, r->h);
+    return 1;
+  case RECTANGLE_DRAW:
+    L_pushmethod (L, 1, RECTANGLE_DRAW, draw);
+    return 1;
   default: break;
   }
 
@@ -146,29 +149,25 @@ BEGIN_LUA (__newindex)
 
   if (! r) return 0;
 
-  const char *key;
-  int type = lua_type (L, 2);
-  switch (type) {
-  case LUA_TSTRING:
-    key = lua_tostring (L, 2);
-    if (! strcasecmp (key, "coordinate")) {
-      struct coord *c =luaL_checkudata (L, 3, L_MININIM_VIDEO_COORDINATE);
-      if (! c) return 0;
-      r->c = *c;
-      return 0;
-    } else if (! strcasecmp (key, "x")) {
-      r->c.x = lua_tonumber (L, 3);
-      return 0;
-    } else if (! strcasecmp (key, "y")) {
-      r->c.y = lua_tonumber (L, 3);
-      return 0;
-    } else if (! strcasecmp (key, "width")) {
-      r->w = lua_tonumber (L, 3);
-      return 0;
-    } else if (! strcasecmp (key, "height")) {
-      r->h = lua_tonumber (L, 3);
-      return 0;
-    } else break;
+  switch (L_key (L, 2)) {
+  case RECTANGLE_COORDINATE: {
+    struct coord *c =luaL_checkudata (L, 3, L_MININIM_VIDEO_COORDINATE);
+    if (! c) return 0;
+    r->c = *c;
+    return 0;
+  }
+  case RECTANGLE_X:
+    r->c.x = lua_tonumber (L, 3);
+    return 0;
+  case RECTANGLE_Y:
+    r->c.y = lua_tonumber (L, 3);
+    return 0;
+  case RECTANGLE_WIDTH:
+    r->w = lua_tonumber (L, 3);
+    return 0;
+  case RECTANGLE_HEIGHT:
+    r->h = lua_tonumber (L, 3);
+    return 0;
   default: break;
   }
 
@@ -201,6 +201,138 @@ L_get_registry_by_ref (lua_State *L, int r)
   lua_rawgeti (L, LUA_REGISTRYINDEX, r);
 }
 
+/* Interned keys: the field names a binding knows are put into a
+   table mapping each name, case folded, to its index in KEYS.  Lua
+   strings are interned, so resolving a field is one table lookup
+   instead of a chain of string comparisons.  Any other spelling of a
+   name is folded once and then remembered under that spelling as
+   well, names being case insensitive.
+
+   The keys table is upvalue 1 of the binding's __index and
+   __newindex, and upvalue 2 is a cache of method closures, so that
+   the same closure is handed out again for the same object while it
+   is alive. */
+void
+L_set_indexers (lua_State *L, lua_CFunction index, lua_CFunction newindex,
+                const char *const *keys)
+{
+  int i, mt = lua_gettop (L);
+
+  lua_newtable (L);
+  for (i = 0; keys[i]; i++) {
+    L_pushfolded (L, keys[i], strlen (keys[i]));
+    lua_pushnumber (L, i);
+    lua_rawset (L, -3);
+  }
+
+  lua_newtable (L);
+
+  if (index) {
+    lua_pushstring (L, "__index");
+    lua_pushvalue (L, mt + 1);
+    lua_pushvalue (L, mt + 2);
+    lua_pushcclosure (L, index, 2);
+    lua_rawset (L, mt);
+  }
+
+  if (newindex) {
+    lua_pushstring (L, "__newindex");
+    lua_pushvalue (L, mt + 1);
+    lua_pushvalue (L, mt + 2);
+    lua_pushcclosure (L, newindex, 2);
+    lua_rawset (L, mt);
+  }
+
+  lua_pop (L, 2);
+}
+
+void
+L_pushfolded (lua_State *L, const char *s, size_t len)
+{
+  char *f = xmalloc (len + 1);
+  size_t i;
+  for (i = 0; i < len; i++) f[i] = tolower ((unsigned char) s[i]);
+  lua_pushlstring (L, f, len);
+  al_free (f);
+}
+
+/* Return the index of the field name at INDEX in the keys of the
+   running indexer, or -1 if it's none of them.  Spellings found to
+   fold to a key are remembered, so that they are looked up once.
+   Other names aren't, since some bindings take arbitrary strings as
+   keys and the table would grow without bound. */
+int
+L_key (lua_State *L, int index)
+{
+  if (lua_type (L, index) != LUA_TSTRING) return -1;
+
+  int keys = lua_upvalueindex (1);
+  index = lua_abs_index (L, index);
+
+  lua_pushvalue (L, index);
+  lua_rawget (L, keys);
+  if (lua_isnumber (L, -1)) {
+    int k = lua_tonumber (L, -1);
+    lua_pop (L, 1);
+    return k;
+  }
+  lua_pop (L, 1);
+
+  L_pushfolded (L, lua_tostring (L, index), lua_strlen (L, index));
+  lua_rawget (L, keys);
+  if (! lua_isnumber (L, -1)) {
+    lua_pop (L, 1);
+    return -1;
+  }
+  int k = lua_tonumber (L, -1);
+  lua_pop (L, 1);
+
+  lua_pushvalue (L, index);
+  lua_pushnumber (L, k);
+  lua_rawset (L, keys);
+
+  return k;
+}
+
+/* Push method F bound to the object at INDEX as its only upvalue,
+   reusing the closure made for this object and KEY if it's still
+   alive.  A live closure keeps its object alive, so an object's
+   address identifies it for as long as the cache entry lasts. */
+void
+L_pushmethod (lua_State *L, int index, int key, lua_CFunction f)
+{
+  int methods = lua_upvalueindex (2);
+  index = lua_abs_index (L, index);
+
+  /* one weak valued table per method */
+  lua_rawgeti (L, methods, key);
+  if (lua_isnil (L, -1)) {
+    lua_pop (L, 1);
+    lua_newtable (L);
+    lua_pushvalue (L, -1);
+    lua_pushstring (L, "__mode");
+    lua_pushstring (L, "v");
+    lua_rawset (L, -3);
+    lua_setmetatable (L, -2);
+    lua_pushvalue (L, -1);
+    lua_rawseti (L, methods, key);
+  }
+
+  void *p = (void *) lua_topointer (L, index);
+  lua_pushlightuserdata (L, p);
+  lua_rawget (L, -2);
+  if (lua_isnil (L, -1)) {
+    lua_pop (L, 1);
+    lua_pushvalue (L, index);
+    lua_pushcclosure (L, f, 1);
+    lua_pushlightuserdata (L, p);
+    lua_pushvalue (L, -2);
+    lua_rawset (L, -4);
+  }
+
+  lua_remove (L, -2);
+}
+
 void
 L_set_weak_registry_by_ptr (lua_State *L, void *p)
 {
@@ -51,6 +51,12 @@ void L_get_weak_registry_by_ptr (lua_State *L, void *p);
 
 void L_gc (lua_State *L);
 
+void L_set_indexers (lua_State *L, lua_CFunction index,
+                     lua_CFunction newindex, const char *const *keys);
+void L_pushfolded (lua_State *L, const char *s, size_t len);
+int L_key (lua_State *L, int index);
+void L_pushmethod (lua_State *L, int index, int key, lua_CFunction f);
+
 int L_error_expected_got (lua_State *L, int index,
                           const char *expected_tname);
 
@@ -68,9 +68,6 @@ ALLEGRO_BITMAP *pv_spikes_floor_left, *pv_spikes_floor_right,
   *pv_spikes_left_03, *pv_spikes_right_03, *pv_spikes_fg_03,
   *pv_spikes_left_04, *pv_spikes_right_04, *pv_spikes_fg_04;
 
-struct spikes_floor *spikes_floor = NULL;
-size_t spikes_floor_nmemb = 0;
-
 void
 load_spikes_floor (void)
 {
@@ -339,9 +336,9 @@ register_spikes_floor (struct pos *p)
 
   init_spikes_floor (p, &s);
 
-  spikes_floor =
-    add_to_array (&s, 1, spikes_floor, &spikes_floor_nmemb,
-                  spikes_floor_nmemb, sizeof (s));
+  engine->spikes_floor =
+    add_to_array (&s, 1, engine->spikes_floor, &engine->spikes_floor_nmemb,
+                  engine->spikes_floor_nmemb, sizeof (s));
 
   sort_spikes_floors ();
 }
@@ -349,7 +346,7 @@ register_spikes_floor (struct pos *p)
 void
 sort_spikes_floors (void)
 {
-  qsort (spikes_floor, spikes_floor_nmemb,
+  qsort (engine->spikes_floor, engine->spikes_floor_nmemb,
          sizeof (struct spikes_floor), compare_spikes_floors);
 }
 
@@ -380,7 +377,7 @@ spikes_floor_at_pos (struct pos *p)
   struct spikes_floor *ss;
 
  search:
-  ss = bsearch (&s, spikes_floor, spikes_floor_nmemb, sizeof (s),
+  ss = bsearch (&s, engine->spikes_floor, engine->spikes_floor_nmemb, sizeof (s),
                 compare_spikes_floors);
 
   if (ss && fg (p) != SPIKES_FLOOR) {
@@ -397,9 +394,9 @@ spikes_floor_at_pos (struct pos *p)
 void
 remove_spikes_floor (struct spikes_floor *s)
 {
-  size_t i =  s - spikes_floor;
-  spikes_floor =
-    remove_from_array (spikes_floor, &spikes_floor_nmemb, i, 1, sizeof (*s));
+  size_t i =  s - engine->spikes_floor;
+  engine->spikes_floor =
+    remove_from_array (engine->spikes_floor, &engine->spikes_floor_nmemb, i, 1, sizeof (*s));
 }
 
 void
@@ -417,16 +414,16 @@ compute_spikes_floors (void)
 {
   size_t i, j;
 
-  for (i = 0; i < spikes_floor_nmemb;) {
-    struct spikes_floor *s = &spikes_floor[i];
+  for (i = 0; i < engine->spikes_floor_nmemb;) {
+    struct spikes_floor *s = &engine->spikes_floor[i];
     if (fg (&s->p) == SPIKES_FLOOR) {
       i++; continue;
     }
     remove_spikes_floor (s);
   }
 
-  for (i = 0; i < spikes_floor_nmemb; i++) {
-    struct spikes_floor *s = &spikes_floor[i];
+  for (i = 0; i < engine->spikes_floor_nmemb; i++) {
+    struct spikes_floor *s = &engine->spikes_floor[i];
 
     if (! s->inactive) {
       int state = s->state;
@@ -479,8 +476,8 @@ compute_spikes_floors (void)
     }
 
     /* spike kid */
-    for (j = 0; j < anima_nmemb; j++) {
-      struct anim *a = &anima[j];
+    for (j = 0; j < engine->anima_nmemb; j++) {
+      struct anim *a = &engine->anima[j];
       if (is_kid_dead (&a->f)
           || a->immortal
           || a->spikes_immune
@@ -525,8 +522,8 @@ should_spikes_raise (struct pos *p)
   int i;
   struct pos pml, pm, pmr;
 
-  for (i = 0; i < anima_nmemb; i++) {
-    struct anim *a = &anima[i];
+  for (i = 0; i < engine->anima_nmemb; i++) {
+    struct anim *a = &engine->anima[i];
     if (is_anim_dead (&a->f)) continue;
     survey (_ml, pos, &a->f, NULL, &pml, NULL);
     surveyo (_m, -2, +0, pos, &a->f, NULL, &pm, NULL);
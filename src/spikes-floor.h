@@ -135,10 +135,6 @@
 #define PV_SPIKES_RIGHT_04 "data/spikes-floor/pv-spikes-right-04.png"
 #define PV_SPIKES_FG_04 "data/spikes-floor/pv-spikes-fg-04.png"
 
-/* variables */
-extern struct spikes_floor *spikes_floor;
-extern size_t spikes_floor_nmemb;
-
 /* functions */
 void load_spikes_floor (void);
 void unload_spikes_floor (void);
@@ -139,7 +139,7 @@ draw_stars (ALLEGRO_BITMAP *bitmap, struct stars *stars, enum vm vm)
 {
   if (! stars->count) return;
 
-  if (anim_cycle % 4 || is_game_paused ()) {
+  if (engine->anim_cycle % 4 || is_game_paused ()) {
     draw_bitmapc (stars->b, bitmap, &stars->c, 0);
     return;
   }
@@ -153,6 +153,7 @@ draw_stars (ALLEGRO_BITMAP *bitmap, struct stars *stars, enum vm vm)
 void
 draw_star (struct stars *stars, int i, enum vm vm)
 {
+  flush_draw_batch ();
   al_lock_bitmap (stars->b, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READWRITE);
   set_target_bitmap (stars->b);
   al_put_pixel (stars->s[i].x - stars->c.x, stars->s[i].y - stars->c.y,
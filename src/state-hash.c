@@ -0,0 +1,687 @@
+/*
+  state-hash.c -- simulation state hashing module;
+
+  Copyright (C) 2015, 2016, 2017 Bruno Félix Rezende Ribeiro
+  <oitofelix@gnu.org>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mininim.h"
+
+/* The simulation state is hashed field by field, rather than as raw
+   memory, so that pointers, padding and drawing-only data don't make
+   equal states look different.  Every cycle the state is serialized
+   in a normalized form, described by the tables below, and hashed
+   with 64-bit FNV-1a.  The same serialization is what a state trace
+   stores, so two traces can be compared down to the first differing
+   field.  Enumerations are read with their actual size, which is up
+   to the compiler, and always stored as 32-bit integers. */
+
+enum state_field_type {
+  STATE_FIELD_BOOL, STATE_FIELD_INT, STATE_FIELD_ENUM, STATE_FIELD_U64,
+  STATE_FIELD_POS, STATE_FIELD_COORD,
+};
+
+struct state_field {
+  char *name;
+  size_t offset;
+  size_t size;
+  enum state_field_type type;
+};
+
+struct state_array {
+  char *name;
+  size_t base_offset;
+  size_t nmemb_offset;
+  size_t size;
+  struct state_field *field;
+};
+
+struct state_trace_record {
+  uint64_t chain;
+  uint64_t cycle;
+  int64_t offset;
+  uint32_t size;
+};
+
+#define STATE_FIELD(s, m, t)                                    \
+  {#m, offsetof (struct s, m), sizeof (((struct s *) NULL)->m), \
+      STATE_FIELD_##t}
+
+#define STATE_ARRAY(a, s, f)                                    \
+  {#a, offsetof (struct engine, a),                             \
+      offsetof (struct engine, a##_nmemb), sizeof (struct s), f}
+
+#define FNV_OFFSET_BASIS UINT64_C (0xcbf29ce484222325)
+#define FNV_PRIME UINT64_C (0x100000001b3)
+
+static struct state_field anim_state_field[] = {
+  STATE_FIELD (anim, type, ENUM),
+  STATE_FIELD (anim, original_type, ENUM),
+  STATE_FIELD (anim, id, INT),
+  STATE_FIELD (anim, shadow_of, INT),
+  STATE_FIELD (anim, level_id, INT),
+  STATE_FIELD (anim, f.parent_id, INT),
+  STATE_FIELD (anim, f.c, COORD),
+  STATE_FIELD (anim, f.oc, COORD),
+  STATE_FIELD (anim, f.dir, ENUM),
+  STATE_FIELD (anim, f.flip, INT),
+  STATE_FIELD (anim, fo.dx, INT),
+  STATE_FIELD (anim, fo.dy, INT),
+  STATE_FIELD (anim, xf.dx, INT),
+  STATE_FIELD (anim, xf.dy, INT),
+  STATE_FIELD (anim, ci.kid_p, POS),
+  STATE_FIELD (anim, ci.con_p, POS),
+  STATE_FIELD (anim, key.up, BOOL),
+  STATE_FIELD (anim, key.down, BOOL),
+  STATE_FIELD (anim, key.left, BOOL),
+  STATE_FIELD (anim, key.right, BOOL),
+  STATE_FIELD (anim, key.shift, BOOL),
+  STATE_FIELD (anim, key.enter, BOOL),
+  STATE_FIELD (anim, key.ctrl, BOOL),
+  STATE_FIELD (anim, key.alt, BOOL),
+  STATE_FIELD (anim, i, INT),
+  STATE_FIELD (anim, j, INT),
+  STATE_FIELD (anim, wait, INT),
+  STATE_FIELD (anim, repeat, INT),
+  STATE_FIELD (anim, cinertia, INT),
+  STATE_FIELD (anim, inertia, INT),
+  STATE_FIELD (anim, walk, INT),
+  STATE_FIELD (anim, total_lives, INT),
+  STATE_FIELD (anim, current_lives, INT),
+  STATE_FIELD (anim, reverse, BOOL),
+  STATE_FIELD (anim, collision, BOOL),
+  STATE_FIELD (anim, fall, BOOL),
+  STATE_FIELD (anim, hit_ceiling, BOOL),
+  STATE_FIELD (anim, hit_ceiling_fake, BOOL),
+  STATE_FIELD (anim, just_hanged, BOOL),
+  STATE_FIELD (anim, hang, BOOL),
+  STATE_FIELD (anim, hang_limit, BOOL),
+  STATE_FIELD (anim, misstep, BOOL),
+  STATE_FIELD (anim, uncouch_slowly, BOOL),
+  STATE_FIELD (anim, keep_sword_fast, BOOL),
+  STATE_FIELD (anim, turn, BOOL),
+  STATE_FIELD (anim, shadow, BOOL),
+  STATE_FIELD (anim, splash, BOOL),
+  STATE_FIELD (anim, hit_by_loose_floor, BOOL),
+  STATE_FIELD (anim, invisible, BOOL),
+  STATE_FIELD (anim, has_sword, BOOL),
+  STATE_FIELD (anim, hurt, BOOL),
+  STATE_FIELD (anim, controllable, BOOL),
+  STATE_FIELD (anim, fight, BOOL),
+  STATE_FIELD (anim, edge_detection, BOOL),
+  STATE_FIELD (anim, auto_taken_sword, BOOL),
+  STATE_FIELD (anim, constrained_turn_run, BOOL),
+  STATE_FIELD (anim, enemy_defended_my_attack, INT),
+  STATE_FIELD (anim, enemy_counter_attacked_myself, INT),
+  STATE_FIELD (anim, i_counter_defended, INT),
+  STATE_FIELD (anim, i_initiated_attack, BOOL),
+  STATE_FIELD (anim, attack_range_far, BOOL),
+  STATE_FIELD (anim, attack_range_near, BOOL),
+  STATE_FIELD (anim, hurt_enemy_in_counter_attack, BOOL),
+  STATE_FIELD (anim, angry, INT),
+  STATE_FIELD (anim, no_walkf_timer, INT),
+  STATE_FIELD (anim, death_timer, INT),
+  STATE_FIELD (anim, skill.attack_prob, INT),
+  STATE_FIELD (anim, skill.counter_attack_prob, INT),
+  STATE_FIELD (anim, skill.defense_prob, INT),
+  STATE_FIELD (anim, skill.counter_defense_prob, INT),
+  STATE_FIELD (anim, skill.advance_prob, INT),
+  STATE_FIELD (anim, skill.return_prob, INT),
+  STATE_FIELD (anim, skill.refraction, INT),
+  STATE_FIELD (anim, skill.extra_life, INT),
+  STATE_FIELD (anim, refraction, INT),
+  STATE_FIELD (anim, float_timer, U64),
+  STATE_FIELD (anim, dc, INT),
+  STATE_FIELD (anim, df, INT),
+  STATE_FIELD (anim, dl, INT),
+  STATE_FIELD (anim, dcl, INT),
+  STATE_FIELD (anim, dch, INT),
+  STATE_FIELD (anim, dcd, INT),
+  STATE_FIELD (anim, immortal, BOOL),
+  STATE_FIELD (anim, poison_immune, BOOL),
+  STATE_FIELD (anim, loose_floor_immune, BOOL),
+  STATE_FIELD (anim, fall_immune, BOOL),
+  STATE_FIELD (anim, spikes_immune, BOOL),
+  STATE_FIELD (anim, chopper_immune, BOOL),
+  STATE_FIELD (anim, sword_immune, INT),
+  STATE_FIELD (anim, enemy_id, INT),
+  STATE_FIELD (anim, enemy_refraction, INT),
+  STATE_FIELD (anim, style, INT),
+  STATE_FIELD (anim, confg, ENUM),
+  STATE_FIELD (anim, item, ENUM),
+  STATE_FIELD (anim, alert_cycle, U64),
+  STATE_FIELD (anim, p, POS),
+  STATE_FIELD (anim, item_pos, POS),
+  STATE_FIELD (anim, hang_pos, POS),
+  STATE_FIELD (anim, enemy_pos, POS),
+  STATE_FIELD (anim, cross_mirror_p, POS),
+  STATE_FIELD (anim, death_reason, ENUM),
+  STATE_FIELD (anim, glory_sample, BOOL),
+  STATE_FIELD (anim, df_pos[0], POS),
+  STATE_FIELD (anim, df_pos[1], POS),
+  STATE_FIELD (anim, df_posb[0], POS),
+  STATE_FIELD (anim, df_posb[1], POS),
+  {NULL},
+};
+
+static struct state_field door_state_field[] = {
+  STATE_FIELD (door, p, POS),
+  STATE_FIELD (door, i, INT),
+  STATE_FIELD (door, action, ENUM),
+  STATE_FIELD (door, wait, INT),
+  STATE_FIELD (door, noise, BOOL),
+  STATE_FIELD (door, priority, U64),
+  {NULL},
+};
+
+static struct state_field loose_floor_state_field[] = {
+  STATE_FIELD (loose_floor, p, POS),
+  STATE_FIELD (loose_floor, original_pos, POS),
+  STATE_FIELD (loose_floor, i, INT),
+  STATE_FIELD (loose_floor, resist, INT),
+  STATE_FIELD (loose_floor, state, INT),
+  STATE_FIELD (loose_floor, cant_fall, BOOL),
+  STATE_FIELD (loose_floor, action, ENUM),
+  STATE_FIELD (loose_floor, f.c, COORD),
+  STATE_FIELD (loose_floor, f.dir, ENUM),
+  STATE_FIELD (loose_floor, f.flip, INT),
+  {NULL},
+};
+
+static struct state_field spikes_floor_state_field[] = {
+  STATE_FIELD (spikes_floor, p, POS),
+  STATE_FIELD (spikes_floor, i, INT),
+  STATE_FIELD (spikes_floor, wait, INT),
+  STATE_FIELD (spikes_floor, state, INT),
+  STATE_FIELD (spikes_floor, inactive, BOOL),
+  STATE_FIELD (spikes_floor, activate, BOOL),
+  {NULL},
+};
+
+static struct state_field chopper_state_field[] = {
+  STATE_FIELD (chopper, p, POS),
+  STATE_FIELD (chopper, i, INT),
+  STATE_FIELD (chopper, wait, INT),
+  STATE_FIELD (chopper, blood, BOOL),
+  STATE_FIELD (chopper, activate, BOOL),
+  STATE_FIELD (chopper, inactive, BOOL),
+  STATE_FIELD (chopper, alert, BOOL),
+  {NULL},
+};
+
+static struct state_field opener_floor_state_field[] = {
+  STATE_FIELD (opener_floor, p, POS),
+  STATE_FIELD (opener_floor, event, INT),
+  STATE_FIELD (opener_floor, pressed, BOOL),
+  STATE_FIELD (opener_floor, prev_pressed, BOOL),
+  STATE_FIELD (opener_floor, noise, BOOL),
+  STATE_FIELD (opener_floor, broken, BOOL),
+  STATE_FIELD (opener_floor, priority, U64),
+  {NULL},
+};
+
+static struct state_field closer_floor_state_field[] = {
+  STATE_FIELD (closer_floor, p, POS),
+  STATE_FIELD (closer_floor, event, INT),
+  STATE_FIELD (closer_floor, pressed, BOOL),
+  STATE_FIELD (closer_floor, prev_pressed, BOOL),
+  STATE_FIELD (closer_floor, noise, BOOL),
+  STATE_FIELD (closer_floor, broken, BOOL),
+  STATE_FIELD (closer_floor, unresponsive, BOOL),
+  STATE_FIELD (closer_floor, priority, U64),
+  {NULL},
+};
+
+static struct state_field level_door_state_field[] = {
+  STATE_FIELD (level_door, p, POS),
+  STATE_FIELD (level_door, i, INT),
+  STATE_FIELD (level_door, broken, BOOL),
+  STATE_FIELD (level_door, action, ENUM),
+  STATE_FIELD (level_door, no_stairs, BOOL),
+  STATE_FIELD (level_door, priority, U64),
+  {NULL},
+};
+
+static struct state_array state_array[] = {
+  STATE_ARRAY (anima, anim, anim_state_field),
+  STATE_ARRAY (door, door, door_state_field),
+  STATE_ARRAY (loose_floor, loose_floor, loose_floor_state_field),
+  STATE_ARRAY (spikes_floor, spikes_floor, spikes_floor_state_field),
+  STATE_ARRAY (chopper, chopper, chopper_state_field),
+  STATE_ARRAY (opener_floor, opener_floor, opener_floor_state_field),
+  STATE_ARRAY (closer_floor, closer_floor, closer_floor_state_field),
+  STATE_ARRAY (level_door, level_door, level_door_state_field),
+  {NULL},
+};
+
+char *state_trace_filename;
+bool replay_state_hash;
+
+static uint8_t *state;
+static size_t state_size;
+static size_t state_capacity;
+
+static ALLEGRO_FILE *state_trace;
+static uint64_t state_trace_chain = FNV_OFFSET_BASIS;
+
+static uint64_t fnv1a (uint64_t h, void *data, size_t size);
+static uint64_t hash_state_layout (void);
+static void serialize_engine_state (struct engine *e);
+static void put_state (void *data, size_t size);
+static void put_state32 (uint32_t x);
+static void put_state64 (uint64_t x);
+static void put_state_field (struct state_field *f, void *base);
+static size_t state_field_size (struct state_field *f);
+static void print_state_field (struct state_field *f, uint8_t *data);
+static uint32_t get_state32 (uint8_t *data);
+static void write_state_trace (uint64_t h);
+static struct state_trace_record *
+load_state_trace (char *filename, uint64_t *layout, size_t *nmemb);
+static uint8_t *read_state_trace_record (char *filename,
+                                         struct state_trace_record *r);
+static void print_state_difference (uint8_t *s0, uint32_t size0,
+                                    uint8_t *s1, uint32_t size1);
+
+uint64_t
+hash_engine_state (struct engine *e)
+{
+  serialize_engine_state (e);
+  return fnv1a (FNV_OFFSET_BASIS, state, state_size);
+}
+
+/* Called once per cycle, right after the cycle's computation. */
+void
+update_state_hash (void)
+{
+  struct replay *replay = get_replay ();
+
+  bool record = replay_mode == RECORD_REPLAY && replay_state_hash;
+  bool check = replay_mode == PLAY_REPLAY && ! title_demo
+    && engine->anim_cycle < replay->state_hash_nmemb;
+
+  if (! state_trace_filename && ! record && ! check) return;
+
+  uint64_t h = hash_engine_state (engine);
+
+  if (state_trace_filename) write_state_trace (h);
+  if (record) store_replay_state_hash (replay, h, engine->anim_cycle);
+  if (check) check_replay_state_hash (replay, h, engine->anim_cycle);
+}
+
+void
+stop_state_trace (void)
+{
+  if (! state_trace) return;
+  al_fclose (state_trace);
+  state_trace = NULL;
+}
+
+/* Every trace record carries the hash of all states up to its own,
+   so once two traces diverge all further records differ as well.
+   This allows bisecting for the first diverging record, whose states
+   are then compared field by field. */
+int
+compare_state_traces (char *filename0, char *filename1)
+{
+  uint64_t layout0, layout1;
+  size_t nmemb0, nmemb1;
+  struct state_trace_record *t0 =
+    load_state_trace (filename0, &layout0, &nmemb0);
+  struct state_trace_record *t1 =
+    load_state_trace (filename1, &layout1, &nmemb1);
+
+  size_t n = nmemb0 < nmemb1 ? nmemb0 : nmemb1;
+  size_t a = 0, b = n;
+  while (a < b) {
+    size_t m = a + (b - a) / 2;
+    if (t0[m].chain == t1[m].chain) a = m + 1;
+    else b = m;
+  }
+
+  HLINE;
+  printf ("STATE TRACE COMPARISON\n");
+  HLINE;
+  printf ("Files: %s %s\n"
+          "Records: %zu %zu\n",
+          filename0, filename1, nmemb0, nmemb1);
+
+  int status = 1;
+  if (a == n && nmemb0 == nmemb1) {
+    printf ("Result: IDENTICAL\n");
+    status = 0;
+  } else if (a == n)
+    printf ("Result: TRUNCATED\n"
+            "Record: %zu\n", n);
+  else {
+    printf ("Result: DIVERGED\n"
+            "Record: %zu\n"
+            "Cycle: %ju %ju\n",
+            a, t0[a].cycle, t1[a].cycle);
+    if (layout0 != hash_state_layout () || layout1 != layout0)
+      printf ("Field: UNKNOWN (different state layouts)\n");
+    else {
+      uint8_t *s0 = read_state_trace_record (filename0, &t0[a]);
+      uint8_t *s1 = read_state_trace_record (filename1, &t1[a]);
+      print_state_difference (s0, t0[a].size, s1, t1[a].size);
+      al_free (s0);
+      al_free (s1);
+    }
+  }
+  HLINE;
+
+  al_free (t0);
+  al_free (t1);
+
+  return status;
+}
+
+static uint64_t
+fnv1a (uint64_t h, void *data, size_t size)
+{
+  uint8_t *p = data;
+  size_t i;
+  for (i = 0; i < size; i++) {
+    h ^= p[i];
+    h *= FNV_PRIME;
+  }
+  return h;
+}
+
+static uint64_t
+hash_state_layout (void)
+{
+  uint64_t h = FNV_OFFSET_BASIS;
+  struct state_array *a;
+  struct state_field *f;
+  for (a = state_array; a->name; a++) {
+    h = fnv1a (h, a->name, strlen (a->name) + 1);
+    for (f = a->field; f->name; f++) {
+      h = fnv1a (h, f->name, strlen (f->name) + 1);
+      uint8_t type = f->type;
+      h = fnv1a (h, &type, sizeof (type));
+    }
+  }
+  return h;
+}
+
+static void
+serialize_engine_state (struct engine *e)
+{
+  state_size = 0;
+
+  put_state32 (e->random_seed);
+
+  struct state_array *a;
+  for (a = state_array; a->name; a++) {
+    char *base = *(char **) ((char *) e + a->base_offset);
+    size_t nmemb = *(size_t *) ((char *) e + a->nmemb_offset);
+    put_state32 (nmemb);
+    size_t i;
+    for (i = 0; i < nmemb; i++) {
+      struct state_field *f;
+      for (f = a->field; f->name; f++)
+        put_state_field (f, base + i * a->size);
+    }
+  }
+}
+
+static void
+put_state (void *data, size_t size)
+{
+  if (state_size + size > state_capacity) {
+    state_capacity = state_capacity ? state_capacity : 4096;
+    while (state_size + size > state_capacity) state_capacity *= 2;
+    state = xrealloc (state, state_capacity);
+  }
+  memcpy (state + state_size, data, size);
+  state_size += size;
+}
+
+static void
+put_state32 (uint32_t x)
+{
+  uint8_t b[4] = {x, x >> 8, x >> 16, x >> 24};
+  put_state (b, sizeof (b));
+}
+
+static void
+put_state64 (uint64_t x)
+{
+  put_state32 (x);
+  put_state32 (x >> 32);
+}
+
+static void
+put_state_field (struct state_field *f, void *base)
+{
+  void *p = (char *) base + f->offset;
+  struct pos *ps = p;
+  struct coord *c = p;
+  uint8_t b;
+
+  switch (f->type) {
+  case STATE_FIELD_BOOL:
+    b = *(bool *) p;
+    put_state (&b, sizeof (b));
+    break;
+  case STATE_FIELD_INT:
+    assert (f->size == sizeof (int));
+    put_state32 (*(int *) p);
+    break;
+  case STATE_FIELD_ENUM:
+    switch (f->size) {
+    case 1: put_state32 (*(int8_t *) p); break;
+    case 2: put_state32 (*(int16_t *) p); break;
+    case 4: put_state32 (*(int32_t *) p); break;
+    default: assert (f->size == 8); put_state32 (*(int64_t *) p); break;
+    }
+    break;
+  case STATE_FIELD_U64: put_state64 (*(uint64_t *) p); break;
+  case STATE_FIELD_POS:
+    put_state32 (ps->room);
+    put_state32 (ps->floor);
+    put_state32 (ps->place);
+    break;
+  case STATE_FIELD_COORD:
+    put_state32 (c->room);
+    put_state32 (c->x);
+    put_state32 (c->y);
+    break;
+  }
+}
+
+static size_t
+state_field_size (struct state_field *f)
+{
+  switch (f->type) {
+  case STATE_FIELD_BOOL: return 1;
+  case STATE_FIELD_INT: case STATE_FIELD_ENUM: return 4;
+  case STATE_FIELD_U64: return 8;
+  case STATE_FIELD_POS: case STATE_FIELD_COORD: default: return 12;
+  }
+}
+
+static void
+print_state_field (struct state_field *f, uint8_t *data)
+{
+  switch (f->type) {
+  case STATE_FIELD_BOOL:
+    printf ("%s", data[0] ? "TRUE" : "FALSE");
+    break;
+  case STATE_FIELD_INT: case STATE_FIELD_ENUM:
+    printf ("%i", (int32_t) get_state32 (data));
+    break;
+  case STATE_FIELD_U64:
+    printf ("%ju", get_state32 (data)
+            | (uintmax_t) get_state32 (data + 4) << 32);
+    break;
+  case STATE_FIELD_POS: case STATE_FIELD_COORD:
+    printf ("(%i, %i, %i)", (int32_t) get_state32 (data),
+            (int32_t) get_state32 (data + 4),
+            (int32_t) get_state32 (data + 8));
+    break;
+  }
+}
+
+static uint32_t
+get_state32 (uint8_t *data)
+{
+  return data[0] | data[1] << 8 | data[2] << 16 | (uint32_t) data[3] << 24;
+}
+
+static void
+write_state_trace (uint64_t h)
+{
+  if (! state_trace) {
+    state_trace = al_fopen (state_trace_filename, "wb");
+    if (! state_trace
+        || al_fwrite (state_trace, STATE_TRACE_SIGNATURE,
+                      sizeof (STATE_TRACE_SIGNATURE))
+        != sizeof (STATE_TRACE_SIGNATURE)
+        || al_fwrite32le (state_trace, STATE_TRACE_VERSION) != 4
+        || al_fwrite32le (state_trace, hash_state_layout ()) != 4
+        || al_fwrite32le (state_trace, hash_state_layout () >> 32) != 4)
+      goto error;
+  }
+
+  uint8_t b[8] = {h, h >> 8, h >> 16, h >> 24,
+                  h >> 32, h >> 40, h >> 48, h >> 56};
+  state_trace_chain = fnv1a (state_trace_chain, b, sizeof (b));
+
+  if (al_fwrite32le (state_trace, state_trace_chain) != 4
+      || al_fwrite32le (state_trace, state_trace_chain >> 32) != 4
+      || al_fwrite32le (state_trace, engine->anim_cycle) != 4
+      || al_fwrite32le (state_trace, engine->anim_cycle >> 32) != 4
+      || al_fwrite32le (state_trace, state_size) != 4
+      || al_fwrite (state_trace, state, state_size) != state_size)
+    goto error;
+
+  return;
+
+ error:
+  error (0, al_get_errno (), "can't write state trace '%s'",
+         state_trace_filename);
+  stop_state_trace ();
+  al_free (state_trace_filename);
+  state_trace_filename = NULL;
+}
+
+static struct state_trace_record *
+load_state_trace (char *filename, uint64_t *layout, size_t *nmemb)
+{
+  ALLEGRO_FILE *f = al_fopen (filename, "rb");
+  if (! f) error (-1, al_get_errno (), "can't open state trace '%s'",
+                  filename);
+
+  char signature[sizeof (STATE_TRACE_SIGNATURE)];
+  al_fread (f, signature, sizeof (STATE_TRACE_SIGNATURE));
+  uint32_t version = al_fread32le (f);
+  *layout = (uint32_t) al_fread32le (f);
+  *layout |= (uint64_t) (uint32_t) al_fread32le (f) << 32;
+  if (al_feof (f) || al_ferror (f)
+      || memcmp (signature, STATE_TRACE_SIGNATURE,
+                 sizeof (STATE_TRACE_SIGNATURE))
+      || version != STATE_TRACE_VERSION)
+    error (-1, 0, "'%s' isn't a valid state trace", filename);
+
+  /* a truncated last record is ignored, since the trace of a crashed
+     run is still useful up to that point */
+  struct state_trace_record *t = NULL;
+  *nmemb = 0;
+  int64_t file_size = al_fsize (f);
+  for (;;) {
+    struct state_trace_record r;
+    r.chain = (uint32_t) al_fread32le (f);
+    r.chain |= (uint64_t) (uint32_t) al_fread32le (f) << 32;
+    r.cycle = (uint32_t) al_fread32le (f);
+    r.cycle |= (uint64_t) (uint32_t) al_fread32le (f) << 32;
+    r.size = al_fread32le (f);
+    if (al_feof (f) || al_ferror (f)) break;
+    r.offset = al_ftell (f);
+    if (r.offset + r.size > file_size
+        || ! al_fseek (f, r.size, ALLEGRO_SEEK_CUR)) break;
+    t = add_to_array (&r, 1, t, nmemb, *nmemb, sizeof (r));
+  }
+
+  al_fclose (f);
+  return t;
+}
+
+static uint8_t *
+read_state_trace_record (char *filename, struct state_trace_record *r)
+{
+  ALLEGRO_FILE *f = al_fopen (filename, "rb");
+  if (! f) error (-1, al_get_errno (), "can't open state trace '%s'",
+                  filename);
+
+  uint8_t *s = xmalloc (r->size + 1);
+  if (! al_fseek (f, r->offset, ALLEGRO_SEEK_SET)
+      || al_fread (f, s, r->size) != r->size)
+    error (-1, al_get_errno (), "can't read state trace '%s'", filename);
+
+  al_fclose (f);
+  return s;
+}
+
+static void
+print_state_difference (uint8_t *s0, uint32_t size0,
+                        uint8_t *s1, uint32_t size1)
+{
+  uint32_t o = 4;
+
+  if (size0 < o || size1 < o) goto unknown;
+
+  if (get_state32 (s0) != get_state32 (s1)) {
+    printf ("Field: random_seed\n"
+            "Values: 0x%X 0x%X\n", get_state32 (s0), get_state32 (s1));
+    return;
+  }
+
+  struct state_array *a;
+  for (a = state_array; a->name; a++) {
+    if (o + 4 > size0 || o + 4 > size1) goto unknown;
+    uint32_t n0 = get_state32 (s0 + o);
+    uint32_t n1 = get_state32 (s1 + o);
+    if (n0 != n1) {
+      printf ("Field: %s_nmemb\n"
+              "Values: %u %u\n", a->name, n0, n1);
+      return;
+    }
+    o += 4;
+
+    uint32_t i;
+    for (i = 0; i < n0; i++) {
+      struct state_field *f;
+      for (f = a->field; f->name; f++) {
+        size_t n = state_field_size (f);
+        if (o + n > size0 || o + n > size1) goto unknown;
+        if (memcmp (s0 + o, s1 + o, n)) {
+          printf ("Field: %s[%u].%s\n"
+                  "Values: ", a->name, i, f->name);
+          print_state_field (f, s0 + o);
+          printf (" ");
+          print_state_field (f, s1 + o);
+          printf ("\n");
+          return;
+        }
+        o += n;
+      }
+    }
+  }
+
+ unknown:
+  printf ("Field: UNKNOWN\n");
+}
@@ -0,0 +1,34 @@
+/*
+  state-hash.h -- simulation state hashing module;
+
+  Copyright (C) 2015, 2016, 2017 Bruno Félix Rezende Ribeiro
+  <oitofelix@gnu.org>
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 3, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MININIM_STATE_HASH_H
+#define MININIM_STATE_HASH_H
+
+/* functions */
+uint64_t hash_engine_state (struct engine *e);
+void update_state_hash (void);
+void stop_state_trace (void);
+int compare_state_traces (char *filename0, char *filename1);
+
+/* variables */
+extern char *state_trace_filename;
+extern bool replay_state_hash;
+
+#endif	/* MININIM_STATE_HASH_H */
@@ -211,7 +211,7 @@ draw_sword (ALLEGRO_BITMAP *bitmap, struct pos *p, enum vm vm, bool start_pos)
   }
 
   struct coord c;
-  ALLEGRO_BITMAP *sword = anim_cycle % 60 ? normal_sword : shiny_sword;
+  ALLEGRO_BITMAP *sword = engine->anim_cycle % 60 ? normal_sword : shiny_sword;
   seedp (p);
   draw_bitmapc (sword, bitmap, sword_coord (p, &c),
                 prandom (1) ? ALLEGRO_FLIP_HORIZONTAL : 0);
@@ -134,6 +134,12 @@ struct multi_room {
     bool done;
     int room;
 
+    /* screen area changed since it was last scaled into the display,
+       and screen area covered by animated content on the last
+       frame */
+    struct drawn_rectangle dirty;
+    struct drawn_rectangle drawn;
+
     struct stars {
       ALLEGRO_BITMAP *b;
       struct coord c;
@@ -142,6 +148,14 @@ struct multi_room {
     } stars[FLOORS][PLACES];
   } **cell;
 
+  /* cells showing each room R, bottom row first and from left to
+     right, are ROOM_CELL[ROOM_CELL_INDEX[R]] up to (but not including)
+     ROOM_CELL[ROOM_CELL_INDEX[R + 1]] */
+  struct mr_cell_coord {
+    int x, y;
+  } *room_cell;
+  int room_cell_index[ROOMS + 1];
+
   struct {
     int w, h, x, y, room;
 
@@ -171,6 +185,13 @@ struct mouse_coord {
   int sx, sy;
 };
 
+struct anim_sort_key {
+  bool stairs;
+  struct coord tr, m;
+  int floor;
+  int id;
+};
+
 struct mr_room_list {
   int *room;
   size_t nmemb;
@@ -499,6 +520,16 @@ enum rendering {
   BOTH_RENDERING, VIDEO_RENDERING, AUDIO_RENDERING, NONE_RENDERING,
 };
 
+enum profiler_scope {
+  COMPUTE_LEVEL_SCOPE, DRAW_MULTI_ROOMS_SCOPE, FLIP_DISPLAY_SCOPE,
+  APPLY_PALETTE_SCOPE, UPDATE_CACHE_SCOPE, PROFILER_SCOPES,
+};
+
+enum telemetry_metric {
+  COMPUTE_TELEMETRY, DRAW_TELEMETRY, FLIP_TELEMETRY, WAIT_TELEMETRY,
+  FRAME_TELEMETRY, TELEMETRY_METRICS,
+};
+
 enum validate_replay_chain {
   NONE_VALIDATE_REPLAY_CHAIN, READ_VALIDATE_REPLAY_CHAIN,
   WRITE_VALIDATE_REPLAY_CHAIN,
@@ -543,6 +574,33 @@ enum wall_correlation {
   SWS, SWW, WWS, WWW
 };
 
+enum wall_part {
+  WALL_PART_BASE, WALL_PART_LEFT, WALL_PART_RIGHT, WALL_PART_TOP,
+  WALL_PARTS,
+};
+
+/* wall drawing of a video mode, compiled from its declarative draw
+   table; Lua references are registry references */
+struct wall_draw_table {
+  char *video_mode;
+  int ref;
+  int palette_ref, hue_ref[HUE_BLUE + 1];
+  int selection_ref, selection_em_ref[PALACE + 1];
+  struct wall_draw_env {
+    bool defined;
+    int part_ref[WALL_PARTS];
+    ALLEGRO_BITMAP *base[WWW + 1], *left[WWW + 1];
+    ALLEGRO_BITMAP *right, *top;
+    int top_offset;
+    ALLEGRO_BITMAP *narrow_divider, *wide_divider, *random_block;
+    ALLEGRO_BITMAP *mark_top_left, *mark_bottom_left;
+    ALLEGRO_BITMAP *mark_top_right, *mark_bottom_right;
+    bool brick;
+    ALLEGRO_COLOR brick_color[8];
+    ALLEGRO_BITMAP *brick_mark[15];
+  } env[PALACE + 1];
+};
+
 struct int_range {
   int a, b;
 };
@@ -581,7 +639,10 @@ enum options {
   RECORD_REPLAY_OPTION, REPLAY_INFO_OPTION, RENDERING_OPTION,
   VALIDATE_REPLAY_CHAIN_OPTION, GAMEPAD_RUMBLE_GAIN_OPTION, SCREAM_OPTION,
   RANDOM_SEED_OPTION, GAMEPAD_MODE_OPTION, PRINT_REPLAY_FAVORITES_OPTION,
-  REPLAY_FAVORITE_OPTION,
+  REPLAY_FAVORITE_OPTION, HEADLESS_OPTION, REPLAY_JOBS_OPTION,
+  REPLAY_STATE_HASH_OPTION, STATE_TRACE_OPTION, COMPARE_STATE_TRACES_OPTION,
+  PRECOMPUTE_HUES_OPTION, PROFILE_TRACE_OPTION, TELEMETRY_OPTION,
+  TELEMETRY_OVERLAY_OPTION,
 };
 
 enum level_module {
@@ -801,4 +862,46 @@ struct room_copy {
   struct con_copy c[FLOORS][PLACES];
 };
 
+/* engine */
+
+struct engine {
+  struct level level;
+
+  struct anim *anima;
+  size_t anima_nmemb;
+
+  /* index into ANIMA of the first actor with each id (-1 if none),
+     rebuilt on demand after actors are created, destroyed, reordered
+     or restored */
+  int *anim_index;
+  size_t anim_index_nmemb;
+  bool anim_index_valid;
+
+  struct door *door;
+  size_t door_nmemb;
+  struct loose_floor *loose_floor;
+  size_t loose_floor_nmemb;
+  struct spikes_floor *spikes_floor;
+  size_t spikes_floor_nmemb;
+  struct chopper *chopper;
+  size_t chopper_nmemb;
+  struct opener_floor *opener_floor;
+  size_t opener_floor_nmemb;
+  struct closer_floor *closer_floor;
+  size_t closer_floor_nmemb;
+  struct level_door *level_door;
+  size_t level_door_nmemb;
+
+  /* seed saved by 'seedp' and put back by 'unseedp' */
+  uint32_t random_seed, random_seed_backup;
+  uint64_t anim_cycle;
+  uint64_t play_time;
+  bool play_time_stopped;
+
+  int current_kid_id;
+  int last_fellow_shadow_id;
+  int camera_follow_kid;
+  uint64_t death_timer;
+};
+
 #endif	/* MININIM_TYPES_H */
@@ -135,6 +135,7 @@ static void ui_vm (enum vm new_vm);
 static void ui_flip_screen (int flags, bool correct_mouse, bool save_only);
 static void ui_inhibit_screensaver (bool inhibit);
 static void ui_room_drawing (bool draw);
+static void ui_telemetry_overlay (bool show);
 static void ui_screenshot (void);
 
 static void ui_flip_gamepad (bool v, bool h, bool save_only);
@@ -782,7 +783,7 @@ game_menu (intptr_t index)
 
   menu_sep (NULL);
 
-  menu_ditem ((cutscene || title_demo) && play_time < time_limit,
+  menu_ditem ((cutscene || title_demo) && engine->play_time < time_limit,
               START_GAME_MID, RESTART_GAME_MID, true,
               right_icon, reload_icon,
               "Sta&rt (Enter)", "&Restart (Ctrl+R)");
@@ -874,6 +875,10 @@ view_menu (intptr_t index)
               ! no_room_drawing, drawing_icon,
               "Room &drawing (Shift+B)");
 
+  menu_citem (TELEMETRY_OVERLAY_MID, ! cutscene && ! title_demo,
+              telemetry_overlay, clock_icon,
+              "&Telemetry overlay (Shift+F)");
+
   menu_citem (INHIBIT_SCREENSAVER_MID, true,
               inhibit_screensaver, screensaver_icon,
               "&Inhibit screensaver");
@@ -967,7 +972,7 @@ navigation_menu (intptr_t index)
 
   menu_sub (NAV_PAGE_MID, true, nav_page_icon, nav_page_menu, 0, "Scroll &page");
 
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
   menu_sitem (NAV_HOME_MID, k && k->f.c.room != mr.room,
               nav_home_icon, "&Home (Home)");
 
@@ -983,19 +988,19 @@ void
 nav_select_menu (intptr_t index)
 {
   menu_sitem (NAV_SELECT_LEFT_MID,
-              roomd (&global_level, mr.room, LEFT),
+              roomd (&engine->level, mr.room, LEFT),
               nav_left_icon, "&Left (H)");
 
   menu_sitem (NAV_SELECT_ABOVE_MID,
-              roomd (&global_level, mr.room, ABOVE),
+              roomd (&engine->level, mr.room, ABOVE),
               nav_above_icon, "&Above (U)");
 
   menu_sitem (NAV_SELECT_RIGHT_MID,
-              roomd (&global_level, mr.room, RIGHT),
+              roomd (&engine->level, mr.room, RIGHT),
               nav_right_icon, "&Right (J)");
 
   menu_sitem (NAV_SELECT_BELOW_MID,
-              roomd (&global_level, mr.room, BELOW),
+              roomd (&engine->level, mr.room, BELOW),
               nav_below_icon, "&Below (N)");
 }
 
@@ -1348,7 +1353,7 @@ editor_menu (intptr_t index)
 void
 cheat_menu (intptr_t index)
 {
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
 
   menu_sitem (KILL_ENEMY_MID, k && k->enemy_id > 0,
               death_icon, "&Kill enemy (K)");
@@ -1389,14 +1394,14 @@ time_change_menu (intptr_t index)
 {
   menu_sitem (TIME_ADD_MID, true, time_add_icon, "&Increase (=)");
 
-  menu_sitem (TIME_SUB_MID, time_limit - play_time > 60 * DEFAULT_HZ,
+  menu_sitem (TIME_SUB_MID, time_limit - engine->play_time > 60 * DEFAULT_HZ,
               time_sub_icon, "&Decrease (-)");
 }
 
 void
 kca_change_menu (intptr_t index)
 {
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
 
   menu_sitem (KCA_ADD_MID, k && k->skill.counter_attack_prob < 99,
               counter_attack_add_icon, "&Increase (Ctrl+=)");
@@ -1408,7 +1413,7 @@ kca_change_menu (intptr_t index)
 void
 kcd_change_menu (intptr_t index)
 {
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
 
   menu_sitem (KCD_ADD_MID, k && k->skill.counter_defense_prob < 99,
               counter_defense_add_icon, "&Increase (Alt+=)");
@@ -1434,8 +1439,8 @@ skip_level_widget (void)
                    JUMP_TO_LEVEL_1_MID, JUMP_TO_LEVEL_MID_NMEMB,
                    replay_mode == PLAY_REPLAY ? replay_chain_nmemb : 14,
                    replay_mode == PLAY_REPLAY
-                   ? replay_index : global_level.n - 1,
-                   "LEVEL %i", global_level.n);
+                   ? replay_index : engine->level.n - 1,
+                   "LEVEL %i", engine->level.n);
 
   menu_sitem (RESTART_LEVEL_MID, replay_mode == PLAY_REPLAY && ! title_demo
               ? true
@@ -1445,13 +1450,13 @@ skip_level_widget (void)
   menu_sitem
     (NEXT_LEVEL_MID, replay_mode == PLAY_REPLAY && ! title_demo
      ? replay_index + 1 < replay_chain_nmemb
-     : ! cutscene && ! title_demo && global_level.n < 14,
+     : ! cutscene && ! title_demo && engine->level.n < 14,
      next_icon, "&Next (Shift+L)");
 
   menu_sitem
     (PREVIOUS_LEVEL_MID, replay_mode == PLAY_REPLAY && ! title_demo
      ? replay_index > 0
-     : ! cutscene && ! title_demo && global_level.n > 1,
+     : ! cutscene && ! title_demo && engine->level.n > 1,
      previous_icon, "Pre&vious (Shift+M)");
 }
 
@@ -1462,7 +1467,7 @@ jump_to_level_menu (uint16_t id, int index, int lower)
   if (replay_mode == PLAY_REPLAY)
     menu_citem (id, true, replay_index == index,
                 NULL, "%i", replay_chain[index].start_level);
-  else menu_citem (id, true, global_level.n == index + 1,
+  else menu_citem (id, true, engine->level.n == index + 1,
                    NULL, "%i", index + 1);
 }
 
@@ -1484,7 +1489,7 @@ void
 pause_menu_widget (void)
 {
   if (is_game_paused ())
-    menu_hitem (CYCLE_HEADER_MID, false, "CYCLE: %ju", anim_cycle);
+    menu_hitem (CYCLE_HEADER_MID, false, "CYCLE: %ju", engine->anim_cycle);
   else menu_sep (NULL);
 
   menu_sitem
@@ -1649,7 +1654,7 @@ menu_mid (ALLEGRO_EVENT *event)
     mr_view_page_trans (BELOW);
     break;
   case NAV_HOME_MID:
-    mr_focus_room (get_anim_by_id (current_kid_id)->f.c.room);
+    mr_focus_room (get_anim_by_id (engine->current_kid_id)->f.c.room);
     break;
   case NAV_CENTER_MID:
     mr_center_room (mr.room);
@@ -1729,6 +1734,9 @@ menu_mid (ALLEGRO_EVENT *event)
   case ROOM_DRAWING_MID:
     ui_room_drawing (no_room_drawing);
     break;
+  case TELEMETRY_OVERLAY_MID:
+    ui_telemetry_overlay (! telemetry_overlay);
+    break;
   case SCREENSHOT_MID:
     ui_screenshot ();
     break;
@@ -2216,7 +2224,7 @@ level_key_bindings (void)
 
   /* HOME: focus multi-room view on kid */
   else if (was_key_pressed (0, ALLEGRO_KEY_HOME)) {
-    struct anim *k = get_anim_by_id (current_kid_id);
+    struct anim *k = get_anim_by_id (engine->current_kid_id);
     mr_focus_room (k->f.c.room);
   }
 
@@ -2237,6 +2245,10 @@ level_key_bindings (void)
   else if (was_key_pressed (ALLEGRO_KEYMOD_SHIFT, ALLEGRO_KEY_B))
     ui_room_drawing (no_room_drawing);
 
+  /* SHIFT+F: show/hide telemetry overlay */
+  else if (was_key_pressed (ALLEGRO_KEYMOD_SHIFT, ALLEGRO_KEY_F))
+    ui_telemetry_overlay (! telemetry_overlay);
+
   /* K: kill enemy */
   else if (! active_menu
            && was_key_pressed (0, ALLEGRO_KEY_K))
@@ -2511,10 +2523,10 @@ void
 ui_show_coordinates (void)
 {
   int s = mr.room;
-  int l = roomd (&global_level, s, LEFT);
-  int r = roomd (&global_level, s, RIGHT);
-  int a = roomd (&global_level, s, ABOVE);
-  int b = roomd (&global_level, s, BELOW);
+  int l = roomd (&engine->level, s, LEFT);
+  int r = roomd (&engine->level, s, RIGHT);
+  int a = roomd (&engine->level, s, ABOVE);
+  int b = roomd (&engine->level, s, BELOW);
 
   mr.select_cycles = SELECT_CYCLES;
 
@@ -2524,17 +2536,17 @@ ui_show_coordinates (void)
 void
 ui_show_indirect_coordinates (void)
 {
-  int a = roomd (&global_level, mr.room, ABOVE);
-  int b = roomd (&global_level, mr.room, BELOW);
-  int al = roomd (&global_level, a, LEFT);
-  int ar = roomd (&global_level, a, RIGHT);
-  int bl = roomd (&global_level, b, LEFT);
-  int br = roomd (&global_level, b, RIGHT);
+  int a = roomd (&engine->level, mr.room, ABOVE);
+  int b = roomd (&engine->level, mr.room, BELOW);
+  int al = roomd (&engine->level, a, LEFT);
+  int ar = roomd (&engine->level, a, RIGHT);
+  int bl = roomd (&engine->level, b, LEFT);
+  int br = roomd (&engine->level, b, RIGHT);
 
   mr.select_cycles = SELECT_CYCLES;
 
   ui_msg (0, "LV%i AL%i AR%i BL%i BR%i",
-          global_level.n, al, ar, bl, br);
+          engine->level.n, al, ar, bl, br);
 }
 
 void
@@ -2546,7 +2558,7 @@ ui_hue_mode (enum hue new_hue)
   switch (new_hue) {
   default: /* HUE_ORIGINAL */
     force_hue = false;
-    hue = global_level.hue;
+    hue = engine->level.hue;
     value = "ORIGINAL";
     break;
   case HUE_NONE:
@@ -2623,7 +2635,7 @@ ui_gm (enum gm new_gm)
 
   /* apply next guard mode */
   int i;
-  for (i = 0; i < anima_nmemb; i++) apply_guard_mode (&anima[i], gm);
+  for (i = 0; i < engine->anima_nmemb; i++) apply_guard_mode (&engine->anima[i], gm);
 
   ui_msg (0, "%s: %s", key, value);
 
@@ -2639,7 +2651,7 @@ ui_em (enum em new_em)
   switch (new_em) {
   default: /* ORIGINAL_EM */
     force_em = false;
-    em = global_level.em;
+    em = engine->level.em;
     value = "ORIGINAL";
     break;
   case DUNGEON:
@@ -2763,6 +2775,17 @@ ui_room_drawing (bool draw)
   ui_msg (0, "%s: %s", key, value);
 }
 
+void
+ui_telemetry_overlay (bool show)
+{
+  char *key = "TELEMETRY OVERLAY";
+  char *value = show ? "ON" : "OFF";
+
+  telemetry_overlay = show;
+
+  ui_msg (0, "%s: %s", key, value);
+}
+
 void
 ui_gamepad_mode (enum gpm new_gpm)
 {
@@ -2841,12 +2864,12 @@ ui_jump_to_level (int n)
 {
   switch (replay_mode) {
   case NO_REPLAY:
-    if (n == global_level.n) {
+    if (n == engine->level.n) {
       quit_anim = RESTART_LEVEL;
     } else {
       ignore_level_cutscene = true;
       next_level_number = n;
-      start_level_time = play_time;
+      start_level_time = engine->play_time;
       quit_anim = NEXT_LEVEL;
     }
     break;
@@ -2867,7 +2890,7 @@ void
 ui_jump_to_level_rel (int d)
 {
   ui_jump_to_level
-    (replay_mode == PLAY_REPLAY ? replay_index + d : global_level.n + d);
+    (replay_mode == PLAY_REPLAY ? replay_index + d : engine->level.n + d);
 }
 
 void
@@ -2879,7 +2902,7 @@ ui_jump_to_level_menu (int i)
   switch (replay_mode) {
   case NO_REPLAY: no_replay:
     n = i + 1 + jump_to_level_menu_lower;
-    if (n == global_level.n) return;
+    if (n == engine->level.n) return;
     break;
   case PLAY_REPLAY:
     n = i + jump_to_level_menu_lower;
@@ -2899,7 +2922,7 @@ ui_time (void)
 void
 ui_skills (void)
 {
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
   display_skill (k);
 }
 
@@ -3004,7 +3027,7 @@ void
 ui_resurrect (void)
 {
   if (replay_mode == NO_REPLAY) {
-    struct anim *k = get_anim_by_id (current_kid_id);
+    struct anim *k = get_anim_by_id (engine->current_kid_id);
     kid_resurrect (k);
   } else print_replay_mode (0);
 }
@@ -3013,7 +3036,7 @@ void
 ui_kill_enemy (void)
 {
   if (replay_mode == NO_REPLAY) {
-    struct anim *k = get_anim_by_id (current_kid_id);
+    struct anim *k = get_anim_by_id (engine->current_kid_id);
     struct anim *ke = get_anim_by_id (k->enemy_id);
     if (ke) {
       survey (_m, pos, &ke->f, NULL, &ke->p, NULL);
@@ -3027,7 +3050,7 @@ void
 ui_float (void)
 {
   if (replay_mode == NO_REPLAY) {
-    struct anim *k = get_anim_by_id (current_kid_id);
+    struct anim *k = get_anim_by_id (engine->current_kid_id);
     float_kid (k);
   } else print_replay_mode (0);
 }
@@ -3038,7 +3061,7 @@ ui_immortal (bool immortal)
   if (replay_mode == NO_REPLAY) {
     char *key = "IMMORTAL MODE";
     char *value = immortal ? "ON" : "OFF";
-    struct anim *k = get_anim_by_id (current_kid_id);
+    struct anim *k = get_anim_by_id (engine->current_kid_id);
     if (k->current_lives <= 0 && immortal) kid_resurrect (k);
     immortal_mode = immortal;
     k->immortal = immortal;
@@ -3051,7 +3074,7 @@ void
 ui_fill_life (void)
 {
   if (replay_mode == NO_REPLAY) {
-    struct anim *k = get_anim_by_id (current_kid_id);
+    struct anim *k = get_anim_by_id (engine->current_kid_id);
     increase_kid_current_lives (k);
   } else print_replay_mode (0);
 }
@@ -3060,7 +3083,7 @@ void
 ui_add_life (void)
 {
   if (replay_mode == NO_REPLAY) {
-    struct anim *k = get_anim_by_id (current_kid_id);
+    struct anim *k = get_anim_by_id (engine->current_kid_id);
     increase_kid_total_lives (k);
     total_lives = k->total_lives;
   } else print_replay_mode (0);
@@ -3073,20 +3096,20 @@ ui_change_time (int m)
     static int last_r_min = -1;
 
     if (last_r_min < 0)
-      last_r_min = precise_unit (time_limit - play_time, 60 * DEFAULT_HZ);
+      last_r_min = precise_unit (time_limit - engine->play_time, 60 * DEFAULT_HZ);
 
-    int64_t r = time_limit - play_time;
+    int64_t r = time_limit - engine->play_time;
     if (m < 0 && r <= 60 * DEFAULT_HZ) return;
     else if (m > 0 && r <= 60 * DEFAULT_HZ)
-      time_limit = play_time + max_int (2, m) * 60 * DEFAULT_HZ;
+      time_limit = engine->play_time + max_int (2, m) * 60 * DEFAULT_HZ;
     else if (m < 0 && r <= -m * 60 * DEFAULT_HZ)
-      time_limit = play_time + 60 * DEFAULT_HZ;
-    else time_limit = play_time + next_multiple (r, m * 60 * DEFAULT_HZ);
+      time_limit = engine->play_time + 60 * DEFAULT_HZ;
+    else time_limit = engine->play_time + next_multiple (r, m * 60 * DEFAULT_HZ);
 
-    int r_min = precise_unit (time_limit - play_time, 60 * DEFAULT_HZ);
+    int r_min = precise_unit (time_limit - engine->play_time, 60 * DEFAULT_HZ);
     if (r_min == last_r_min) {
       time_limit += m * 60 * DEFAULT_HZ;
-      last_r_min = precise_unit (time_limit - play_time, 60 * DEFAULT_HZ);
+      last_r_min = precise_unit (time_limit - engine->play_time, 60 * DEFAULT_HZ);
     } else last_r_min = r_min;
 
     display_remaining_time (0);
@@ -3097,7 +3120,7 @@ void
 ui_change_prob_skill (int *holder, int new)
 {
   if (replay_mode == NO_REPLAY) {
-    struct anim *k = get_anim_by_id (current_kid_id);
+    struct anim *k = get_anim_by_id (engine->current_kid_id);
     new = new > -1 ? new : -1;
     new = new < 99 ? new : 99;
     *holder = new;
@@ -3109,7 +3132,7 @@ ui_change_prob_skill (int *holder, int new)
 void
 ui_change_kca (int d)
 {
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
   ui_change_prob_skill
     (&k->skill.counter_attack_prob,
      next_multiple (k->skill.counter_attack_prob + 1, d) - 1);
@@ -3118,7 +3141,7 @@ ui_change_kca (int d)
 void
 ui_change_kcd (int d)
 {
-  struct anim *k = get_anim_by_id (current_kid_id);
+  struct anim *k = get_anim_by_id (engine->current_kid_id);
   ui_change_prob_skill
     (&k->skill.counter_defense_prob,
      next_multiple (k->skill.counter_defense_prob + 1, d) - 1);
@@ -3253,7 +3276,7 @@ ui_add_replay_favorite (void)
   assert (replay_mode == PLAY_REPLAY);
   size_t i = 0;
   for (i = 0; i < replay_favorite_nmemb; i++)
-    if (replay_favorite[i].cycle == anim_cycle
+    if (replay_favorite[i].cycle == engine->anim_cycle
         && ! strcmp (replay_favorite[i].filename,
                      replay_chain[replay_index].filename)) {
       ui_msg (0, "DUPLICATE REPLAY FAVORITE");
@@ -3269,6 +3292,13 @@ ui_add_replay_favorite (void)
 void
 ui_go_to_replay_favorite (int i)
 {
+  /* seek within the replay being played, if possible */
+  if (replay_mode == PLAY_REPLAY
+      && ! strcmp (replay_chain[replay_index].filename,
+                   replay_favorite[i].filename)
+      && seek_replay (replay_favorite[i].cycle))
+    return;
+
   if (replay_mode != NO_REPLAY) stop_replaying (0);
   free_replay_chain ();
   add_replay_file_to_replay_chain (replay_favorite[i].filename);
@@ -3284,7 +3314,7 @@ ui_replace_replay_favorite (int i)
   al_free (replay_favorite[i].filename);
   replay_favorite[i].filename =
     xasprintf ("%s", replay_chain[replay_index].filename);
-  replay_favorite[i].cycle = anim_cycle;
+  replay_favorite[i].cycle = engine->anim_cycle;
   ui_save_replay_favorites ();
   ui_msg (0, "REPLAY FAVORITE REPLACED");
 }
@@ -3438,7 +3468,7 @@ ui_mirror_mode (bool mirror)
 bool
 display_remaining_time (int priority)
 {
-  int t = time_limit - play_time;
+  int t = time_limit - engine->play_time;
   if (t < 0) t = 0;
   int tm = t > (60 * DEFAULT_HZ)
     ? precise_unit (t, 60 * DEFAULT_HZ)
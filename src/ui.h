@@ -218,6 +218,7 @@ enum main_menu {
   FLIP_SCREEN_HORIZONTAL_MID,
   INHIBIT_SCREENSAVER_MID,
   ROOM_DRAWING_MID,
+  TELEMETRY_OVERLAY_MID,
   SCREENSHOT_MID,
 
   GAMEPAD_MID,
@@ -227,13 +227,13 @@ mirror_pos_undo (struct mirror_pos_undo *d, int dir)
 void
 register_level_undo (struct undo *u, struct level *l, char *desc)
 {
-  if (level_eq (&global_level, l)) return;
+  if (level_eq (&engine->level, l)) return;
 
   struct level_undo *d = xmalloc (sizeof (struct level_undo));
-  copy_level (&d->b, &global_level);
+  copy_level (&d->b, &engine->level);
   copy_level (&d->f, l);
-  d->f.n = global_level.n;
-  d->f.nominal_n = global_level.nominal_n;
+  d->f.n = engine->level.n;
+  d->f.nominal_n = engine->level.nominal_n;
   register_undo (u, d, (undo_f) level_undo, desc);
   level_undo (d, +1);
 }
@@ -251,7 +251,7 @@ level_undo (struct level_undo *d, int dir)
 void
 register_level_exchange_undo (struct undo *u, int n, char *desc)
 {
-  if (global_level.n == n) return;
+  if (engine->level.n == n) return;
 
   int *d = xmalloc (sizeof (* d));
   *d = n;
@@ -262,17 +262,17 @@ register_level_exchange_undo (struct undo *u, int n, char *desc)
 void
 level_exchange_undo (int *d, int dir)
 {
-  global_level.next_level (&vanilla_level, *d);
+  engine->level.next_level (&vanilla_level, *d);
 
   int n = vanilla_level.n;
   int nominal_n = vanilla_level.nominal_n;
 
-  vanilla_level.n = global_level.n;
-  vanilla_level.nominal_n = global_level.nominal_n;
-  global_level.n = n;
-  global_level.nominal_n = nominal_n;
+  vanilla_level.n = engine->level.n;
+  vanilla_level.nominal_n = engine->level.nominal_n;
+  engine->level.n = n;
+  engine->level.nominal_n = nominal_n;
 
-  save_level (&global_level);
+  save_level (&engine->level);
   save_level (&vanilla_level);
 
   replace_playing_level (&vanilla_level);
@@ -321,7 +321,7 @@ register_h_room_mirror_con_undo (struct undo *u, int _room, char *desc)
 void
 h_room_mirror_con_undo (int *room, int dir)
 {
-  mirror_room_h (&global_level, *room);
+  mirror_room_h (&engine->level, *room);
 }
 
 /*****************************/
@@ -341,7 +341,7 @@ void
 v_room_mirror_con_undo (int *room, int dir)
 {
   struct pos p0, p1;
-  new_pos (&p0, &global_level, *room, -1, -1);
+  new_pos (&p0, &engine->level, *room, -1, -1);
   for (p0.floor = 0; p0.floor < FLOORS / 2; p0.floor++)
     for (p0.place = 0; p0.place < PLACES; p0.place++) {
       reflect_pos_v (&p0, &p1);
@@ -366,7 +366,7 @@ register_random_room_mirror_con_undo (struct undo *u, int _room,
   struct pos p;
   for (p.floor = 0; p.floor < FLOORS; p.floor++)
     for (p.place = 0; p.place < PLACES; p.place++)
-      random_pos (&global_level, &d->p[p.floor][p.place]);
+      random_pos (&engine->level, &d->p[p.floor][p.place]);
 
   register_undo (u, d, (undo_f) random_room_mirror_con_undo, desc);
 
@@ -377,7 +377,7 @@ void
 random_room_mirror_con_undo (struct random_room_mirror_con_undo *d, int dir)
 {
   struct pos p0, p1;
-  new_pos (&p0, &global_level, d->room, -1, -1);
+  new_pos (&p0, &engine->level, d->room, -1, -1);
 
   if (dir >= 0)
     for (p0.floor = 0; p0.floor < FLOORS; p0.floor++)
@@ -405,11 +405,11 @@ void
 register_link_undo (struct undo *u, struct room_linking l[ROOMS],
                     char *desc)
 {
-  if (! memcmp (l, &global_level.link, sizeof (global_level.link))) return;
+  if (! memcmp (l, &engine->level.link, sizeof (engine->level.link))) return;
 
   struct link_undo *d = xmalloc (sizeof (struct link_undo));
   memcpy (&d->b, l, sizeof (d->b));
-  memcpy (&d->f, &global_level.link, sizeof (d->f));
+  memcpy (&d->f, &engine->level.link, sizeof (d->f));
   register_undo (u, d, (undo_f) link_undo, desc);
   link_undo (d, +1);
 }
@@ -417,7 +417,7 @@ register_link_undo (struct undo *u, struct room_linking l[ROOMS],
 void
 link_undo (struct link_undo *d, int dir)
 {
-  memcpy (&global_level.link, (dir >= 0) ? &d->f : &d->b, sizeof (d->f));
+  memcpy (&engine->level.link, (dir >= 0) ? &d->f : &d->b, sizeof (d->f));
 }
 
 /******************/
@@ -457,7 +457,7 @@ register_toggle_start_dir_undo (struct undo *u, char *desc)
 void
 toggle_start_dir_undo (struct start_pos_undo *d, int dir)
 {
-  global_level.start_dir = (global_level.start_dir == LEFT) ? RIGHT : LEFT;
+  engine->level.start_dir = (engine->level.start_dir == LEFT) ? RIGHT : LEFT;
 }
 
 /********************/
@@ -474,7 +474,7 @@ register_toggle_has_sword_undo (struct undo *u, char *desc)
 void
 toggle_has_sword_undo (struct start_pos_undo *d, int dir)
 {
-  global_level.has_sword = ! global_level.has_sword;
+  engine->level.has_sword = ! engine->level.has_sword;
 }
 
 /************************/
@@ -518,8 +518,8 @@ register_toggle_guard_start_dir_undo (struct undo *u, int i, char *desc)
 void
 toggle_guard_start_dir_undo (int *d, int dir)
 {
-  guard (&global_level, *d)->dir =
-    (guard (&global_level, *d)->dir == LEFT) ? RIGHT : LEFT;
+  guard (&engine->level, *d)->dir =
+    (guard (&engine->level, *d)->dir == LEFT) ? RIGHT : LEFT;
 }
 
 /***************/
@@ -529,7 +529,7 @@ toggle_guard_start_dir_undo (int *d, int dir)
 void
 register_guard_skill_undo (struct undo *u, int i, struct skill *s, char *desc)
 {
-  struct guard *g = guard (&global_level, i);
+  struct guard *g = guard (&engine->level, i);
   if (! memcmp (s, &g->skill, sizeof (* s))) return;
 
   struct guard_skill_undo *d = xmalloc (sizeof (* d));
@@ -543,7 +543,7 @@ register_guard_skill_undo (struct undo *u, int i, struct skill *s, char *desc)
 void
 guard_skill_undo (struct guard_skill_undo *d, int dir)
 {
-  struct guard *g = guard (&global_level, d->i);
+  struct guard *g = guard (&engine->level, d->i);
   g->skill = (dir >= 0) ? d->f_skill : d->b_skill;
   struct anim *a = get_guard_anim_by_level_id (d->i);
   if (a) a->skill = g->skill;
@@ -556,7 +556,7 @@ guard_skill_undo (struct guard_skill_undo *d, int dir)
 void
 register_guard_lives_undo (struct undo *u, int i, int l, char *desc)
 {
-  struct guard *g = guard (&global_level, i);
+  struct guard *g = guard (&engine->level, i);
   if (g->total_lives == l) return;
 
   struct indexed_int_undo *d = xmalloc (sizeof (* d));
@@ -570,7 +570,7 @@ register_guard_lives_undo (struct undo *u, int i, int l, char *desc)
 void
 guard_lives_undo (struct indexed_int_undo *d, int dir)
 {
-  struct guard *g = guard (&global_level, d->i);
+  struct guard *g = guard (&engine->level, d->i);
   g->total_lives = (dir >= 0) ? d->f : d->b;
 }
 
@@ -581,7 +581,7 @@ guard_lives_undo (struct indexed_int_undo *d, int dir)
 void
 register_guard_type_undo (struct undo *u, int i, enum anim_type t, char *desc)
 {
-  struct guard *g = guard (&global_level, i);
+  struct guard *g = guard (&engine->level, i);
   if (g->type == t) return;
 
   struct indexed_int_undo *d = xmalloc (sizeof (* d));
@@ -595,7 +595,7 @@ register_guard_type_undo (struct undo *u, int i, enum anim_type t, char *desc)
 void
 guard_type_undo (struct indexed_int_undo *d, int dir)
 {
-  struct guard *g = guard (&global_level, d->i);
+  struct guard *g = guard (&engine->level, d->i);
   g->type = (dir >= 0) ? d->f : d->b;
 }
 
@@ -606,7 +606,7 @@ guard_type_undo (struct indexed_int_undo *d, int dir)
 void
 register_guard_style_undo (struct undo *u, int i, int s, char *desc)
 {
-  struct guard *g = guard (&global_level, i);
+  struct guard *g = guard (&engine->level, i);
   if (g->style == s) return;
 
   struct indexed_int_undo *d = xmalloc (sizeof (* d));
@@ -620,7 +620,7 @@ register_guard_style_undo (struct undo *u, int i, int s, char *desc)
 void
 guard_style_undo (struct indexed_int_undo *d, int dir)
 {
-  struct guard *g = guard (&global_level, d->i);
+  struct guard *g = guard (&engine->level, d->i);
   g->style = (dir >= 0) ? d->f : d->b;
 }
 
@@ -655,7 +655,7 @@ void
 level_environment_undo (struct int_undo *d, int dir)
 {
   int_undo (d, dir);
-  em = global_level.em;
+  em = engine->level.em;
 }
 
 /******************/
@@ -666,5 +666,5 @@ void
 level_hue_undo (struct int_undo *d, int dir)
 {
   int_undo (d, dir);
-  hue = global_level.hue;
+  hue = engine->level.hue;
 }
@@ -20,9 +20,19 @@
 
 #include "mininim.h"
 
+static struct wall_draw_table *wall_draw_table;
+static size_t wall_draw_table_nmemb;
+
+static uint32_t wall_random_seed;
+
+static bool draw_wall_part_native (ALLEGRO_BITMAP *bitmap, struct pos *p,
+                                   char *part, int width);
+
 void
 draw_wall_part (ALLEGRO_BITMAP *bitmap, struct pos *p, char *part)
 {
+  if (draw_wall_part_native (bitmap, p, part, -1)) return;
+
   lua_State *L = main_L;
   if (! L_push_video_routine (L)) return;
 
@@ -40,6 +50,8 @@ void
 draw_wall_part_width (ALLEGRO_BITMAP *bitmap, struct pos *p, char *part,
                       int width)
 {
+  if (draw_wall_part_native (bitmap, p, part, width)) return;
+
   lua_State *L = main_L;
   if (! L_push_video_routine (L)) return;
 
@@ -55,6 +67,406 @@ draw_wall_part_width (ALLEGRO_BITMAP *bitmap, struct pos *p, char *part,
   L_target_bitmap = NULL;
 }
 
+void
+register_wall_draw_table (struct wall_draw_table *t)
+{
+  size_t i;
+  for (i = 0; i < wall_draw_table_nmemb; i++)
+    if (! strcasecmp (wall_draw_table[i].video_mode, t->video_mode)) {
+      /* the old table's references are kept, as bitmaps it refers to
+         may still be in use */
+      al_free (wall_draw_table[i].video_mode);
+      wall_draw_table[i] = *t;
+      return;
+    }
+
+  wall_draw_table =
+    add_to_array (t, 1, wall_draw_table, &wall_draw_table_nmemb,
+                  wall_draw_table_nmemb, sizeof (*t));
+}
+
+static struct wall_draw_table *
+get_wall_draw_table (void)
+{
+  if (! video_mode) return NULL;
+  size_t i;
+  for (i = 0; i < wall_draw_table_nmemb; i++)
+    if (! strcasecmp (wall_draw_table[i].video_mode, video_mode))
+      return &wall_draw_table[i];
+  return NULL;
+}
+
+/* the generator walls have always been randomized with, which
+   differs from the engine's in how a null seed is handled */
+static int
+wall_prandom (int max)
+{
+  if (! wall_random_seed) wall_random_seed = time (NULL);
+  wall_random_seed = wall_random_seed * 214013 + 2531011;
+  if (! wall_random_seed) wall_random_seed = 1;
+  return (wall_random_seed >> 16) % (max + 1);
+}
+
+static void
+wall_seedp (struct pos *p)
+{
+  struct pos np; npos (p, &np);
+  wall_random_seed = np.room + np.floor * PLACES + np.place;
+  if (! wall_random_seed) wall_random_seed = 1;
+}
+
+static int
+wall_prandom_seq (uint32_t seed, int n, int p, int max)
+{
+  int i, r0 = -1, r1 = -1;
+  wall_random_seed = seed;
+  wall_prandom (1);
+  for (i = 0; i <= n; i++) {
+    if (i % p == 0) r0 = -1;
+    do r1 = wall_prandom (max);
+    while (r1 == r0);
+    r0 = r1;
+  }
+  return r1;
+}
+
+static ALLEGRO_BITMAP *
+wall_apply_palette (ALLEGRO_BITMAP *b, ALLEGRO_BITMAP *b0, int ref)
+{
+  if (ref == LUA_NOREF) return b;
+  lua_State *L = main_L;
+  L_get_registry_by_ref (L, ref);
+  ALLEGRO_BITMAP *r = apply_palette_k (b, L_palette, lua_topointer (L, -1));
+  lua_pop (L, 1);
+  /* without the palette cache, intermediate bitmaps belong to no one */
+  if (! palette_cache_size_limit && b != b0) destroy_bitmap (b);
+  return r;
+}
+
+static ALLEGRO_COLOR
+wall_apply_palette_to_color (ALLEGRO_COLOR c, int ref)
+{
+  if (ref == LUA_NOREF) return c;
+  lua_State *L = main_L;
+  L_get_registry_by_ref (L, ref);
+  c = apply_palette_to_color_k (c, L_palette, lua_topointer (L, -1));
+  lua_pop (L, 1);
+  return c;
+}
+
+static int
+wall_hue_ref (struct wall_draw_table *t)
+{
+  const char *hm = L_hue_mode ();
+  enum hue h;
+  for (h = HUE_GREEN; h <= HUE_BLUE; h++)
+    if (! strcasecmp (hm, hue_mode_string (h))) return t->hue_ref[h];
+  return LUA_NOREF;
+}
+
+static int
+wall_selection_ref (struct wall_draw_table *t, enum em e, struct pos *p)
+{
+  if (! peq (p, &mouse_pos)) return LUA_NOREF;
+  return t->selection_ref != LUA_NOREF
+    ? t->selection_ref : t->selection_em_ref[e];
+}
+
+static void
+wall_draw (struct wall_draw_table *t, enum em e, ALLEGRO_BITMAP *to,
+           ALLEGRO_BITMAP *b0, struct pos *p, int x, int y, int w)
+{
+  if (! b0) return;
+
+  ALLEGRO_BITMAP *b = b0;
+  b = wall_apply_palette (b, b0, t->palette_ref);
+  b = wall_apply_palette (b, b0, wall_hue_ref (t));
+  b = wall_apply_palette (b, b0, wall_selection_ref (t, e, p));
+
+  struct coord c; new_coord (&c, &engine->level, room_view, x, y);
+  draw_bitmap_regionc (b, to, 0, 0,
+                       w >= 0 ? w : al_get_bitmap_width (b),
+                       al_get_bitmap_height (b), &c, 0);
+
+  if (! palette_cache_size_limit && b != b0) destroy_bitmap (b);
+}
+
+struct wall_randomization {
+  int r0, r1, r2, r3;
+  ALLEGRO_BITMAP *divider_00, *divider_01;
+};
+
+static void
+wall_randomize (struct wall_draw_env *d, struct pos *p,
+                struct wall_randomization *r)
+{
+  wall_seedp (p);
+  wall_prandom (1);
+  r->r0 = wall_prandom (1);
+  r->r1 = wall_prandom (4);
+  r->r2 = wall_prandom (1);
+  r->r3 = wall_prandom (4);
+  r->divider_00 = r->r2 ? d->narrow_divider : d->wide_divider;
+  r->divider_01 = r->r0 ? d->narrow_divider : d->wide_divider;
+}
+
+static void
+wall_draw_divider_00 (struct wall_draw_table *t, enum em e,
+                      ALLEGRO_BITMAP *to, struct pos *p,
+                      struct wall_randomization *r)
+{
+  wall_draw (t, e, to, r->divider_00, p, PLACE_WIDTH * p->place + r->r3,
+             PLACE_HEIGHT * p->floor + 45, -1);
+}
+
+static void
+wall_draw_divider_01 (struct wall_draw_table *t, enum em e,
+                      ALLEGRO_BITMAP *to, struct pos *p,
+                      struct wall_randomization *r)
+{
+  wall_draw (t, e, to, r->divider_01, p,
+             PLACE_WIDTH * p->place + 8 + r->r1,
+             PLACE_HEIGHT * p->floor + 24, -1);
+}
+
+static void
+wall_draw_left_mark (struct wall_draw_table *t, enum em e,
+                     ALLEGRO_BITMAP *to, struct pos *p,
+                     struct wall_randomization *r, int i)
+{
+  struct wall_draw_env *d = &t->env[e];
+  int floor_offset[] = {58, 41, 37, 20, 16};
+  int place_offset = 0;
+  if (i > 3) place_offset = r->r3 - r->r2 + 6;
+  else if (i > 1) place_offset = r->r1 - r->r0 + 6;
+  wall_draw (t, e, to, i % 2 ? d->mark_bottom_left : d->mark_top_left, p,
+             PLACE_WIDTH * p->place + place_offset
+             + 8 * (i == 2 || i == 3),
+             PLACE_HEIGHT * p->floor + 61 - floor_offset[i], -1);
+}
+
+static void
+wall_draw_right_mark (struct wall_draw_table *t, enum em e,
+                      ALLEGRO_BITMAP *to, struct pos *p,
+                      struct wall_randomization *r, int i)
+{
+  struct wall_draw_env *d = &t->env[e];
+  int floor_offset[] = {52, 42, 31, 21};
+  wall_draw (t, e, to, i % 2 ? d->mark_bottom_right : d->mark_top_right, p,
+             PLACE_WIDTH * p->place + 8 * (i > 1)
+             + (i < 2 ? 24 : r->r1 - 3),
+             PLACE_HEIGHT * p->floor + 56 - floor_offset[i], -1);
+}
+
+static void
+wall_draw_base_randomization (struct wall_draw_table *t, enum em e,
+                              ALLEGRO_BITMAP *to, struct pos *p)
+{
+  struct wall_randomization r;
+  wall_randomize (&t->env[e], p, &r);
+  enum wall_correlation wc = wall_correlation (p);
+  if (wc == WWW || wc == WWS) wall_draw_divider_00 (t, e, to, p, &r);
+}
+
+static void
+wall_draw_left_randomization (struct wall_draw_table *t, enum em e,
+                              ALLEGRO_BITMAP *to, struct pos *p)
+{
+  struct wall_draw_env *d = &t->env[e];
+  struct wall_randomization r;
+  wall_randomize (d, p, &r);
+
+  bool mark = d->mark_top_left;
+
+  switch (wall_correlation (p)) {
+  case WWW:
+    if (wall_prandom (4) == 0)
+      wall_draw (t, e, to, d->random_block, p, PLACE_WIDTH * p->place,
+                 PLACE_HEIGHT * p->floor + 3, -1);
+    wall_draw_divider_01 (t, e, to, p, &r);
+    wall_draw_divider_00 (t, e, to, p, &r);
+    if (mark) {
+      if (wall_prandom (4) == 0)
+        wall_draw_right_mark (t, e, to, p, &r, wall_prandom (3));
+      if (wall_prandom (4) == 0)
+        wall_draw_left_mark (t, e, to, p, &r, wall_prandom (4));
+    }
+    break;
+  case SWS:
+    if (mark && wall_prandom (6) == 0)
+      wall_draw_left_mark (t, e, to, p, &r, wall_prandom (1));
+    break;
+  case SWW:
+    if (wall_prandom (4) == 0)
+      wall_draw (t, e, to, d->random_block, p, PLACE_WIDTH * p->place,
+                 PLACE_HEIGHT * p->floor + 3, -1);
+    wall_draw_divider_01 (t, e, to, p, &r);
+    if (mark) {
+      if (wall_prandom (4) == 0)
+        wall_draw_right_mark (t, e, to, p, &r, wall_prandom (3));
+      if (wall_prandom (4) == 0)
+        wall_draw_left_mark (t, e, to, p, &r, wall_prandom (3));
+    }
+    break;
+  case WWS:
+    wall_draw_divider_01 (t, e, to, p, &r);
+    wall_draw_divider_00 (t, e, to, p, &r);
+    if (mark) {
+      if (wall_prandom (4) == 0)
+        wall_draw_right_mark (t, e, to, p, &r, wall_prandom (1) + 2);
+      if (wall_prandom (4) == 0)
+        wall_draw_left_mark (t, e, to, p, &r, wall_prandom (4));
+    }
+    break;
+  }
+}
+
+/* brick color indexes by room, floor, row and column, generated once
+   per room */
+static int
+wall_brick_color_index (struct pos *p, int row, int col)
+{
+  static bool set[ROOMS];
+  static int8_t index[ROOMS][FLOORS][4][PLACES + 1];
+
+  struct pos np; npos (p, &np);
+
+  if (! set[np.room]) {
+    int floor, r, c, color, ocolor;
+    wall_random_seed = np.room;
+    wall_prandom (1);
+    for (floor = 0; floor < FLOORS; floor++)
+      for (r = 0; r < 4; r++)
+        for (c = 0, ocolor = -1; c <= PLACES; c++) {
+          do color = (r % 2 ? 0 : 4) + wall_prandom (3);
+          while (color == ocolor);
+          index[np.room][floor][r][c] = color;
+          ocolor = color;
+        }
+    set[np.room] = true;
+  }
+
+  return index[np.room][np.floor][row][np.place + col];
+}
+
+static void
+wall_draw_brick (struct wall_draw_table *t, enum em e, ALLEGRO_BITMAP *to,
+                 struct pos *p, int row, int col)
+{
+  struct wall_draw_env *d = &t->env[e];
+
+  ALLEGRO_COLOR c = d->brick_color[wall_brick_color_index (p, row, col)];
+  c = wall_apply_palette_to_color (c, t->palette_ref);
+  c = wall_apply_palette_to_color (c, wall_hue_ref (t));
+  c = wall_apply_palette_to_color (c, wall_selection_ref (t, e, p));
+
+  int x = PLACE_WIDTH * p->place;
+  int y = PLACE_HEIGHT * p->floor + 3;
+  int odd = col % 2;
+  struct rect r;
+  switch (row) {
+  case 0: new_rect (&r, room_view, x, y, PLACE_WIDTH, 20); break;
+  case 1: new_rect (&r, room_view, x + 16 * odd, y + 20, 16, 21); break;
+  case 2: new_rect (&r, room_view, x + 8 * odd, y + 41,
+                    odd ? 24 : 8, 19); break;
+  default: new_rect (&r, room_view, x, y + 60, PLACE_WIDTH, 3); break;
+  }
+  draw_filled_rect (to, &r, c);
+
+  /* the marks framing this row of bricks */
+  struct pos np; npos (p, &np);
+  int i;
+  for (i = row; i <= row + 1; i++) {
+    int m = wall_prandom_seq (np.room + np.floor * PLACES + np.place,
+                              i, 1, 2);
+    int mx = i ? PLACE_WIDTH * p->place
+      : PLACE_WIDTH * (p->place + 1) - 8;
+    int my[] = {3, 17, 38, 58, 63};
+    wall_draw (t, e, to, d->brick_mark[m + 3 * i], p, mx,
+               PLACE_HEIGHT * p->floor + my[i], -1);
+  }
+}
+
+/* Draw a wall part as the current video mode's draw table says,
+   without calling into Lua unless the part is overridden by a
+   function.  Return false if there is no usable table. */
+static bool
+draw_wall_part_native (ALLEGRO_BITMAP *bitmap, struct pos *p, char *part,
+                       int width)
+{
+  struct wall_draw_table *t = get_wall_draw_table ();
+  if (! t) return false;
+
+  enum em e;
+  const char *em_str = L_env_mode ();
+  if (! strcasecmp (em_str, "DUNGEON")) e = DUNGEON;
+  else if (! strcasecmp (em_str, "PALACE")) e = PALACE;
+  else return false;
+
+  struct wall_draw_env *d = &t->env[e];
+  if (! d->defined) return false;
+
+  enum wall_part wp;
+  if (! strcasecmp (part, "BASE")) wp = WALL_PART_BASE;
+  else if (! strcasecmp (part, "LEFT")) wp = WALL_PART_LEFT;
+  else if (! strcasecmp (part, "RIGHT")) wp = WALL_PART_RIGHT;
+  else if (! strcasecmp (part, "TOP")) wp = WALL_PART_TOP;
+  else return false;
+
+  if (d->part_ref[wp] != LUA_NOREF) {
+    lua_State *L = main_L;
+    L_get_registry_by_ref (L, d->part_ref[wp]);
+    L_pushposition (L, p);
+    if (width >= 0) lua_pushnumber (L, width);
+    else lua_pushnil (L);
+    L_target_bitmap = bitmap;
+    L_call (L, 2, 0);
+    L_target_bitmap = NULL;
+    return true;
+  }
+
+  enum wall_correlation wc = wall_correlation (p);
+  bool face = wc == SWS || wc == WWS;
+  bool randomization = d->narrow_divider && d->wide_divider;
+
+  switch (wp) {
+  case WALL_PART_BASE:
+    if (d->brick) wall_draw_brick (t, e, bitmap, p, 3, 0);
+    else {
+      wall_draw (t, e, bitmap, d->base[wc], p, PLACE_WIDTH * p->place,
+                 PLACE_HEIGHT * (p->floor + 1), -1);
+      if (randomization) wall_draw_base_randomization (t, e, bitmap, p);
+    }
+    break;
+  case WALL_PART_LEFT:
+    if (d->brick) {
+      wall_draw_brick (t, e, bitmap, p, 0, 0);
+      wall_draw_brick (t, e, bitmap, p, 1, 0);
+      wall_draw_brick (t, e, bitmap, p, 1, 1);
+      wall_draw_brick (t, e, bitmap, p, 2, 0);
+      wall_draw_brick (t, e, bitmap, p, 2, 1);
+    } else {
+      wall_draw (t, e, bitmap, d->left[wc], p, PLACE_WIDTH * p->place,
+                 PLACE_HEIGHT * p->floor + 3, -1);
+      if (randomization) wall_draw_left_randomization (t, e, bitmap, p);
+    }
+    break;
+  case WALL_PART_RIGHT:
+    if (face)
+      wall_draw (t, e, bitmap, d->right, p, PLACE_WIDTH * (p->place + 1),
+                 PLACE_HEIGHT * p->floor + 3, width);
+    break;
+  case WALL_PART_TOP:
+    if (face)
+      wall_draw (t, e, bitmap, d->top, p, PLACE_WIDTH * (p->place + 1),
+                 PLACE_HEIGHT * p->floor + d->top_offset, width);
+    break;
+  default: return false;
+  }
+
+  return true;
+}
+
 void
 draw_wall (ALLEGRO_BITMAP *bitmap, struct pos *p)
 {
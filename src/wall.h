@@ -25,6 +25,7 @@ void draw_wall_part (ALLEGRO_BITMAP *bitmap, struct pos *p, char *part);
 void draw_wall_part_width (ALLEGRO_BITMAP *bitmap, struct pos *p, char *part,
                            int width);
 void draw_wall (ALLEGRO_BITMAP *bitmap, struct pos *p);
+void register_wall_draw_table (struct wall_draw_table *t);
 
 enum should_draw should_draw_face (struct pos *p, struct frame *f);
 